@@ -0,0 +1,111 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include "calc_engine.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to append a random expression of the practical-10 grammar
+void appendExpression(string& out, mt19937& rng, int depth) {
+    int operands = 1 + rng() % 6;
+    for (int i = 0; i < operands; i++) {
+        if (i > 0) {
+            static const char ops[] = "+-*/+-*^";
+            out += ' ';
+            out += ops[rng() % 8];
+            out += ' ';
+        }
+        if (depth < 3 && rng() % 5 == 0) {
+            out += '(';
+            appendExpression(out, rng, depth + 1);
+            out += ')';
+        } else {
+            out += to_string(1 + rng() % 999);
+        }
+    }
+}
+
+// Function to compute a latency percentile from sorted samples
+double percentile(const vector<double>& sorted, double p) {
+    return sorted[min(sorted.size() - 1, (size_t)(p / 100.0 * sorted.size()))];
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 1000000;
+    mt19937 rng(2025);
+
+    vector<string> expressions(count);
+    size_t bytes = 0;
+    for (auto& expr : expressions) {
+        appendExpression(expr, rng, 0);
+        bytes += expr.size();
+    }
+    cout << "Expressions: " << count << ", average length " << fixed << setprecision(1)
+         << (double)bytes / count << " bytes" << endl;
+
+    // Sequential throughput with a single engine
+    CalcEngine engine;
+    vector<CalcResult> sequential(count);
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < count; i++) sequential[i] = engine.evaluate(expressions[i]);
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    cout << "Sequential:    " << setw(8) << setprecision(2) << count / seconds / 1e6 << " Mexpr/s, "
+         << setw(7) << bytes / seconds / 1e6 << " MB/s" << endl;
+
+    // Per-expression latency
+    vector<double> latencies(count);
+    for (size_t i = 0; i < count; i++) {
+        auto t0 = steady_clock::now();
+        CalcResult result = engine.evaluate(expressions[i]);
+        latencies[i] = duration<double, nano>(steady_clock::now() - t0).count();
+        if (result.ok != sequential[i].ok) return 1;
+    }
+    sort(latencies.begin(), latencies.end());
+    cout << "Latency (ns):  p50 " << setprecision(0) << percentile(latencies, 50)
+         << ", p90 " << percentile(latencies, 90) << ", p99 " << percentile(latencies, 99)
+         << ", p99.9 " << percentile(latencies, 99.9) << ", max " << latencies.back() << endl;
+
+    // Stream mode: newline-separated text in, "=value" lines out
+    string text;
+    text.reserve(bytes + count);
+    for (const auto& expr : expressions) {
+        text += expr;
+        text += '\n';
+    }
+    istringstream in(text);
+    ostringstream out;
+    start = steady_clock::now();
+    engine.evaluateStream(in, out);
+    seconds = duration<double>(steady_clock::now() - start).count();
+    cout << "Stream:        " << setw(8) << setprecision(2) << count / seconds / 1e6 << " Mexpr/s" << endl;
+
+    // Batch API over increasing thread counts
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+    vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    for (unsigned threads : threadCounts) {
+        start = steady_clock::now();
+        vector<CalcResult> results = evaluateBatch(expressions, threads);
+        seconds = duration<double>(steady_clock::now() - start).count();
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < count; i++) {
+            bool sameValue = results[i].value == sequential[i].value ||
+                             (isnan(results[i].value) && isnan(sequential[i].value));
+            if (results[i].ok != sequential[i].ok || (results[i].ok && !sameValue)) {
+                mismatches++;
+            }
+        }
+        cout << "Batch x" << setw(2) << threads << ":     " << setw(8) << count / seconds / 1e6 << " Mexpr/s"
+             << (mismatches ? ", " + to_string(mismatches) + " mismatches" : string()) << endl;
+    }
+
+    return 0;
+}
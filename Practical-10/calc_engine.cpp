@@ -0,0 +1,25 @@
+#include <iostream>
+#include <fstream>
+#include "calc_engine.h"
+
+using namespace std;
+
+// Evaluates one expression per line, from a file or stdin, until end of input
+int main(int argc, char** argv) {
+    CalcEngine engine;
+    size_t errors;
+
+    if (argc > 1) {
+        ifstream in(argv[1]);
+        if (!in) {
+            cerr << "Error opening file: " << argv[1] << endl;
+            return 1;
+        }
+        errors = engine.evaluateStream(in, cout);
+    } else {
+        cout << "Enter arithmetic expressions, one per line (Ctrl-D to finish):" << endl;
+        errors = engine.evaluateStream(cin, cout);
+    }
+
+    return errors == 0 ? 0 : 2;
+}
@@ -0,0 +1,148 @@
+#ifndef CALC_ENGINE_H
+#define CALC_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cmath>
+#include <cstdio>
+#include "../Practical-11/descent.h"
+
+using namespace std;
+
+// Re-entrant evaluator for the practical-10 calculator grammar:
+//   E : E '+' T | E '-' T | T
+//   T : T '*' F | T '/' F | F
+//   F : G '^' F | G           (right associative)
+//   G : '(' E ')' | NUMBER
+// All parser state lives in the engine object, so one engine per thread can
+// evaluate any number of expressions.
+
+// Structure to hold the outcome of one evaluation
+struct CalcResult {
+    bool ok;
+    double value;
+    const char* error;   // Static message, nullptr when ok
+    size_t position;     // Offset of the error in the expression
+};
+
+class CalcEngine : ExpressionScanner {
+public:
+    // Evaluate one expression; trailing whitespace and a newline are allowed
+    CalcResult evaluate(const char* text, size_t length) {
+        start(text, length);
+        double value = parseExpression();
+        finish();
+
+        if (error) return {false, 0.0, error, errorPosition()};
+        return {true, value, nullptr, 0};
+    }
+
+    CalcResult evaluate(const string& expr) {
+        return evaluate(expr.data(), expr.size());
+    }
+
+    // Evaluate newline-separated expressions until the stream ends, printing
+    // "=value" or the error for each non-empty line. Returns the number of errors.
+    size_t evaluateStream(istream& in, ostream& out) {
+        string line;
+        size_t errors = 0;
+        char buffer[64];
+
+        while (getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == string::npos) continue;
+
+            CalcResult result = evaluate(line);
+            if (result.ok) {
+                snprintf(buffer, sizeof(buffer), "=%.15g", result.value);
+                out << buffer << '\n';
+            } else {
+                out << "Error: " << result.error << " at column " << result.position + 1 << '\n';
+                errors++;
+            }
+        }
+        return errors;
+    }
+
+private:
+    double parseExpression() {
+        double result = parseTerm();
+        while (!error) {
+            char op = peek();
+            if (op != '+' && op != '-') break;
+            cur++;
+            double operand = parseTerm();
+            result = (op == '+') ? result + operand : result - operand;
+        }
+        return result;
+    }
+
+    double parseTerm() {
+        double result = parseFactor();
+        while (!error) {
+            char op = peek();
+            if (op != '*' && op != '/') break;
+            cur++;
+            const char* operandAt = cur;
+            double operand = parseFactor();
+            if (op == '/' && operand == 0 && !error) {
+                cur = operandAt;
+                fail("Division by zero");
+                return 0;
+            }
+            result = (op == '*') ? result * operand : result / operand;
+        }
+        return result;
+    }
+
+    // F : G '^' F | G, so the exponent recursion makes '^' right associative
+    double parseFactor() {
+        double base = parsePrimary();
+        if (error || peek() != '^') return base;
+        cur++;
+        if (!enterNesting()) return 0;
+        double exponent = parseFactor();
+        leaveNesting();
+        return pow(base, exponent);
+    }
+
+    double parsePrimary() {
+        char c = peek();
+        if (c == '(') {
+            if (!enterNesting()) return 0;
+            cur++;
+            double result = parseExpression();
+            if (error) return 0;
+            if (peek() != ')') {
+                fail("Expected closing parenthesis");
+                return 0;
+            }
+            cur++;
+            leaveNesting();
+            return result;
+        }
+        if (c >= '0' && c <= '9') {
+            double value = 0;
+            while (cur < end && *cur >= '0' && *cur <= '9') {
+                value = value * 10 + (*cur++ - '0');
+            }
+            return value;
+        }
+        fail(c == '\0' ? "Unexpected end of expression" : "Invalid character");
+        return 0;
+    }
+};
+
+// Function to evaluate a batch of expressions on several threads, one
+// engine per worker
+inline vector<CalcResult> evaluateBatch(const vector<string>& expressions, unsigned threads = 0) {
+    vector<CalcResult> results(expressions.size());
+    runBatch<CalcEngine>(expressions.size(), 1024, threads, [&](CalcEngine& engine, size_t i) {
+        results[i] = engine.evaluate(expressions[i]);
+    });
+    return results;
+}
+
+#endif
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include "bytecode.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to evaluate the quadruple table directly. variables is indexed like
+// the program's variableTable and temps must have room for every temporary.
+double interpretQuadruples(const QuadrupleProgram& program, const vector<double>& variables, vector<double>& temps) {
+    auto valueOf = [&](Operand operand) {
+        switch (operand.kind()) {
+            case OPERAND_CONSTANT: return program.constantValues[operand.index()];
+            case OPERAND_VARIABLE: return variables[operand.index()];
+            case OPERAND_TEMP: return temps[operand.index()];
+            default: return 0.0;
+        }
+    };
+    for (const auto& quad : program.code) {
+        double a = valueOf(quad.arg1), b = valueOf(quad.arg2);
+        switch (quad.op) {
+            case QuadOp::Add: temps[quad.result.index()] = a + b; break;
+            case QuadOp::Sub: temps[quad.result.index()] = a - b; break;
+            case QuadOp::Mul: temps[quad.result.index()] = a * b; break;
+            default: temps[quad.result.index()] = a / b; break;
+        }
+    }
+    return valueOf(program.result);
+}
+
+// Print the compiled register program
+void printBytecode(const Bytecode& bytecode) {
+    const char* names[] = {"ADD", "SUB", "MUL", "DIV", "HALT"};
+    auto registerName = [&](int r) {
+        int firstConstant = (int)bytecode.variables.size();
+        int firstTemp = firstConstant + (int)bytecode.constants.size();
+        if (r < firstConstant) return bytecode.variables[r];
+        if (r < firstTemp) {
+            ostringstream out;
+            out << bytecode.constants[r - firstConstant];
+            return out.str();
+        }
+        return "r" + to_string(r);
+    };
+
+    for (const auto& instruction : bytecode.code) {
+        if (instruction.op == OP_HALT) {
+            cout << "HALT\t" << registerName(bytecode.resultRegister) << endl;
+            break;
+        }
+        cout << names[instruction.op] << "\t" << registerName(instruction.dst) << "\t"
+             << registerName(instruction.a) << "\t" << registerName(instruction.b) << endl;
+    }
+}
+
+// Demo on the practical's test cases plus expressions with variables, then a
+// benchmark of re-parsing against the compiled forms. Usage: bytecode [rows]
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? stoul(argv[1]) : 1u << 20;
+
+    vector<string> testCases = {
+        "9 + 42 * 8",
+        "(3 + 5 * 2 - 8) / 4 - 2 + 6",
+        "price * qty * (1 + rate) - discount / 2",
+        "x",
+    };
+
+    QuadrupleGenerator generator;
+    for (const auto& expr : testCases) {
+        cout << "Compiling expression: " << expr << endl;
+        GenerateResult status = generator.generate(expr);
+        Bytecode bytecode;
+        if (!status.ok || !compileQuadruples(generator.program(), bytecode)) {
+            cout << "Error: could not compile" << endl;
+            continue;
+        }
+        printBytecode(bytecode);
+
+        vector<double> values(bytecode.variables.size());
+        for (size_t v = 0; v < values.size(); v++) values[v] = v + 2.0;
+        BytecodeEvaluator evaluator(bytecode);
+        cout << "Value";
+        for (size_t v = 0; v < values.size(); v++) cout << (v ? ", " : " with ") << bytecode.variables[v] << "=" << values[v];
+        cout << ": " << evaluator.run(values.data()) << endl;
+        cout << "---------------------------\n";
+    }
+
+    // Benchmark: the same formula over many rows of inputs
+    const string formula = "price * qty * (1 + rate) - discount / 2 + (price - cost) * qty * 0.25";
+    generator.generate(formula);
+    Bytecode bytecode;
+    compileQuadruples(generator.program(), bytecode);
+    size_t numVariables = bytecode.variables.size();
+
+    mt19937 rng(7);
+    uniform_real_distribution<double> dist(1.0, 100.0);
+    vector<vector<double>> columns(numVariables, vector<double>(rows));
+    for (auto& column : columns) {
+        for (double& value : column) value = dist(rng);
+    }
+
+    cout << "Formula: " << formula << endl;
+    cout << generator.program().code.size() << " quadruples, " << bytecode.numRegisters << " registers, "
+         << rows << " rows" << endl;
+
+    // Re-parse and interpret per row, as the practical would have to
+    size_t reparseRows = min(rows, (size_t)50000);
+    vector<double> expected(reparseRows), variables, temps;
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < reparseRows; i++) {
+        generator.generate(formula);
+        const QuadrupleProgram& program = generator.program();
+        variables.assign(program.variableTable.size(), 0.0);
+        for (size_t v = 0; v < numVariables; v++) {
+            variables[program.variableTable.find(bytecode.variables[v])] = columns[v][i];
+        }
+        temps.assign(program.code.size() + 1, 0.0);
+        expected[i] = interpretQuadruples(program, variables, temps);
+    }
+    double reparseNs = duration<double, nano>(steady_clock::now() - start).count() / reparseRows;
+
+    // Bytecode, one row at a time
+    vector<double> scalar(rows), row(numVariables);
+    BytecodeEvaluator evaluator(bytecode);
+    start = steady_clock::now();
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t v = 0; v < numVariables; v++) row[v] = columns[v][i];
+        scalar[i] = evaluator.run(row.data());
+    }
+    double scalarNs = duration<double, nano>(steady_clock::now() - start).count() / rows;
+
+    // Bytecode over columns
+    vector<const double*> columnPointers;
+    for (const auto& column : columns) columnPointers.push_back(column.data());
+    vector<double> batch(rows);
+    start = steady_clock::now();
+    runColumns(bytecode, columnPointers.data(), rows, batch.data());
+    double columnNs = duration<double, nano>(steady_clock::now() - start).count() / rows;
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < rows; i++) {
+        if (scalar[i] != batch[i] || (i < reparseRows && fabs(scalar[i] - expected[i]) > 1e-9 * fabs(expected[i]))) {
+            mismatches++;
+        }
+    }
+
+    cout << fixed << setprecision(1);
+    cout << "  re-parse + interpret quadruples: " << setw(8) << reparseNs << " ns/row" << endl;
+    cout << "  bytecode, one row at a time:     " << setw(8) << scalarNs << " ns/row ("
+         << reparseNs / scalarNs << "x)" << endl;
+    cout << "  bytecode over columns (SIMD):    " << setw(8) << columnNs << " ns/row ("
+         << reparseNs / columnNs << "x)" << endl;
+    cout << "  mismatches: " << mismatches << endl;
+
+    return 0;
+}
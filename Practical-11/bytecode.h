@@ -0,0 +1,216 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include "quadruple.h"
+#include "regalloc.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// Register bytecode compiled once from a quadruple list and evaluated many
+// times. Registers are laid out as [variables][constants][temporaries].
+
+// Arithmetic opcodes share their numbering with QuadOp
+enum Opcode : uint8_t { OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_HALT };
+
+// Structure to represent one instruction: r[dst] = r[a] op r[b]
+struct Instruction {
+    uint8_t op;
+    uint16_t dst;
+    uint16_t a;
+    uint16_t b;
+};
+
+// Structure to hold a compiled expression
+struct Bytecode {
+    vector<Instruction> code;       // Ends with OP_HALT
+    vector<string> variables;       // Register i holds variables[i]
+    vector<double> constants;       // Registers after the variables
+    int numRegisters = 0;
+    int resultRegister = 0;
+};
+
+// Function to compile a generated program into bytecode. Only the variables
+// and constants the quadruples use get registers. Without an allocation every
+// temporary gets its own register; with one, temporaries share the allocated
+// registers and spill slots.
+inline bool compileQuadruples(const QuadrupleProgram& program, Bytecode& bytecode,
+                              const TempAllocation* allocation = nullptr) {
+    const vector<Quadruple>& quads = program.code;
+    Operand result = program.result;
+    vector<int> variableRegister(program.variableTable.size(), -1);
+    vector<int> constantRegister(program.constantPool.size(), -1);
+    bytecode = Bytecode();
+
+    auto classify = [&](Operand operand) {
+        if (operand.kind() == OPERAND_VARIABLE && variableRegister[operand.index()] < 0) {
+            variableRegister[operand.index()] = (int)bytecode.variables.size();
+            bytecode.variables.push_back(string(program.variableTable.at(operand.index())));
+        } else if (operand.kind() == OPERAND_CONSTANT && constantRegister[operand.index()] < 0) {
+            constantRegister[operand.index()] = (int)bytecode.constants.size();
+            bytecode.constants.push_back(program.constantValues[operand.index()]);
+        }
+    };
+
+    // First pass: find every variable and constant so temporaries can follow them
+    uint32_t firstTempNumber = quads.empty() ? 0 : quads[0].result.index();
+    for (const auto& quad : quads) {
+        classify(quad.arg1);
+        classify(quad.arg2);
+    }
+    classify(result);
+
+    int firstConstant = (int)bytecode.variables.size();
+    int firstTemp = firstConstant + (int)bytecode.constants.size();
+    int numTempRegisters = allocation ? allocation->numRegisters + allocation->numSpillSlots : (int)quads.size();
+    bytecode.numRegisters = firstTemp + numTempRegisters;
+    if (bytecode.numRegisters > UINT16_MAX) return false;
+
+    // Temporaries are numbered consecutively, one per quadruple
+    auto registerOf = [&](Operand operand) {
+        switch (operand.kind()) {
+            case OPERAND_VARIABLE: return variableRegister[operand.index()];
+            case OPERAND_CONSTANT: return firstConstant + constantRegister[operand.index()];
+            case OPERAND_TEMP: {
+                uint32_t t = operand.index() - firstTempNumber;
+                if (t >= quads.size()) return -1;
+                return firstTemp + (allocation ? allocation->slotOf(operand) : (int)t);
+            }
+            default: return -1;  // Missing operand from a malformed expression
+        }
+    };
+
+    for (const auto& quad : quads) {
+        int a = registerOf(quad.arg1), b = registerOf(quad.arg2);
+        if (a < 0 || b < 0) return false;
+        bytecode.code.push_back({(uint8_t)quad.op, (uint16_t)registerOf(quad.result), (uint16_t)a, (uint16_t)b});
+    }
+    bytecode.code.push_back({OP_HALT, 0, 0, 0});
+
+    bytecode.resultRegister = registerOf(result);
+    return bytecode.resultRegister >= 0;
+}
+
+// Structure to evaluate one compiled expression repeatedly; it owns the
+// register file, so use one evaluator per thread
+class BytecodeEvaluator {
+    const Bytecode& bytecode;
+    vector<double> registers;
+
+public:
+    explicit BytecodeEvaluator(const Bytecode& bc) : bytecode(bc), registers(bc.numRegisters) {
+        copy(bc.constants.begin(), bc.constants.end(), registers.begin() + bc.variables.size());
+    }
+
+    // Evaluate with values[i] bound to bytecode.variables[i]
+    double run(const double* values) {
+        double* r = registers.data();
+        copy(values, values + bytecode.variables.size(), r);
+        const Instruction* ip = bytecode.code.data();
+
+#if defined(__GNUC__)
+        // Threaded dispatch: every handler jumps straight to the next one
+        static void* const handlers[] = {&&add, &&sub, &&mul, &&div, &&halt};
+        goto *handlers[ip->op];
+    add:
+        r[ip->dst] = r[ip->a] + r[ip->b];
+        ++ip;
+        goto *handlers[ip->op];
+    sub:
+        r[ip->dst] = r[ip->a] - r[ip->b];
+        ++ip;
+        goto *handlers[ip->op];
+    mul:
+        r[ip->dst] = r[ip->a] * r[ip->b];
+        ++ip;
+        goto *handlers[ip->op];
+    div:
+        r[ip->dst] = r[ip->a] / r[ip->b];
+        ++ip;
+        goto *handlers[ip->op];
+    halt:
+        return r[bytecode.resultRegister];
+#else
+        for (;; ++ip) {
+            switch (ip->op) {
+                case OP_ADD: r[ip->dst] = r[ip->a] + r[ip->b]; break;
+                case OP_SUB: r[ip->dst] = r[ip->a] - r[ip->b]; break;
+                case OP_MUL: r[ip->dst] = r[ip->a] * r[ip->b]; break;
+                case OP_DIV: r[ip->dst] = r[ip->a] / r[ip->b]; break;
+                default: return r[bytecode.resultRegister];
+            }
+        }
+#endif
+    }
+};
+
+// Rows evaluated together by runColumns
+const size_t COLUMN_BLOCK = 128;
+
+// Function to apply one operation to a block of rows with SIMD
+inline void applyBlock(uint8_t op, double* dst, const double* a, const double* b, size_t n) {
+    size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i), y = _mm256_loadu_pd(b + i);
+        __m256d z = op == OP_ADD ? _mm256_add_pd(x, y) : op == OP_SUB ? _mm256_sub_pd(x, y)
+                  : op == OP_MUL ? _mm256_mul_pd(x, y) : _mm256_div_pd(x, y);
+        _mm256_storeu_pd(dst + i, z);
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(a + i), y = _mm_loadu_pd(b + i);
+        __m128d z = op == OP_ADD ? _mm_add_pd(x, y) : op == OP_SUB ? _mm_sub_pd(x, y)
+                  : op == OP_MUL ? _mm_mul_pd(x, y) : _mm_div_pd(x, y);
+        _mm_storeu_pd(dst + i, z);
+    }
+#endif
+    for (; i < n; i++) {
+        switch (op) {
+            case OP_ADD: dst[i] = a[i] + b[i]; break;
+            case OP_SUB: dst[i] = a[i] - b[i]; break;
+            case OP_MUL: dst[i] = a[i] * b[i]; break;
+            default: dst[i] = a[i] / b[i]; break;
+        }
+    }
+}
+
+// Function to evaluate one expression over columns of inputs: columns[v]
+// holds rows values of variable v, and out receives one result per row.
+// Instructions run a block of rows at a time so dispatch is paid per block.
+inline void runColumns(const Bytecode& bytecode, const double* const* columns, size_t rows, double* out) {
+    size_t numVariables = bytecode.variables.size();
+    size_t numConstants = bytecode.constants.size();
+    size_t numTemps = bytecode.numRegisters - numVariables - numConstants;
+
+    // Constants are broadcast once; temporaries get one block of scratch each
+    vector<double> constants(numConstants * COLUMN_BLOCK);
+    for (size_t c = 0; c < numConstants; c++) {
+        fill(constants.begin() + c * COLUMN_BLOCK, constants.begin() + (c + 1) * COLUMN_BLOCK, bytecode.constants[c]);
+    }
+    vector<double> temps(numTemps * COLUMN_BLOCK);
+    vector<const double*> registers(bytecode.numRegisters);
+    for (size_t c = 0; c < numConstants; c++) registers[numVariables + c] = &constants[c * COLUMN_BLOCK];
+    for (size_t t = 0; t < numTemps; t++) registers[numVariables + numConstants + t] = &temps[t * COLUMN_BLOCK];
+
+    for (size_t start = 0; start < rows; start += COLUMN_BLOCK) {
+        size_t n = min(COLUMN_BLOCK, rows - start);
+        for (size_t v = 0; v < numVariables; v++) registers[v] = columns[v] + start;
+
+        for (const Instruction* ip = bytecode.code.data(); ip->op != OP_HALT; ++ip) {
+            applyBlock(ip->op, const_cast<double*>(registers[ip->dst]), registers[ip->a], registers[ip->b], n);
+        }
+        memcpy(out + start, registers[bytecode.resultRegister], n * sizeof(double));
+    }
+}
+
+#endif
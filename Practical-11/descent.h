@@ -0,0 +1,112 @@
+#ifndef DESCENT_H
+#define DESCENT_H
+
+#include <cstddef>
+#include <cctype>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// Pieces shared by the recursive-descent front ends (Practical-10's
+// calculator engine, Practical-11's quadruple generator, Practical-12's
+// expression parser): the cursor over one expression with its first error,
+// a nesting guard, and a thread pool that runs one parser per worker over a
+// batch of expressions.
+
+// Cursor over the expression being parsed. A parser derives from it, calls
+// start() before parsing and finish() after, and keeps only its own state.
+class ExpressionScanner {
+protected:
+    const char* begin;
+    const char* cur;
+    const char* end;
+    const char* error;      // First error, nullptr while there is none
+    const char* errorAt;
+    int depth;
+    bool newlinesAreSpace;  // Otherwise only ' ' and '\t' separate tokens
+
+    static const int MAX_DEPTH = 1000;  // Nesting limit, keeps recursion off the end of the stack
+
+    explicit ExpressionScanner(bool newlines = false)
+        : begin(nullptr), cur(nullptr), end(nullptr), error(nullptr), errorAt(nullptr), depth(0),
+          newlinesAreSpace(newlines) {}
+
+    void start(const char* text, size_t length) {
+        begin = cur = text;
+        end = text + length;
+        error = nullptr;
+        depth = 0;
+    }
+
+    // Function to check that nothing but blanks and one newline follows
+    void finish() {
+        skipSpaces();
+        if (!error && cur < end && *cur == '\n') cur++;
+        if (!error && cur != end) fail(*cur == ')' ? "Unbalanced parenthesis" : "Unexpected character");
+    }
+
+    size_t errorPosition() const { return (size_t)(errorAt - begin); }
+
+    // Function to record an error at the cursor; only the first one is kept
+    void fail(const char* message) {
+        if (!error) {
+            error = message;
+            errorAt = cur;
+        }
+    }
+
+    void skipSpaces() {
+        if (newlinesAreSpace) {
+            while (cur < end && isspace((unsigned char)*cur)) cur++;
+        } else {
+            while (cur < end && (*cur == ' ' || *cur == '\t')) cur++;
+        }
+    }
+
+    // Peek at the next token character, or '\0' at the end of input
+    char peek() {
+        skipSpaces();
+        return cur < end ? *cur : '\0';
+    }
+
+    // Function to go one level deeper before recursing into a parenthesis or
+    // a right-recursive operator; false (with the error set) past MAX_DEPTH
+    bool enterNesting() {
+        if (++depth > MAX_DEPTH) {
+            fail("Expression nested too deeply");
+            return false;
+        }
+        return true;
+    }
+
+    void leaveNesting() { depth--; }
+};
+
+// Function to run work(parser, i) for every i below count on several
+// threads. Workers claim chunks of indices and each keeps its own Parser,
+// so the parser's buffers are reused across its chunk.
+template <typename Parser, typename Work>
+inline void runBatch(size_t count, size_t chunk, unsigned threads, Work work) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    atomic<size_t> next(0);
+
+    auto worker = [&]() {
+        Parser parser;
+        while (true) {
+            size_t start = next.fetch_add(chunk, memory_order_relaxed);
+            if (start >= count) break;
+            size_t stop = min(start + chunk, count);
+            for (size_t i = start; i < stop; i++) work(parser, i);
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+}
+
+#endif
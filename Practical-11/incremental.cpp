@@ -0,0 +1,158 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include "incremental.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to build a balanced formula with about `operators` operators, so
+// each input sits about log2(operators) levels below the result
+void appendBalanced(string& out, mt19937& rng, int operators, int variables) {
+    const char* ops = "+-*/";
+    if (operators == 0) {
+        if (rng() % 4 == 0) out += to_string(1 + rng() % 9);
+        else out += "v" + to_string(rng() % variables);
+        return;
+    }
+    int left = (operators - 1) / 2;
+    out += '(';
+    appendBalanced(out, rng, left, variables);
+    // Keep to + and - near the root so the value stays finite
+    out += operators > 64 ? ops[rng() % 2] : ops[rng() % 4];
+    appendBalanced(out, rng, operators - 1 - left, variables);
+    out += ')';
+}
+
+// Function to build a long left-to-right sum of products, where an early
+// input is read by a quadruple near the start of a chain that reaches the end
+string chainFormula(mt19937& rng, int operators, int variables) {
+    string out = "v0";
+    for (int i = 1; i < operators; i += 2) {
+        out += rng() % 2 ? "+" : "-";
+        out += "v" + to_string(rng() % variables) + "*" + to_string(1 + rng() % 9);
+    }
+    return out;
+}
+
+// Usage: incremental [updates]
+int main(int argc, char** argv) {
+    int updates = argc > 1 ? stoi(argv[1]) : 2000;
+
+    // Small example
+    QuadrupleGenerator generator;
+    generator.generate("(a + b) * c - (d - e) / f");
+    const QuadrupleProgram& example = generator.program();
+    printQuadruples(example);
+    IncrementalEvaluator small(example);
+    vector<double> initial = {1, 2, 3, 4, 5, 6};
+    cout << "With a..f = 1..6: " << small.setAll(initial.data()) << endl;
+    UpdateStats stats;
+    double value = small.update(example.variableTable.find("e"), 1, &stats);
+    cout << "After e = 1: " << value << " (" << stats.recomputed << " of " << small.size() << " recomputed)" << endl;
+    small.set("a", 0);
+    small.set("b", 0);
+    stats = small.commit();
+    cout << "After a = b = 0 in one batch: " << small.result() << " (" << stats.recomputed << " recomputed, "
+         << stats.unchanged << " unchanged)" << endl << endl;
+
+    mt19937 rng(39);
+    struct Case {
+        string name;
+        string formula;
+    };
+    vector<Case> cases;
+    {
+        string balanced;
+        appendBalanced(balanced, rng, 100000, 1000);
+        cases.push_back({"balanced, 1000 vars", balanced});
+        balanced.clear();
+        appendBalanced(balanced, rng, 100000, 20);
+        cases.push_back({"balanced, 20 vars", balanced});
+        cases.push_back({"chain, 1000 vars", chainFormula(rng, 100000, 1000)});
+    }
+
+    cout << updates << " single-variable updates, then batches of 16" << endl;
+    cout << left << setw(21) << "Formula" << right << setw(8) << "Quads" << setw(10) << "Full us"
+         << setw(10) << "Update us" << setw(10) << "Avg cone" << setw(10) << "Max cone" << setw(10) << "Speedup"
+         << setw(10) << "Batch us" << setw(11) << "Batch cone" << setw(7) << "Match" << endl;
+
+    for (const Case& c : cases) {
+        GenerateResult status = generator.generate(c.formula);
+        if (!status.ok) {
+            cout << c.name << ": " << status.error << " at " << status.position << endl;
+            continue;
+        }
+        QuadrupleProgram program = generator.program();
+        defaultPipeline().run(program);
+        size_t numVariables = program.variableTable.size();
+
+        uniform_real_distribution<double> dist(1.0, 2.0);
+        vector<double> inputs(numVariables);
+        for (double& input : inputs) input = dist(rng);
+        IncrementalEvaluator incremental(program);
+        incremental.setAll(inputs.data());
+
+        // A second evaluator recomputes everything after each change, as the
+        // service does today
+        IncrementalEvaluator full(program);
+        full.setAll(inputs.data());
+
+        vector<pair<uint32_t, double>> changes(updates);
+        for (auto& [variable, newValue] : changes) {
+            variable = rng() % numVariables;
+            newValue = dist(rng);
+        }
+
+        size_t maxCone = 0, totalCone = 0;
+        vector<double> incrementalOut(updates), fullOut(updates);
+        auto start = steady_clock::now();
+        for (int i = 0; i < updates; i++) {
+            incrementalOut[i] = incremental.update(changes[i].first, changes[i].second, &stats);
+            totalCone += stats.recomputed;
+            maxCone = max(maxCone, stats.recomputed);
+        }
+        double updateUs = duration<double, micro>(steady_clock::now() - start).count() / updates;
+
+        start = steady_clock::now();
+        for (int i = 0; i < updates; i++) {
+            inputs[changes[i].first] = changes[i].second;
+            fullOut[i] = full.setAll(inputs.data());
+        }
+        double fullUs = duration<double, micro>(steady_clock::now() - start).count() / updates;
+
+        bool match = true;
+        for (int i = 0; i < updates; i++) {
+            if (incrementalOut[i] != fullOut[i] && !(isnan(incrementalOut[i]) && isnan(fullOut[i]))) match = false;
+        }
+
+        // Batches of 16 changes committed together
+        int batches = max(1, updates / 16);
+        size_t batchCone = 0;
+        start = steady_clock::now();
+        for (int b = 0; b < batches; b++) {
+            for (int j = 0; j < 16; j++) {
+                uint32_t variable = rng() % numVariables;
+                double newValue = dist(rng);
+                incremental.set(variable, newValue);
+                inputs[variable] = newValue;
+            }
+            batchCone += incremental.commit().recomputed;
+        }
+        double batchUs = duration<double, micro>(steady_clock::now() - start).count() / batches;
+        double batched = incremental.result(), expected = full.setAll(inputs.data());
+        if (batched != expected && !(isnan(batched) && isnan(expected))) match = false;
+
+        cout << left << setw(21) << c.name << right << setw(8) << program.code.size() << fixed << setprecision(1)
+             << setw(10) << fullUs << setw(10) << updateUs << setw(10) << (double)totalCone / updates
+             << setw(10) << maxCone << setw(9) << fullUs / updateUs << "x" << setw(10) << batchUs
+             << setw(11) << (double)batchCone / batches << setw(7) << (match ? "yes" : "NO") << defaultfloat << endl;
+    }
+    cout << "Cone is the number of quadruples recomputed per commit" << endl;
+
+    return 0;
+}
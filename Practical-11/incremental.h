@@ -0,0 +1,192 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "quadruple.h"
+#include "optimizer.h"
+
+using namespace std;
+
+// Incremental evaluation of a quadruple program whose inputs change a few at a
+// time. Every quadruple keeps its last value; changing a variable marks the
+// quadruples that read it, and only that dirty cone is recomputed, in
+// instruction order (which is a topological order, since temporaries are
+// numbered t1, t2, ... as they are defined). A quadruple whose value comes out
+// bit-for-bit unchanged does not dirty its readers.
+
+// Structure to count the work done by one commit
+struct UpdateStats {
+    size_t variablesChanged = 0;
+    size_t recomputed = 0;  // Quadruples evaluated again
+    size_t unchanged = 0;   // Of those, how many kept their old value
+};
+
+class IncrementalEvaluator {
+    const QuadrupleProgram& program;
+    vector<double> variables;   // variables[i] is the value of variableTable entry i
+    vector<double> temps;       // temps[i] is the value of t(i + 1)
+    vector<uint32_t> variableReadersStart, variableReaders;  // Readers of each variable
+    vector<uint32_t> tempReadersStart, tempReaders;          // Readers of each temporary
+    vector<uint32_t> changedVariables;
+    vector<uint8_t> variableChanged;
+    vector<uint64_t> dirty;              // One bit per quadruple still to recompute
+    size_t dirtyLow = SIZE_MAX, dirtyHigh = 0;
+
+    double valueOf(Operand operand) const {
+        switch (operand.kind()) {
+            case OPERAND_CONSTANT: return program.constantValues[operand.index()];
+            case OPERAND_VARIABLE: return variables[operand.index()];
+            default: return temps[operand.index() - 1];
+        }
+    }
+
+    static int lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(word);
+#else
+        int bit = 0;
+        while (!(word & 1)) {
+            word >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    double compute(uint32_t quad) const {
+        const Quadruple& q = program.code[quad];
+        return applyOp(q.op, valueOf(q.arg1), valueOf(q.arg2));
+    }
+
+    // Function to group the readers of each operand in compressed rows
+    void buildReaders(OperandKind kind, size_t count, vector<uint32_t>& start, vector<uint32_t>& readers) {
+        start.assign(count + 1, 0);
+        auto each = [&](auto visit) {
+            for (uint32_t i = 0; i < program.code.size(); i++) {
+                const Quadruple& q = program.code[i];
+                if (q.arg1.kind() == kind) visit(q.arg1, i);
+                // x op x reads x once
+                if (q.arg2.kind() == kind && q.arg2.bits != q.arg1.bits) visit(q.arg2, i);
+            }
+        };
+        size_t base = kind == OPERAND_TEMP ? 1 : 0;
+        each([&](Operand operand, uint32_t) { start[operand.index() - base + 1]++; });
+        for (size_t i = 0; i < count; i++) start[i + 1] += start[i];
+        readers.resize(start[count]);
+        vector<uint32_t> next(start.begin(), start.end() - 1);
+        each([&](Operand operand, uint32_t quad) { readers[next[operand.index() - base]++] = quad; });
+    }
+
+    void markReaders(const vector<uint32_t>& start, const vector<uint32_t>& readers, size_t index) {
+        for (uint32_t i = start[index]; i < start[index + 1]; i++) {
+            uint32_t quad = readers[i];
+            dirty[quad / 64] |= 1ull << (quad % 64);
+            dirtyLow = min<size_t>(dirtyLow, quad);
+            dirtyHigh = max<size_t>(dirtyHigh, quad);
+        }
+    }
+
+public:
+    // Running totals over every commit
+    size_t commits = 0;
+    size_t totalRecomputed = 0;
+
+    explicit IncrementalEvaluator(const QuadrupleProgram& p)
+        : program(p),
+          variables(p.variableTable.size(), 0.0),
+          temps(p.code.size(), 0.0),
+          variableChanged(p.variableTable.size(), 0),
+          dirty((p.code.size() + 63) / 64, 0) {
+        buildReaders(OPERAND_VARIABLE, variables.size(), variableReadersStart, variableReaders);
+        buildReaders(OPERAND_TEMP, temps.size(), tempReadersStart, tempReaders);
+        evaluateAll();
+    }
+
+    // Function to recompute every quadruple from the current variables
+    double evaluateAll() {
+        for (uint32_t i = 0; i < temps.size(); i++) temps[i] = compute(i);
+        return result();
+    }
+
+    // Function to set every variable, in variableTable order, and recompute
+    double setAll(const double* values) {
+        copy(values, values + variables.size(), variables.begin());
+        changedVariables.clear();
+        fill(variableChanged.begin(), variableChanged.end(), 0);
+        return evaluateAll();
+    }
+
+    // Function to stage a new value; nothing is recomputed until commit()
+    void set(uint32_t variable, double value) {
+        if (memcmp(&variables[variable], &value, sizeof(value)) == 0) return;
+        variables[variable] = value;
+        if (!variableChanged[variable]) {
+            variableChanged[variable] = 1;
+            changedVariables.push_back(variable);
+        }
+    }
+
+    // Function to stage a new value by name; returns false for unknown names
+    bool set(string_view name, double value) {
+        uint32_t index = program.variableTable.find(name);
+        if (index == InternTable::NOT_FOUND) return false;
+        set(index, value);
+        return true;
+    }
+
+    // Function to recompute the cone of every variable staged since the last
+    // commit. Quadruples shared by several cones are recomputed once.
+    UpdateStats commit() {
+        UpdateStats stats;
+        stats.variablesChanged = changedVariables.size();
+        for (uint32_t variable : changedVariables) {
+            variableChanged[variable] = 0;
+            markReaders(variableReadersStart, variableReaders, variable);
+        }
+        changedVariables.clear();
+
+        // Readers always come after the quadruple they read, so one forward
+        // scan of the bitset visits the cone in order; dirtyHigh grows as it goes
+        for (size_t word = dirtyLow / 64; dirtyLow != SIZE_MAX && word <= dirtyHigh / 64; word++) {
+            while (dirty[word]) {
+                uint32_t quad = (uint32_t)(word * 64 + lowestBit(dirty[word]));
+                dirty[word] &= dirty[word] - 1;
+                double value = compute(quad);
+                stats.recomputed++;
+                if (memcmp(&temps[quad], &value, sizeof(value)) == 0) {
+                    stats.unchanged++;
+                    continue;
+                }
+                temps[quad] = value;
+                markReaders(tempReadersStart, tempReaders, quad);
+            }
+        }
+        dirtyLow = SIZE_MAX;
+        dirtyHigh = 0;
+        commits++;
+        totalRecomputed += stats.recomputed;
+        return stats;
+    }
+
+    // Function to change one variable and bring the result up to date
+    double update(uint32_t variable, double value, UpdateStats* stats = nullptr) {
+        set(variable, value);
+        UpdateStats done = commit();
+        if (stats) *stats = done;
+        return result();
+    }
+
+    double result() const {
+        if (program.result.kind() == OPERAND_NONE) return 0.0;
+        return valueOf(program.result);
+    }
+
+    double variable(uint32_t index) const { return variables[index]; }
+    size_t size() const { return temps.size(); }
+};
+
+#endif
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include "bytecode.h"
+#include "jit.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Structure to represent an expression tree node, for the tree-walking path
+struct TreeNode {
+    OperandKind kind;  // Leaf kind, or OPERAND_TEMP for an operator node
+    uint32_t index;
+    QuadOp op;
+    const TreeNode* left;
+    const TreeNode* right;
+};
+
+// Function to rebuild the expression tree from a program; nodes[i] is t(i + 1)
+const TreeNode* buildTree(const QuadrupleProgram& program, vector<unique_ptr<TreeNode>>& nodes) {
+    auto nodeOf = [&](Operand operand) -> const TreeNode* {
+        if (operand.kind() == OPERAND_TEMP) return nodes[operand.index() - 1].get();
+        nodes.push_back(make_unique<TreeNode>(TreeNode{operand.kind(), operand.index(), QuadOp::Add, nullptr, nullptr}));
+        return nodes.back().get();
+    };
+    // Temps first so nodes[i] stays t(i + 1)
+    nodes.clear();
+    for (size_t i = 0; i < program.code.size(); i++) {
+        nodes.push_back(make_unique<TreeNode>(TreeNode{OPERAND_TEMP, 0, program.code[i].op, nullptr, nullptr}));
+    }
+    for (size_t i = 0; i < program.code.size(); i++) {
+        nodes[i]->left = nodeOf(program.code[i].arg1);
+        nodes[i]->right = nodeOf(program.code[i].arg2);
+    }
+    return nodeOf(program.result);
+}
+
+// Function to evaluate a tree recursively
+double walkTree(const TreeNode* node, const QuadrupleProgram& program, const double* variables) {
+    switch (node->kind) {
+        case OPERAND_CONSTANT: return program.constantValues[node->index];
+        case OPERAND_VARIABLE: return variables[node->index];
+        default: break;
+    }
+    double a = walkTree(node->left, program, variables);
+    double b = walkTree(node->right, program, variables);
+    switch (node->op) {
+        case QuadOp::Add: return a + b;
+        case QuadOp::Sub: return a - b;
+        case QuadOp::Mul: return a * b;
+        default: return a / b;
+    }
+}
+
+// Function to build a random formula with the requested number of operators
+void appendFormula(string& out, mt19937& rng, int& operators, int depth) {
+    const char* ops = "+-*/";
+    for (int i = 0; i == 0 || (operators > 0 && rng() % 4 != 0); i++) {
+        if (i > 0) {
+            out += ops[rng() % 4];
+            operators--;
+        }
+        unsigned r = rng() % 8;
+        if (r == 0 && depth < 12) {
+            out += '(';
+            appendFormula(out, rng, operators, depth + 1);
+            out += ')';
+        } else if (r < 3) {
+            out += to_string(1 + rng() % 9) + "." + to_string(rng() % 100);
+        } else {
+            out += "v" + to_string(rng() % 12);
+        }
+    }
+}
+
+// Demo on the pricing formula, then time each evaluation path on several
+// formula sizes. Usage: jit [rows]
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? stoul(argv[1]) : 1u << 20;
+
+    QuadrupleGenerator generator;
+    const string formula = "price * qty * (1 + rate) - discount / 2 + (price - cost) * qty * 0.25";
+    generator.generate(formula);
+    JitFunction native;
+    if (!compileNative(generator.program(), native)) {
+        cout << "Native code generation is not available on this platform" << endl;
+        return 1;
+    }
+    cout << "Formula: " << formula << endl;
+    cout << "Generated " << native.size() << " bytes:";
+    const uint8_t* bytes = (const uint8_t*)native.function();
+    for (size_t i = 0; i < native.size(); i++) {
+        cout << (i % 16 ? " " : "\n  ") << hex << setw(2) << setfill('0') << (int)bytes[i];
+    }
+    cout << dec << setfill(' ') << endl;
+    vector<double> sample;
+    for (size_t v = 0; v < native.variables().size(); v++) {
+        sample.push_back(v + 2.0);
+        cout << (v ? ", " : "With ") << native.variables()[v] << "=" << sample.back();
+    }
+    cout << ": " << native(sample.data()) << endl << endl;
+
+    mt19937 rng(21);
+    vector<pair<string, string>> formulas = {{"pricing formula", formula}};
+    for (int operators : {30, 200, 2000}) {
+        string text;
+        int remaining = operators;
+        while (remaining > 0) {
+            if (!text.empty()) {
+                text += '+';
+                remaining--;
+            }
+            appendFormula(text, rng, remaining, 0);
+        }
+        formulas.push_back({to_string(operators) + " operators", text});
+    }
+
+    cout << left << setw(18) << "Formula" << right << setw(7) << "Quads" << setw(12) << "Tree ns"
+         << setw(12) << "Bytecode ns" << setw(12) << "Columns ns" << setw(12) << "Native ns"
+         << setw(10) << "Speedup" << setw(10) << "Match" << endl;
+
+    for (const auto& [name, text] : formulas) {
+        if (!generator.generate(text).ok) continue;
+        const QuadrupleProgram& program = generator.program();
+        size_t numVariables = program.variableTable.size();
+        size_t formulaRows = max<size_t>(1024, rows / max<size_t>(1, program.code.size() / 8));
+
+        // Inputs by variableTable index, one column per variable
+        uniform_real_distribution<double> dist(1.0, 100.0);
+        vector<vector<double>> columns(numVariables, vector<double>(formulaRows));
+        for (auto& column : columns) {
+            for (double& value : column) value = dist(rng);
+        }
+        vector<double> rowMajor(formulaRows * numVariables);
+        for (size_t i = 0; i < formulaRows; i++) {
+            for (size_t v = 0; v < numVariables; v++) rowMajor[i * numVariables + v] = columns[v][i];
+        }
+
+        // Tree walk
+        vector<unique_ptr<TreeNode>> nodes;
+        const TreeNode* root = buildTree(program, nodes);
+        vector<double> treeOut(formulaRows);
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < formulaRows; i++) treeOut[i] = walkTree(root, program, &rowMajor[i * numVariables]);
+        double treeNs = duration<double, nano>(steady_clock::now() - start).count() / formulaRows;
+
+        // Bytecode with allocated temps; its variables are in first-use order
+        TempAllocation allocation = allocateTemps(program, 16);
+        Bytecode bytecode;
+        compileQuadruples(program, bytecode, &allocation);
+        vector<size_t> bytecodeVariable;
+        for (const string& variable : bytecode.variables) bytecodeVariable.push_back(program.variableTable.find(variable));
+        vector<double> bytecodeRows(formulaRows * bytecodeVariable.size());
+        for (size_t i = 0; i < formulaRows; i++) {
+            for (size_t v = 0; v < bytecodeVariable.size(); v++) {
+                bytecodeRows[i * bytecodeVariable.size() + v] = columns[bytecodeVariable[v]][i];
+            }
+        }
+        BytecodeEvaluator evaluator(bytecode);
+        vector<double> bytecodeOut(formulaRows);
+        start = steady_clock::now();
+        for (size_t i = 0; i < formulaRows; i++) bytecodeOut[i] = evaluator.run(&bytecodeRows[i * bytecodeVariable.size()]);
+        double bytecodeNs = duration<double, nano>(steady_clock::now() - start).count() / formulaRows;
+
+        vector<const double*> columnPointers;
+        for (size_t v : bytecodeVariable) columnPointers.push_back(columns[v].data());
+        vector<double> columnOut(formulaRows);
+        start = steady_clock::now();
+        runColumns(bytecode, columnPointers.data(), formulaRows, columnOut.data());
+        double columnNs = duration<double, nano>(steady_clock::now() - start).count() / formulaRows;
+
+        // Native code
+        JitFunction jit;
+        compileNative(program, jit);
+        NativeFormula f = jit.function();
+        vector<double> nativeOut(formulaRows);
+        start = steady_clock::now();
+        for (size_t i = 0; i < formulaRows; i++) nativeOut[i] = f(&rowMajor[i * numVariables]);
+        double nativeNs = duration<double, nano>(steady_clock::now() - start).count() / formulaRows;
+
+        auto equal = [](double a, double b) { return a == b || (isnan(a) && isnan(b)); };
+        size_t mismatches = 0;
+        for (size_t i = 0; i < formulaRows; i++) {
+            if (!equal(treeOut[i], nativeOut[i]) || !equal(bytecodeOut[i], nativeOut[i]) || !equal(columnOut[i], nativeOut[i])) {
+                mismatches++;
+            }
+        }
+
+        cout << left << setw(18) << name << right << setw(7) << program.code.size() << fixed << setprecision(1)
+             << setw(12) << treeNs << setw(12) << bytecodeNs << setw(12) << columnNs << setw(12) << nativeNs
+             << setw(9) << bytecodeNs / nativeNs << "x" << setw(10) << (mismatches ? "NO" : "yes") << endl;
+    }
+    cout << "Speedup is native over scalar bytecode" << endl;
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "quadruple.h"
+#include "regalloc.h"
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define QUADRUPLE_JIT 1
+#endif
+
+using namespace std;
+
+// Native x86-64 code for a quadruple program. The generated function follows
+// the System V ABI: double f(const double* variables), where variables[i]
+// holds the value of variables()[i]. Temporaries live in xmm2..xmm15 as
+// chosen by allocateTemps, spills go to the stack frame, and constants sit in
+// a pool after the code addressed relative to rip.
+
+typedef double (*NativeFormula)(const double* variables);
+
+// Structure to own one block of generated code
+class JitFunction {
+    void* memory = nullptr;
+    size_t mappedBytes = 0;
+    size_t codeBytes = 0;
+    vector<string> names;
+
+public:
+    JitFunction() {}
+    JitFunction(const JitFunction&) = delete;
+    JitFunction& operator=(const JitFunction&) = delete;
+    JitFunction(JitFunction&& other) noexcept { *this = move(other); }
+    JitFunction& operator=(JitFunction&& other) noexcept {
+        swap(memory, other.memory);
+        swap(mappedBytes, other.mappedBytes);
+        swap(codeBytes, other.codeBytes);
+        swap(names, other.names);
+        return *this;
+    }
+    ~JitFunction() { release(); }
+
+    // Function to map code read-write, copy it in, then make it read-execute
+    bool load(const vector<uint8_t>& code, vector<string> variableNames) {
+        release();
+#ifdef QUADRUPLE_JIT
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t bytes = (code.size() + page - 1) / page * page;
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return false;
+        memcpy(p, code.data(), code.size());
+        if (mprotect(p, bytes, PROT_READ | PROT_EXEC) != 0) {
+            munmap(p, bytes);
+            return false;
+        }
+        memory = p;
+        mappedBytes = bytes;
+        codeBytes = code.size();
+        names = move(variableNames);
+        return true;
+#else
+        (void)code;
+        (void)variableNames;
+        return false;
+#endif
+    }
+
+    void release() {
+#ifdef QUADRUPLE_JIT
+        if (memory) munmap(memory, mappedBytes);
+#endif
+        memory = nullptr;
+        mappedBytes = codeBytes = 0;
+    }
+
+    NativeFormula function() const { return (NativeFormula)memory; }
+    double operator()(const double* variables) const { return function()(variables); }
+    const vector<string>& variables() const { return names; }
+    size_t size() const { return codeBytes; }
+};
+
+// Structure to name where a value is for the emitter
+struct NativeLocation {
+    enum Kind { Xmm, Variable, Constant, Spill } kind;
+    int index;
+};
+
+// Structure to assemble the handful of SSE2 instructions the backend needs
+class X64Emitter {
+public:
+    vector<uint8_t> code;
+    vector<pair<size_t, int>> constantFixups;  // (offset of rip displacement, constant index)
+
+    void byte(uint8_t b) { code.push_back(b); }
+
+    void dword(int32_t value) {
+        for (int i = 0; i < 4; i++) byte((uint8_t)(value >> (8 * i)));
+    }
+
+    // F2 [REX] 0F op ModRM: scalar double op between xmm reg and a location
+    void sse(uint8_t opcode, int reg, NativeLocation rm) {
+        byte(0xF2);
+        uint8_t rex = 0x40 | (reg >= 8 ? 0x04 : 0) | (rm.kind == NativeLocation::Xmm && rm.index >= 8 ? 0x01 : 0);
+        if (rex != 0x40) byte(rex);
+        byte(0x0F);
+        byte(opcode);
+        uint8_t r = (uint8_t)((reg & 7) << 3);
+        switch (rm.kind) {
+            case NativeLocation::Xmm:  // mod 11: register
+                byte(0xC0 | r | (rm.index & 7));
+                break;
+            case NativeLocation::Variable:  // mod 10, rm 111: [rdi + disp32]
+                byte(0x80 | r | 7);
+                dword(8 * rm.index);
+                break;
+            case NativeLocation::Spill:  // mod 10, rm 101: [rbp + disp32]
+                byte(0x80 | r | 5);
+                dword(-8 * (rm.index + 1));
+                break;
+            case NativeLocation::Constant:  // mod 00, rm 101: [rip + disp32]
+                byte(0x00 | r | 5);
+                constantFixups.push_back({code.size(), rm.index});
+                dword(0);
+                break;
+        }
+    }
+
+    // movsd [spill], xmm
+    void store(NativeLocation spill, int reg) { sse(0x11, reg, spill); }
+};
+
+// SSE2 opcodes for each QuadOp: addsd, subsd, mulsd, divsd
+inline uint8_t sseOpcode(QuadOp op) {
+    switch (op) {
+        case QuadOp::Add: return 0x58;
+        case QuadOp::Sub: return 0x5C;
+        case QuadOp::Mul: return 0x59;
+        default: return 0x5E;
+    }
+}
+
+const uint8_t SSE_MOVSD_LOAD = 0x10;
+const int JIT_FIRST_TEMP_XMM = 2;   // xmm0 returns the result, xmm1 is spare
+const int JIT_TEMP_REGISTERS = 14;  // xmm2..xmm15
+
+// Function to generate native code for a program. Variables are passed in
+// the order of the program's variableTable.
+inline bool compileNative(const QuadrupleProgram& program, JitFunction& function) {
+    TempAllocation allocation = allocateTemps(program, JIT_TEMP_REGISTERS);
+
+    auto locate = [&](Operand operand) -> NativeLocation {
+        switch (operand.kind()) {
+            case OPERAND_VARIABLE: return {NativeLocation::Variable, (int)operand.index()};
+            case OPERAND_CONSTANT: return {NativeLocation::Constant, (int)operand.index()};
+            default: {
+                const TempLocation& at = allocation.location[operand.index() - 1];
+                if (at.spilled) return {NativeLocation::Spill, at.index};
+                return {NativeLocation::Xmm, JIT_FIRST_TEMP_XMM + at.index};
+            }
+        }
+    };
+    auto same = [](NativeLocation a, NativeLocation b) { return a.kind == b.kind && a.index == b.index; };
+
+    for (const auto& quad : program.code) {
+        if (quad.arg1.kind() == OPERAND_NONE || quad.arg2.kind() == OPERAND_NONE) return false;
+    }
+    if (program.result.kind() == OPERAND_NONE) return false;
+
+    X64Emitter x;
+    // push rbp; mov rbp, rsp; sub rsp, frame (kept 16-byte aligned)
+    x.byte(0x55);
+    x.byte(0x48); x.byte(0x89); x.byte(0xE5);
+    if (allocation.numSpillSlots > 0) {
+        x.byte(0x48); x.byte(0x81); x.byte(0xEC);
+        x.dword((allocation.numSpillSlots * 8 + 15) / 16 * 16);
+    }
+
+    for (const auto& quad : program.code) {
+        NativeLocation dst = locate(quad.result), a = locate(quad.arg1), b = locate(quad.arg2);
+        uint8_t op = sseOpcode(quad.op);
+        bool commutative = quad.op == QuadOp::Add || quad.op == QuadOp::Mul;
+        if (dst.kind == NativeLocation::Xmm && same(b, dst) && !same(a, dst) && commutative) swap(a, b);
+
+        if (dst.kind == NativeLocation::Xmm && !same(b, dst)) {
+            // dst = a; dst op= b
+            if (!same(a, dst)) x.sse(SSE_MOVSD_LOAD, dst.index, a);
+            x.sse(op, dst.index, b);
+        } else {
+            // Work in xmm0 when dst is spilled or is also the right operand
+            x.sse(SSE_MOVSD_LOAD, 0, a);
+            x.sse(op, 0, b);
+            if (dst.kind == NativeLocation::Xmm) x.sse(SSE_MOVSD_LOAD, dst.index, {NativeLocation::Xmm, 0});
+            else x.store(dst, 0);
+        }
+    }
+
+    // movsd xmm0, result; leave; ret
+    x.sse(SSE_MOVSD_LOAD, 0, locate(program.result));
+    x.byte(0xC9);
+    x.byte(0xC3);
+
+    // Constant pool, 8-byte aligned, then patch the rip-relative displacements
+    while (x.code.size() % 8) x.byte(0xCC);
+    size_t pool = x.code.size();
+    for (double value : program.constantValues) {
+        uint8_t bytes[8];
+        memcpy(bytes, &value, 8);
+        x.code.insert(x.code.end(), bytes, bytes + 8);
+    }
+    for (const auto& [offset, index] : x.constantFixups) {
+        int32_t displacement = (int32_t)(pool + 8 * index - (offset + 4));
+        memcpy(&x.code[offset], &displacement, 4);
+    }
+
+    vector<string> names;
+    for (size_t v = 0; v < program.variableTable.size(); v++) names.push_back(string(program.variableTable.at(v)));
+    return function.load(x.code, move(names));
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef LITERAL_H
+#define LITERAL_H
+
+#include <string_view>
+#include <cstdint>
+#include <charconv>
+#include <system_error>
+
+using namespace std;
+
+// Numeric literal scanner shared by the expression front ends. A literal is
+//   digits [ '.' digits* ] [ exponent ]  |  '.' digits [ exponent ]
+//   exponent : ('e' | 'E') ['+' | '-'] digits
+// It has no sign; unary minus is the parser's business. The scanner reads
+// straight from the input buffer and never builds a temporary string.
+
+// Structure to hold one scanned literal
+struct NumericLiteral {
+    string_view text;             // Spelling, pointing into the input
+    double value = 0;
+    const char* error = nullptr;  // Static message, or nullptr when valid
+};
+
+// Exact powers of ten for the fast path; 10^22 is the largest a double holds exactly
+const double EXACT_POWERS_OF_TEN[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Function to scan a literal starting at cur, which must be a digit or '.'.
+// Returns the position after the literal, or after the valid prefix on error.
+// Literals with at most 15 significant digits and a small exponent convert
+// with one exact multiply or divide (Clinger's fast path); the rest go to
+// from_chars, which rounds correctly.
+inline const char* scanNumber(const char* cur, const char* end, NumericLiteral& literal) {
+    const char* start = cur;
+    literal = NumericLiteral();
+    auto isDigit = [](char c) { return (unsigned)(c - '0') < 10; };
+
+    uint64_t mantissa = 0;
+    int digits = 0;      // Significant digits kept in mantissa
+    int exponent = 0;    // Power of ten to apply to mantissa
+    bool exact = true;   // Every significant digit fit in mantissa
+    bool sawDigit = false;
+
+    auto addDigit = [&](char c, bool fraction) {
+        sawDigit = true;
+        if (mantissa == 0 && c == '0') {
+            if (fraction) exponent--;  // Leading zeros after the point only shift
+            return;
+        }
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(c - '0');
+            digits++;
+            if (fraction) exponent--;
+        } else {
+            exact = false;
+            if (!fraction) exponent++;
+        }
+    };
+
+    while (cur < end && isDigit(*cur)) addDigit(*cur++, false);
+    if (cur < end && *cur == '.') {
+        cur++;
+        while (cur < end && isDigit(*cur)) addDigit(*cur++, true);
+    }
+    if (!sawDigit) {
+        literal.error = "Invalid number";
+        return cur;
+    }
+    if (cur < end && (*cur == 'e' || *cur == 'E')) {
+        const char* exponentStart = cur++;
+        bool negative = false;
+        if (cur < end && (*cur == '+' || *cur == '-')) negative = *cur++ == '-';
+        if (cur == end || !isDigit(*cur)) {
+            literal.error = "Invalid number";
+            return exponentStart;
+        }
+        int written = 0;
+        while (cur < end && isDigit(*cur)) {
+            if (written < 100000) written = written * 10 + (*cur - '0');
+            cur++;
+        }
+        exponent += negative ? -written : written;
+    }
+    literal.text = string_view(start, cur - start);
+
+    // A second point, as in 1.2.3, would otherwise scan as 1.2 followed by .3
+    if (cur < end && *cur == '.') {
+        literal.error = "Invalid number";
+        return cur;
+    }
+
+    if (exact && digits <= 15 && exponent >= -22 && exponent <= 22) {
+        literal.value = (double)mantissa;
+        if (exponent < 0) literal.value /= EXACT_POWERS_OF_TEN[-exponent];
+        else literal.value *= EXACT_POWERS_OF_TEN[exponent];
+        return cur;
+    }
+    auto [last, ec] = from_chars(start, cur, literal.value);
+    if (ec == errc::result_out_of_range) {
+        literal.error = "Number out of range";
+    } else if (ec != errc() || last != cur) {
+        literal.error = "Invalid number";
+    }
+    return cur;
+}
+
+#endif
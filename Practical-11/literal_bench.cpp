@@ -0,0 +1,148 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "literal.h"
+#include "quadruple.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to append one random literal in the given style
+void appendLiteral(string& out, mt19937_64& rng, int style) {
+    switch (style) {
+        case 0:  // Integer
+            out += to_string(rng() % 100000);
+            break;
+        case 1:  // Short decimal, like a price
+            out += to_string(rng() % 1000) + "." + to_string(rng() % 100);
+            break;
+        case 2: {  // Exponent
+            out += to_string(1 + rng() % 9) + "." + to_string(rng() % 1000) + "e";
+            int exponent = (int)(rng() % 61) - 30;
+            out += to_string(exponent);
+            break;
+        }
+        default: {  // Full precision, which needs the slow path
+            char buffer[32];
+            double value = (double)(rng() >> 11) / (double)(1ull << 53) * 1000;
+            auto [last, ec] = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::fixed, 17);
+            out.append(buffer, ec == errc() ? last : buffer);
+            break;
+        }
+    }
+}
+
+// Function to time one way of converting every literal in a space-separated
+// buffer, taking the best of several runs. Returns the sum of the values.
+template <typename Convert>
+double timeConversion(const string& text, Convert convert, double& bestMs) {
+    double sum = 0;
+    bestMs = 1e300;
+    for (int run = 0; run < 5; run++) {
+        sum = 0;
+        auto start = steady_clock::now();
+        const char* cur = text.data();
+        const char* end = cur + text.size();
+        while (cur < end) {
+            sum += convert(cur, end);
+            while (cur < end && *cur == ' ') cur++;
+        }
+        bestMs = min(bestMs, duration<double, milli>(steady_clock::now() - start).count());
+    }
+    return sum;
+}
+
+// Usage: literal_bench [literals]
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 1000000;
+
+    cout << count << " literals per mix" << endl;
+    cout << left << setw(16) << "Mix" << setw(18) << "Method" << right << setw(10) << "ms" << setw(10) << "MB/s"
+         << setw(14) << "Mliterals/s" << setw(10) << "Match" << endl;
+
+    const char* mixes[] = {"integers", "decimals", "exponents", "17 digits", "mixed"};
+    for (int mix = 0; mix < 5; mix++) {
+        mt19937_64 rng(40 + mix);
+        string text;
+        for (size_t i = 0; i < count; i++) {
+            if (i) text += ' ';
+            appendLiteral(text, rng, mix < 4 ? mix : (int)(rng() % 4));
+        }
+
+        // The scanner must agree bit for bit with from_chars on every literal
+        bool exact = true;
+        for (const char* cur = text.data(), *end = cur + text.size(); cur < end;) {
+            NumericLiteral literal;
+            const char* next = scanNumber(cur, end, literal);
+            double expected = 0;
+            from_chars(cur, next, expected);
+            if (literal.error || memcmp(&expected, &literal.value, sizeof(double)) != 0) exact = false;
+            cur = next;
+            while (cur < end && *cur == ' ') cur++;
+        }
+
+        // The old front ends: copy one character at a time, then stod
+        auto legacy = [](const char*& cur, const char* end) {
+            string token;
+            while (cur < end && (isdigit((unsigned char)*cur) || *cur == '.' || *cur == 'e' || *cur == '-')) {
+                token += *cur++;
+            }
+            return stod(token);
+        };
+        auto viaStrtod = [](const char*& cur, const char*) {
+            char* next;
+            double value = strtod(cur, &next);
+            cur = next;
+            return value;
+        };
+        auto viaFromChars = [](const char*& cur, const char* end) {
+            double value = 0;
+            cur = from_chars(cur, end, value).ptr;
+            return value;
+        };
+        auto viaScanner = [](const char*& cur, const char* end) {
+            NumericLiteral literal;
+            cur = scanNumber(cur, end, literal);
+            return literal.value;
+        };
+
+        struct Method {
+            const char* name;
+            double ms = 0;
+            double sum = 0;
+        };
+        vector<Method> methods = {{"string + stod"}, {"strtod"}, {"from_chars"}, {"scanNumber"}};
+        methods[0].sum = timeConversion(text, legacy, methods[0].ms);
+        methods[1].sum = timeConversion(text, viaStrtod, methods[1].ms);
+        methods[2].sum = timeConversion(text, viaFromChars, methods[2].ms);
+        methods[3].sum = timeConversion(text, viaScanner, methods[3].ms);
+        for (const Method& m : methods) {
+            bool match = m.sum == methods[2].sum && exact;
+            cout << left << setw(16) << mixes[mix] << setw(18) << m.name << right << fixed << setprecision(1)
+                 << setw(10) << m.ms << setw(10) << text.size() / m.ms / 1e3 << setw(14) << count / m.ms / 1e3
+                 << setw(10) << (match ? "yes" : "NO") << defaultfloat << endl;
+        }
+    }
+
+    // End to end: quadruple generation on a literal-heavy formula
+    mt19937_64 rng(400);
+    string formula;
+    for (size_t i = 0; i < count / 10; i++) {
+        if (i) formula += i % 3 ? " + " : " * ";
+        appendLiteral(formula, rng, (int)(rng() % 3));
+        formula += " * x" + to_string(i % 16);
+    }
+    QuadrupleGenerator generator;
+    auto start = steady_clock::now();
+    GenerateResult status = generator.generate(formula);
+    double ms = duration<double, milli>(steady_clock::now() - start).count();
+    cout << "Generating quadruples for " << count / 10 << " literals: " << fixed << setprecision(1) << ms << " ms, "
+         << formula.size() / ms / 1e3 << " MB/s" << (status.ok ? "" : " (error)") << endl;
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include "quadruple.h"
+
+using namespace std;
+
+// Optimization passes over a QuadrupleProgram. A program is one basic block
+// in which every temporary is assigned exactly once and variables are never
+// assigned, so the passes need no kill sets. Every pass leaves temporaries
+// numbered t1, t2, ... in instruction order, which compileQuadruples relies on.
+
+// Function to look up the operand a temporary was replaced with
+inline Operand resolve(const vector<Operand>& replacement, Operand operand) {
+    if (operand.kind() == OPERAND_TEMP && operand.index() < replacement.size() &&
+        replacement[operand.index()].kind() != OPERAND_NONE) {
+        return replacement[operand.index()];
+    }
+    return operand;
+}
+
+// Function to substitute replacements into the remaining quadruples and the
+// result, then renumber the surviving temporaries densely
+inline void rewriteTemps(QuadrupleProgram& program, vector<Operand>& replacement) {
+    for (auto& quad : program.code) {
+        quad.arg1 = resolve(replacement, quad.arg1);
+        quad.arg2 = resolve(replacement, quad.arg2);
+    }
+    program.result = resolve(replacement, program.result);
+
+    vector<Operand> renumber(replacement.size(), Operand::make(OPERAND_NONE, 0));
+    uint32_t next = 1;
+    for (auto& quad : program.code) {
+        Operand temp = Operand::make(OPERAND_TEMP, next++);
+        renumber[quad.result.index()] = temp;
+        quad.result = temp;
+        quad.arg1 = resolve(renumber, quad.arg1);
+        quad.arg2 = resolve(renumber, quad.arg2);
+    }
+    program.result = resolve(renumber, program.result);
+}
+
+// Function to size a replacement table for the program's temporaries
+inline vector<Operand> noReplacements(const QuadrupleProgram& program) {
+    return vector<Operand>(program.code.size() + 1, Operand::make(OPERAND_NONE, 0));
+}
+
+// Function to compute op on two constants
+inline double applyOp(QuadOp op, double a, double b) {
+    switch (op) {
+        case QuadOp::Add: return a + b;
+        case QuadOp::Sub: return a - b;
+        case QuadOp::Mul: return a * b;
+        default: return a / b;
+    }
+}
+
+// Constant folding and propagation: an operation on two constants becomes a
+// constant, which then flows into later quadruples. Division by zero is left
+// for run time.
+inline void foldConstants(QuadrupleProgram& program) {
+    vector<Operand> replacement = noReplacements(program);
+    size_t kept = 0;
+    for (size_t i = 0; i < program.code.size(); i++) {
+        Quadruple quad = program.code[i];
+        quad.arg1 = resolve(replacement, quad.arg1);
+        quad.arg2 = resolve(replacement, quad.arg2);
+        if (quad.arg1.kind() == OPERAND_CONSTANT && quad.arg2.kind() == OPERAND_CONSTANT) {
+            double a = program.constantValues[quad.arg1.index()];
+            double b = program.constantValues[quad.arg2.index()];
+            if (!(quad.op == QuadOp::Div && b == 0)) {
+                replacement[quad.result.index()] = program.internConstant(applyOp(quad.op, a, b));
+                continue;
+            }
+        }
+        program.code[kept++] = quad;
+    }
+    program.code.resize(kept);
+    rewriteTemps(program, replacement);
+}
+
+// Algebraic simplification: x+0, 0+x, x-0, x*1, 1*x and x/1 become x, and
+// x*2 becomes x+x. x+0 drops the sign of a negative zero, as -ffast-math would.
+inline void simplifyAlgebra(QuadrupleProgram& program) {
+    auto isConstant = [&](Operand operand, double value) {
+        return operand.kind() == OPERAND_CONSTANT && program.constantValues[operand.index()] == value;
+    };
+
+    vector<Operand> replacement = noReplacements(program);
+    size_t kept = 0;
+    for (size_t i = 0; i < program.code.size(); i++) {
+        Quadruple quad = program.code[i];
+        quad.arg1 = resolve(replacement, quad.arg1);
+        quad.arg2 = resolve(replacement, quad.arg2);
+
+        Operand same = Operand::make(OPERAND_NONE, 0);
+        switch (quad.op) {
+            case QuadOp::Add:
+                if (isConstant(quad.arg2, 0)) same = quad.arg1;
+                else if (isConstant(quad.arg1, 0)) same = quad.arg2;
+                break;
+            case QuadOp::Sub:
+                if (isConstant(quad.arg2, 0)) same = quad.arg1;
+                break;
+            case QuadOp::Mul:
+                if (isConstant(quad.arg2, 1)) same = quad.arg1;
+                else if (isConstant(quad.arg1, 1)) same = quad.arg2;
+                else if (isConstant(quad.arg2, 2)) quad = {QuadOp::Add, quad.arg1, quad.arg1, quad.result};
+                else if (isConstant(quad.arg1, 2)) quad = {QuadOp::Add, quad.arg2, quad.arg2, quad.result};
+                break;
+            case QuadOp::Div:
+                if (isConstant(quad.arg2, 1)) same = quad.arg1;
+                break;
+        }
+
+        if (same.kind() != OPERAND_NONE) {
+            replacement[quad.result.index()] = same;
+        } else {
+            program.code[kept++] = quad;
+        }
+    }
+    program.code.resize(kept);
+    rewriteTemps(program, replacement);
+}
+
+// Structure to key a quadruple by what it computes
+struct ValueKey {
+    QuadOp op;
+    uint32_t arg1;
+    uint32_t arg2;
+    bool operator==(const ValueKey& other) const {
+        return op == other.op && arg1 == other.arg1 && arg2 == other.arg2;
+    }
+};
+
+struct ValueKeyHash {
+    size_t operator()(const ValueKey& key) const {
+        return ((size_t)key.arg1 * 0x9E3779B97F4A7C15ull) ^ ((size_t)key.arg2 << 2) ^ (size_t)key.op;
+    }
+};
+
+// Local common-subexpression elimination by value numbering: a quadruple whose
+// (op, arg1, arg2) was already computed reuses the earlier temporary. Operands
+// of + and * are put in a canonical order first.
+inline void eliminateCommonSubexpressions(QuadrupleProgram& program) {
+    vector<Operand> replacement = noReplacements(program);
+    unordered_map<ValueKey, Operand, ValueKeyHash> computed;
+    computed.reserve(program.code.size());
+    size_t kept = 0;
+    for (size_t i = 0; i < program.code.size(); i++) {
+        Quadruple quad = program.code[i];
+        quad.arg1 = resolve(replacement, quad.arg1);
+        quad.arg2 = resolve(replacement, quad.arg2);
+        bool commutative = quad.op == QuadOp::Add || quad.op == QuadOp::Mul;
+        if (commutative && quad.arg1.bits > quad.arg2.bits) swap(quad.arg1, quad.arg2);
+
+        auto [it, inserted] = computed.insert({{quad.op, quad.arg1.bits, quad.arg2.bits}, quad.result});
+        if (!inserted) {
+            replacement[quad.result.index()] = it->second;
+            continue;
+        }
+        program.code[kept++] = quad;
+    }
+    program.code.resize(kept);
+    rewriteTemps(program, replacement);
+}
+
+// Dead-temp elimination: drop quadruples whose result never reaches the
+// program's result
+inline void eliminateDeadTemps(QuadrupleProgram& program) {
+    vector<char> live(program.code.size() + 1, 0);
+    if (program.result.kind() == OPERAND_TEMP) live[program.result.index()] = 1;
+    for (size_t i = program.code.size(); i-- > 0;) {
+        const Quadruple& quad = program.code[i];
+        if (!live[quad.result.index()]) continue;
+        if (quad.arg1.kind() == OPERAND_TEMP) live[quad.arg1.index()] = 1;
+        if (quad.arg2.kind() == OPERAND_TEMP) live[quad.arg2.index()] = 1;
+    }
+
+    vector<Operand> replacement = noReplacements(program);
+    size_t kept = 0;
+    for (size_t i = 0; i < program.code.size(); i++) {
+        if (live[program.code[i].result.index()]) program.code[kept++] = program.code[i];
+    }
+    program.code.resize(kept);
+    rewriteTemps(program, replacement);
+}
+
+// Structure to report what one pass did
+struct PassStats {
+    string name;
+    size_t before;       // Quadruples going in
+    size_t after;        // Quadruples coming out
+    double microseconds;
+};
+
+// Structure to run a sequence of passes and time each one
+class PassManager {
+    vector<pair<string, void (*)(QuadrupleProgram&)>> passes;
+
+public:
+    void add(const string& name, void (*pass)(QuadrupleProgram&)) {
+        passes.push_back({name, pass});
+    }
+
+    vector<PassStats> run(QuadrupleProgram& program) const {
+        vector<PassStats> stats;
+        for (const auto& [name, pass] : passes) {
+            size_t before = program.code.size();
+            auto start = chrono::steady_clock::now();
+            pass(program);
+            double microseconds = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+            stats.push_back({name, before, program.code.size(), microseconds});
+        }
+        return stats;
+    }
+};
+
+// Function to build the standard pipeline. Simplification runs after folding
+// so it sees propagated constants, and CSE after both so x*2 and x+x meet.
+inline PassManager defaultPipeline() {
+    PassManager manager;
+    manager.add("constant folding", foldConstants);
+    manager.add("algebraic simplification", simplifyAlgebra);
+    manager.add("common subexpressions", eliminateCommonSubexpressions);
+    manager.add("dead temps", eliminateDeadTemps);
+    return manager;
+}
+
+#endif
@@ -0,0 +1,311 @@
+#ifndef QUADRUPLE_H
+#define QUADRUPLE_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cctype>
+#include <cstdint>
+#include <charconv>
+#include <algorithm>
+#include "literal.h"
+#include "descent.h"
+
+using namespace std;
+
+// Quadruple operators
+enum class QuadOp : uint8_t { Add, Sub, Mul, Div };
+
+// Kind of an operand, kept in the top two bits of its handle
+enum OperandKind : uint32_t {
+    OPERAND_NONE = 0,      // Missing operand (malformed expression)
+    OPERAND_CONSTANT = 1,  // Index into constantPool
+    OPERAND_VARIABLE = 2,  // Index into variableTable
+    OPERAND_TEMP = 3       // Temporary number, t1, t2, ...
+};
+
+// Structure to represent an operand as a tagged 32-bit handle
+struct Operand {
+    uint32_t bits;
+
+    static Operand make(OperandKind kind, uint32_t index) {
+        return {(uint32_t)kind << 30 | index};
+    }
+    OperandKind kind() const { return (OperandKind)(bits >> 30); }
+    uint32_t index() const { return bits & 0x3FFFFFFF; }
+    bool operator==(Operand other) const { return bits == other.bits; }
+};
+
+// Structure to represent a quadruple (16 bytes, no heap storage)
+struct Quadruple {
+    QuadOp op;
+    Operand arg1;
+    Operand arg2;
+    Operand result;
+};
+
+// Structure to intern spellings: every distinct spelling is stored once in a
+// shared character buffer and gets a dense index
+struct InternTable {
+    string chars;                    // All spellings back to back
+    vector<uint32_t> offsets = {0};  // Spelling i is chars[offsets[i], offsets[i + 1])
+    vector<uint32_t> slots;          // Open addressing, holds index + 1 or 0 when empty
+
+    size_t size() const { return offsets.size() - 1; }
+
+    string_view at(uint32_t i) const {
+        return string_view(chars).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    // Return the index of the spelling, adding it if it is new
+    uint32_t intern(string_view text) {
+        if ((size() + 1) * 2 > slots.size()) grow();
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash(text) & mask;; slot = (slot + 1) & mask) {
+            if (slots[slot] == 0) {
+                chars.append(text);
+                offsets.push_back((uint32_t)chars.size());
+                slots[slot] = (uint32_t)size();
+                return (uint32_t)size() - 1;
+            }
+            if (at(slots[slot] - 1) == text) return slots[slot] - 1;
+        }
+    }
+
+    // Return the index of the spelling, or NOT_FOUND
+    static const uint32_t NOT_FOUND = UINT32_MAX;
+    uint32_t find(string_view text) const {
+        if (slots.empty()) return NOT_FOUND;
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash(text) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            if (at(slots[slot] - 1) == text) return slots[slot] - 1;
+        }
+        return NOT_FOUND;
+    }
+
+    // Forget every spelling but keep the storage
+    void clear() {
+        chars.clear();
+        offsets.resize(1);
+        fill(slots.begin(), slots.end(), 0);
+    }
+
+private:
+    static size_t hash(string_view text) {
+        size_t h = 14695981039346656037ull;  // FNV-1a
+        for (char c : text) h = (h ^ (unsigned char)c) * 1099511628211ull;
+        return h;
+    }
+
+    void grow() {
+        vector<uint32_t> old(max<size_t>(16, slots.size() * 2), 0);
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for (uint32_t i = 0; i < size(); i++) {
+            size_t slot = hash(at(i)) & mask;
+            while (slots[slot] != 0) slot = (slot + 1) & mask;
+            slots[slot] = i + 1;
+        }
+    }
+};
+
+// Structure to hold the IR of one expression together with the tables its
+// operand handles point into
+struct QuadrupleProgram {
+    vector<Quadruple> code;
+    InternTable constantPool;       // Spellings of numeric literals
+    vector<double> constantValues;  // Value of each constantPool entry
+    InternTable variableTable;      // Variable names
+    Operand result = Operand::make(OPERAND_NONE, 0);  // Operand holding the value of the expression
+
+    // Forget the expression but keep the storage
+    void clear() {
+        code.clear();
+        constantPool.clear();
+        constantValues.clear();
+        variableTable.clear();
+        result = Operand::make(OPERAND_NONE, 0);
+    }
+
+    // Function to intern a numeric literal whose value is already known
+    Operand internConstant(string_view text, double value) {
+        uint32_t index = constantPool.intern(text);
+        if (index == constantValues.size()) constantValues.push_back(value);
+        return Operand::make(OPERAND_CONSTANT, index);
+    }
+
+    // Function to intern a computed value under its shortest spelling
+    Operand internConstant(double value) {
+        char buffer[32];
+        auto [last, ec] = to_chars(buffer, buffer + sizeof(buffer), value);
+        return internConstant(string_view(buffer, ec == errc() ? last - buffer : 0), value);
+    }
+
+    // Function to render an operand the way it was written
+    string operandToString(Operand operand) const {
+        switch (operand.kind()) {
+            case OPERAND_CONSTANT: return string(constantPool.at(operand.index()));
+            case OPERAND_VARIABLE: return string(variableTable.at(operand.index()));
+            case OPERAND_TEMP: return "t" + to_string(operand.index());
+            default: return "";
+        }
+    }
+};
+
+// Function to render an operator
+inline char opToChar(QuadOp op) {
+    switch (op) {
+        case QuadOp::Add: return '+';
+        case QuadOp::Sub: return '-';
+        case QuadOp::Mul: return '*';
+        default: return '/';
+    }
+}
+
+// Function to print the quadruple table
+inline void printQuadruples(const QuadrupleProgram& program) {
+    cout << "Operator\tOperand 1\tOperand 2\tResult" << endl;
+    for (const auto& quad : program.code) {
+        cout << opToChar(quad.op) << "\t" << program.operandToString(quad.arg1) << "\t"
+             << program.operandToString(quad.arg2) << "\t" << program.operandToString(quad.result) << endl;
+    }
+}
+
+// Structure to hold the outcome of one translation
+struct GenerateResult {
+    bool ok;
+    const char* error;  // Static message, nullptr when ok
+    size_t position;    // Offset of the error in the expression
+};
+
+// Re-entrant quadruple generator for the grammar
+//   E → E + T | E - T | T
+//   T → T * F | T / F | F
+//   F → (E) | number | id
+// All state lives in the object, so one generator per thread can translate
+// any number of expressions, reusing its buffers.
+class QuadrupleGenerator : ExpressionScanner {
+    QuadrupleProgram ir;
+    int tempCount;  // To generate temporary variables like t1, t2, t3...
+
+public:
+    QuadrupleGenerator() : tempCount(1) {}
+
+    // Translate one expression, replacing the previous program
+    GenerateResult generate(const char* text, size_t length) {
+        reset();
+        start(text, length);
+
+        Operand result = parseExpression();
+        finish();
+
+        if (error) {
+            ir.clear();
+            return {false, error, errorPosition()};
+        }
+        ir.result = result;
+        return {true, nullptr, 0};
+    }
+
+    GenerateResult generate(const string& expr) {
+        return generate(expr.data(), expr.size());
+    }
+
+    // The program built by the last successful generate()
+    const QuadrupleProgram& program() const { return ir; }
+
+    // Start over at t1 with empty tables, keeping their capacity
+    void reset() {
+        ir.clear();
+        tempCount = 1;
+    }
+
+private:
+    // Function to generate a new temporary variable
+    Operand newTemp() {
+        return Operand::make(OPERAND_TEMP, tempCount++);
+    }
+
+    // Function to handle parsing of expressions (E → E + T | E – T | T)
+    Operand parseExpression() {
+        Operand result = parseTerm();  // Start by parsing a term
+        while (!error) {
+            char c = peek();
+            if (c != '+' && c != '-') break;  // Look for + or -
+            cur++;
+            Operand operand2 = parseTerm();  // Parse another term
+            Operand temp = newTemp();
+            ir.code.push_back({c == '+' ? QuadOp::Add : QuadOp::Sub, result, operand2, temp});
+            result = temp;  // The result of the operation becomes the new result
+        }
+        return result;
+    }
+
+    // Function to handle parsing of terms (T → T * F | T / F | F)
+    Operand parseTerm() {
+        Operand result = parseFactor();  // Start by parsing a factor
+        while (!error) {
+            char c = peek();
+            if (c != '*' && c != '/') break;  // Look for * or /
+            cur++;
+            Operand operand2 = parseFactor();  // Parse another factor
+            Operand temp = newTemp();
+            ir.code.push_back({c == '*' ? QuadOp::Mul : QuadOp::Div, result, operand2, temp});
+            result = temp;  // The result of the operation becomes the new result
+        }
+        return result;
+    }
+
+    // Function to handle parsing of a factor (F → (E) | number | id)
+    Operand parseFactor() {
+        char c = peek();
+        const char* start = cur;
+        if (c == '(') {  // If it's an opening parenthesis, parse the expression inside it
+            if (!enterNesting()) return Operand::make(OPERAND_NONE, 0);
+            cur++;  // Skip '('
+            Operand result = parseExpression();
+            if (error) return result;
+            if (peek() != ')') {
+                fail("Expected closing parenthesis");
+                return result;
+            }
+            cur++;  // Skip ')'
+            leaveNesting();
+            return result;
+        } else if (isdigit((unsigned char)c) || c == '.') {  // A number is used as a literal operand
+            NumericLiteral literal;
+            const char* next = scanNumber(cur, end, literal);
+            if (literal.error) {
+                fail(literal.error);
+                return Operand::make(OPERAND_NONE, 0);
+            }
+            cur = next;
+            return ir.internConstant(literal.text, literal.value);
+        } else if (isalpha((unsigned char)c) || c == '_') {  // A variable name is used as it is
+            while (cur < end && (isalnum((unsigned char)*cur) || *cur == '_')) cur++;
+            return Operand::make(OPERAND_VARIABLE, ir.variableTable.intern(string_view(start, cur - start)));
+        }
+        fail(c == '\0' ? "Unexpected end of expression" : "Invalid character");
+        return Operand::make(OPERAND_NONE, 0);
+    }
+};
+
+// Structure to hold one translated expression of a batch
+struct Translation {
+    GenerateResult status;
+    QuadrupleProgram program;  // Empty when the expression had an error
+};
+
+// Function to translate a batch of expressions on several threads, one
+// generator per worker
+inline vector<Translation> generateBatch(const vector<string>& expressions, unsigned threads = 0) {
+    vector<Translation> results(expressions.size());
+    runBatch<QuadrupleGenerator>(expressions.size(), 256, threads, [&](QuadrupleGenerator& generator, size_t i) {
+        results[i].status = generator.generate(expressions[i]);
+        if (results[i].status.ok) results[i].program = generator.program();
+    });
+    return results;
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include "quadruple.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Count every heap allocation made by the program
+static size_t allocationCount = 0;
+static size_t allocatedBytes = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    allocatedBytes += size;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// The string-based generator this IR replaced, kept for comparison
+namespace legacy {
+
+struct Quadruple {
+    string op;
+    string arg1;
+    string arg2;
+    string result;
+};
+
+vector<Quadruple> quadruples;
+int tempCount = 1;
+
+string newTemp() {
+    return "t" + to_string(tempCount++);
+}
+
+void skipSpaces(const string& expr, int& index) {
+    while (index < (int)expr.length() && (expr[index] == ' ' || expr[index] == '\t')) index++;
+}
+
+string parseExpression(const string& expr, int& index);
+
+string parseFactor(const string& expr, int& index) {
+    skipSpaces(expr, index);
+    if (expr[index] == '(') {
+        index++;
+        string result = parseExpression(expr, index);
+        skipSpaces(expr, index);
+        if (expr[index] == ')') index++;
+        return result;
+    } else if (isdigit(expr[index]) || expr[index] == '.') {
+        string operand = "";
+        while (isdigit(expr[index]) || expr[index] == '.') operand += expr[index++];
+        return operand;
+    } else if (isalpha(expr[index]) || expr[index] == '_') {
+        string operand = "";
+        while (isalnum(expr[index]) || expr[index] == '_') operand += expr[index++];
+        return operand;
+    }
+    return "";
+}
+
+string parseTerm(const string& expr, int& index) {
+    string result = parseFactor(expr, index);
+    skipSpaces(expr, index);
+    while (expr[index] == '*' || expr[index] == '/') {
+        char op = expr[index++];
+        string operand2 = parseFactor(expr, index);
+        string temp = newTemp();
+        quadruples.push_back({string(1, op), result, operand2, temp});
+        result = temp;
+        skipSpaces(expr, index);
+    }
+    return result;
+}
+
+string parseExpression(const string& expr, int& index) {
+    string result = parseTerm(expr, index);
+    skipSpaces(expr, index);
+    while (expr[index] == '+' || expr[index] == '-') {
+        char op = expr[index++];
+        string operand2 = parseTerm(expr, index);
+        string temp = newTemp();
+        quadruples.push_back({string(1, op), result, operand2, temp});
+        result = temp;
+        skipSpaces(expr, index);
+    }
+    return result;
+}
+
+}  // namespace legacy
+
+// Function to generate a random expression with about the requested number
+// of operators, using numbers, a few dozen variable names and parentheses
+void appendExpression(string& out, mt19937& rng, size_t operators, int depth, const string& prefix) {
+    const char* ops = "+-*/";
+    for (size_t i = 0; i <= operators; i++) {
+        if (i > 0) {
+            out += ' ';
+            out += ops[rng() % 4];
+            out += ' ';
+        }
+        unsigned r = rng() % 10;
+        if (r == 0 && depth < 16 && operators - i > 4) {
+            size_t inner = 1 + rng() % 4;
+            out += '(';
+            appendExpression(out, rng, inner, depth + 1, prefix);
+            out += ')';
+            i += inner;
+        } else if (r < 5) {
+            out += to_string(rng() % 1000);
+        } else {
+            out += prefix + to_string(rng() % 32);
+        }
+    }
+}
+
+// Function to time both generators on one set of expressions
+void compareGenerators(const vector<string>& inputs) {
+    cout << left << setw(20) << "Generator" << right << setw(12) << "Quadruples" << setw(13) << "Allocations"
+         << setw(14) << "Bytes alloc'd" << setw(10) << "ms" << setw(10) << "ns/quad" << endl;
+
+    auto report = [&](const char* name, size_t quads, size_t allocations, size_t bytes, double ms) {
+        cout << left << setw(20) << name << right << setw(12) << quads << setw(13) << allocations
+             << setw(14) << bytes << setw(10) << fixed << setprecision(1) << ms
+             << setw(10) << ms * 1e6 / quads << endl;
+    };
+
+    // Before: four strings per quadruple
+    size_t quads = 0;
+    size_t allocations = allocationCount, bytes = allocatedBytes;
+    auto start = steady_clock::now();
+    for (const auto& expr : inputs) {
+        legacy::quadruples.clear();
+        legacy::tempCount = 1;
+        int index = 0;
+        legacy::parseExpression(expr, index);
+        quads += legacy::quadruples.size();
+    }
+    double ms = duration<double, milli>(steady_clock::now() - start).count();
+    report("strings", quads, allocationCount - allocations, allocatedBytes - bytes, ms);
+
+    // After: handles into the interned tables, storage reused between expressions
+    quads = 0;
+    allocations = allocationCount;
+    bytes = allocatedBytes;
+    QuadrupleGenerator generator;
+    start = steady_clock::now();
+    for (const auto& expr : inputs) {
+        generator.generate(expr);
+        quads += generator.program().code.size();
+    }
+    ms = duration<double, milli>(steady_clock::now() - start).count();
+    report("interned handles", quads, allocationCount - allocations, allocatedBytes - bytes, ms);
+}
+
+// Short names fit in the small-string buffer; long ones allocate for every
+// copy. Usage: quadruple_bench [operators per expression] [expressions]
+int main(int argc, char** argv) {
+    size_t operators = argc > 1 ? stoul(argv[1]) : 200000;
+    int expressions = argc > 2 ? stoi(argv[2]) : 10;
+
+    for (string prefix : {"x", "instrument_price_"}) {
+        mt19937 rng(11);
+        vector<string> inputs(expressions);
+        size_t bytes = 0;
+        for (auto& expr : inputs) {
+            appendExpression(expr, rng, operators, 0, prefix);
+            bytes += expr.size();
+        }
+
+        cout << expressions << " expressions, " << operators << " operators and "
+             << bytes / expressions << " bytes each, variables named " << prefix << "N" << endl;
+        compareGenerators(inputs);
+        cout << endl;
+    }
+
+    // Parallel driver: many formula-sized expressions, one generator per worker
+    mt19937 rng(5);
+    vector<string> batch(200000);
+    size_t batchBytes = 0;
+    for (auto& expr : batch) {
+        appendExpression(expr, rng, 4 + rng() % 28, 0, "x");
+        batchBytes += expr.size();
+    }
+    cout << "Batch of " << batch.size() << " expressions, " << batchBytes / batch.size() << " bytes each" << endl;
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        auto start = steady_clock::now();
+        vector<Translation> results = generateBatch(batch, threads);
+        double ms = duration<double, milli>(steady_clock::now() - start).count();
+        size_t quads = 0, errors = 0;
+        for (const auto& result : results) {
+            quads += result.program.code.size();
+            errors += !result.status.ok;
+        }
+        cout << "  " << setw(3) << threads << " threads: " << fixed << setprecision(1) << setw(8) << ms << " ms, "
+             << quads << " quadruples, " << errors << " errors" << endl;
+    }
+    cout << endl;
+
+    cout << "sizeof(Quadruple): " << sizeof(legacy::Quadruple) << " bytes before, "
+         << sizeof(Quadruple) << " bytes after" << endl;
+    return 0;
+}
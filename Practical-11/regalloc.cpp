@@ -0,0 +1,145 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include "bytecode.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to build a long flat expression: a1 op a2 op ... with * and / mixed in
+string flatExpression(mt19937& rng, int operators) {
+    const char* ops = "+-*/";
+    string expr = "a0";
+    for (int i = 1; i <= operators; i++) {
+        expr += ops[rng() % 4];
+        expr += "a" + to_string(rng() % 16);
+    }
+    return expr;
+}
+
+// Function to build a random expression with parentheses nested up to maxDepth
+void appendNested(string& out, mt19937& rng, int& operators, int depth, int maxDepth) {
+    const char* ops = "+-*/";
+    int terms = 1 + rng() % 4;
+    for (int i = 0; i < terms && (i == 0 || operators > 0); i++) {
+        if (i > 0) {
+            out += ops[rng() % 4];
+            operators--;
+        }
+        if (depth < maxDepth && rng() % 3 == 0) {
+            out += '(';
+            appendNested(out, rng, operators, depth + 1, maxDepth);
+            out += ')';
+        } else {
+            out += "a" + to_string(rng() % 16);
+        }
+    }
+}
+
+string nestedExpression(mt19937& rng, int operators, int maxDepth) {
+    string expr;
+    while (operators > 0) {
+        if (!expr.empty()) {
+            expr += '+';
+            operators--;
+        }
+        expr += '(';
+        appendNested(expr, rng, operators, 1, maxDepth);
+        expr += ')';
+    }
+    return expr;
+}
+
+// Function to build a right-leaning chain a-(a*(a-(...))), where every pending
+// left operand stays live until the innermost term is done
+string rightNestedExpression(int depth) {
+    string expr;
+    for (int i = 0; i < depth; i++) expr += "a" + to_string(i % 16) + "*b-(";
+    expr += "c";
+    expr += string(depth, ')');
+    return expr;
+}
+
+// Function to time evaluating a compiled program for many input rows, taking
+// the best of several repetitions
+double nanosecondsPerRun(const Bytecode& bytecode, int runs, double& checksum) {
+    vector<double> values(bytecode.variables.size());
+    BytecodeEvaluator evaluator(bytecode);
+    double best = 1e300;
+    for (int repetition = 0; repetition < 5; repetition++) {
+        checksum = 0;
+        auto start = steady_clock::now();
+        for (int run = 0; run < runs; run++) {
+            for (size_t v = 0; v < values.size(); v++) values[v] = 1.0 + (run + v) % 7 * 0.125;
+            checksum += evaluator.run(values.data());
+        }
+        best = min(best, duration<double, nano>(steady_clock::now() - start).count() / runs);
+    }
+    return best;
+}
+
+int main() {
+    // Small example with two registers
+    QuadrupleGenerator generator;
+    generator.generate("(a + b) * (c - d) - (e * f + g / h)");
+    TempAllocation small = allocateTemps(generator.program(), 2);
+    cout << "Expression: (a + b) * (c - d) - (e * f + g / h)" << endl;
+    printQuadruples(generator.program());
+    cout << "With 2 registers (max live " << small.maxLive << "):" << endl;
+    printAllocatedQuadruples(generator.program(), small);
+    cout << "Result in " << allocatedOperandToString(generator.program(), small, generator.program().result) << endl;
+    cout << "---------------------------\n";
+
+    mt19937 rng(9);
+    vector<pair<string, string>> cases = {
+        {"flat 10k", flatExpression(rng, 10000)},
+        {"nested 10k, depth 8", nestedExpression(rng, 10000, 8)},
+        {"nested 10k, depth 40", nestedExpression(rng, 10000, 40)},
+        {"right-nested 900", rightNestedExpression(900)},
+    };
+
+    cout << left << setw(22) << "Expression" << right << setw(8) << "Temps" << setw(9) << "MaxLive"
+         << setw(6) << "K" << setw(7) << "Regs" << setw(9) << "Spilled" << setw(7) << "Slots"
+         << setw(10) << "Alloc us" << setw(12) << "Eval ns" << setw(10) << "Match" << endl;
+
+    for (const auto& [name, expr] : cases) {
+        GenerateResult status = generator.generate(expr);
+        if (!status.ok) {
+            cout << name << ": " << status.error << endl;
+            continue;
+        }
+        const QuadrupleProgram& program = generator.program();
+
+        Bytecode unallocated;
+        compileQuadruples(program, unallocated);
+        const int runs = 200;
+        double expected = 0;
+        double baseNs = nanosecondsPerRun(unallocated, runs, expected);
+        cout << left << setw(22) << name << right << setw(8) << program.code.size() << setw(9) << "-"
+             << setw(6) << "-" << setw(7) << program.code.size() << setw(9) << 0 << setw(7) << 0
+             << setw(10) << "-" << setw(12) << fixed << setprecision(0) << baseNs << setw(10) << "-" << endl;
+
+        for (int k : {4, 8, 16}) {
+            auto start = steady_clock::now();
+            TempAllocation allocation = allocateTemps(program, k);
+            double allocUs = duration<double, micro>(steady_clock::now() - start).count();
+
+            Bytecode allocated;
+            compileQuadruples(program, allocated, &allocation);
+            double checksum = 0;
+            double ns = nanosecondsPerRun(allocated, runs, checksum);
+            bool match = checksum == expected || (isnan(checksum) && isnan(expected));
+
+            cout << left << setw(22) << "" << right << setw(8) << program.code.size() << setw(9) << allocation.maxLive
+                 << setw(6) << k << setw(7) << allocation.numRegisters << setw(9) << allocation.spilledTemps
+                 << setw(7) << allocation.numSpillSlots << setw(10) << setprecision(0) << allocUs
+                 << setw(12) << ns << setw(10) << (match ? "yes" : "NO") << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include <vector>
+#include <algorithm>
+#include "quadruple.h"
+
+using namespace std;
+
+// Liveness analysis and linear-scan allocation of temporaries onto a fixed
+// number of registers, with spill slots for whatever does not fit. Temporaries
+// must be numbered t1, t2, ... in instruction order, as QuadrupleGenerator
+// and the optimizer passes leave them.
+
+// Structure to hold the live range of temporary t(i + 1): defined by
+// quadruple start, last read by quadruple end (code.size() if it is the result)
+struct LiveInterval {
+    int start;
+    int end;
+};
+
+// Function to compute the live interval of every temporary
+inline vector<LiveInterval> computeLiveIntervals(const QuadrupleProgram& program) {
+    int n = (int)program.code.size();
+    vector<LiveInterval> intervals(n);
+    for (int i = 0; i < n; i++) intervals[i] = {i, i};
+
+    auto use = [&](Operand operand, int at) {
+        if (operand.kind() == OPERAND_TEMP) intervals[operand.index() - 1].end = at;
+    };
+    for (int i = 0; i < n; i++) {
+        use(program.code[i].arg1, i);
+        use(program.code[i].arg2, i);
+    }
+    use(program.result, n);
+    return intervals;
+}
+
+// Function to find the most temporaries live across any one instruction
+inline int maxLiveTemps(const vector<LiveInterval>& intervals) {
+    // Interval i holds its value from the end of quadruple start up to the read
+    // at quadruple end, so it counts as live at points start+1 .. end
+    int n = (int)intervals.size();
+    vector<int> delta(n + 2, 0);
+    for (const auto& interval : intervals) {
+        if (interval.end > interval.start) {
+            delta[interval.start + 1]++;
+            delta[interval.end + 1]--;
+        }
+    }
+    int live = 0, maxLive = 0;
+    for (int point = 0; point <= n; point++) {
+        live += delta[point];
+        maxLive = max(maxLive, live);
+    }
+    return maxLive;
+}
+
+// Structure to say where a temporary lives
+struct TempLocation {
+    bool spilled;
+    int index;  // Register number, or spill slot number when spilled
+};
+
+// Structure to hold the result of register allocation
+struct TempAllocation {
+    vector<TempLocation> location;  // location[i] is where t(i + 1) lives
+    int numRegisters = 0;           // Registers actually used
+    int numSpillSlots = 0;
+    int spilledTemps = 0;
+    int maxLive = 0;
+
+    // Slot in a flat file of numRegisters registers followed by the spill slots
+    int slotOf(Operand temp) const {
+        const TempLocation& at = location[temp.index() - 1];
+        return at.spilled ? numRegisters + at.index : at.index;
+    }
+};
+
+// Function to allocate temporaries to at most maxRegisters registers
+// (Poletto and Sarkar's linear scan). A register is freed at the last read of
+// its value, so an instruction may write its result over one of its operands.
+// When every register is taken, the interval that ends last is spilled for its
+// whole lifetime; spilled intervals then share slots the same way.
+inline TempAllocation allocateTemps(const QuadrupleProgram& program, int maxRegisters) {
+    vector<LiveInterval> intervals = computeLiveIntervals(program);
+    int n = (int)intervals.size();
+    TempAllocation allocation;
+    allocation.location.assign(n, {false, -1});
+    allocation.maxLive = maxLiveTemps(intervals);
+
+    vector<int> active;  // Temps holding a register, sorted by increasing end
+    vector<int> freeRegisters;
+    for (int r = maxRegisters - 1; r >= 0; r--) freeRegisters.push_back(r);
+    vector<int> spilled;
+    auto byEnd = [&](int a, int b) { return intervals[a].end < intervals[b].end; };
+
+    // Intervals start in temp order, so no sort is needed
+    for (int t = 0; t < n; t++) {
+        size_t expired = 0;
+        while (expired < active.size() && intervals[active[expired]].end <= intervals[t].start) {
+            freeRegisters.push_back(allocation.location[active[expired]].index);
+            expired++;
+        }
+        active.erase(active.begin(), active.begin() + expired);
+
+        int victim = t;
+        if (freeRegisters.empty() && !active.empty() && intervals[active.back()].end > intervals[t].end) {
+            // Take the register of the interval that ends last and spill that one instead
+            victim = active.back();
+            active.pop_back();
+            freeRegisters.push_back(allocation.location[victim].index);
+        }
+        if (!freeRegisters.empty()) {
+            allocation.location[t] = {false, freeRegisters.back()};
+            freeRegisters.pop_back();
+            allocation.numRegisters = max(allocation.numRegisters, allocation.location[t].index + 1);
+            active.insert(upper_bound(active.begin(), active.end(), t, byEnd), t);
+            if (victim == t) continue;
+        }
+        allocation.location[victim] = {true, -1};
+        spilled.push_back(victim);
+    }
+
+    // Second scan: give spilled intervals the lowest slot that is free again
+    sort(spilled.begin(), spilled.end());
+    allocation.spilledTemps = (int)spilled.size();
+    vector<int> slotFreeAt;  // Point at which each slot's last value is dead
+    for (int t : spilled) {
+        int slot = 0;
+        while (slot < (int)slotFreeAt.size() && slotFreeAt[slot] > intervals[t].start) slot++;
+        if (slot == (int)slotFreeAt.size()) slotFreeAt.push_back(0);
+        slotFreeAt[slot] = intervals[t].end;
+        allocation.location[t].index = slot;
+    }
+    allocation.numSpillSlots = (int)slotFreeAt.size();
+    return allocation;
+}
+
+// Function to render where an operand lives after allocation
+inline string allocatedOperandToString(const QuadrupleProgram& program, const TempAllocation& allocation,
+                                       Operand operand) {
+    if (operand.kind() != OPERAND_TEMP) return program.operandToString(operand);
+    const TempLocation& at = allocation.location[operand.index() - 1];
+    return (at.spilled ? "s" : "r") + to_string(at.index);
+}
+
+// Function to print the quadruple table with registers in place of temporaries
+inline void printAllocatedQuadruples(const QuadrupleProgram& program, const TempAllocation& allocation) {
+    cout << "Operator\tOperand 1\tOperand 2\tResult" << endl;
+    for (const auto& quad : program.code) {
+        cout << opToChar(quad.op) << "\t" << allocatedOperandToString(program, allocation, quad.arg1) << "\t"
+             << allocatedOperandToString(program, allocation, quad.arg2) << "\t"
+             << allocatedOperandToString(program, allocation, quad.result) << endl;
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include "expression.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to build a generated formula that reuses subexpressions: each level
+// draws its entries from the level below, and the formula sums draws from the
+// top level, so the same text appears many times
+string repeatedFormula(mt19937& rng, int levels, int poolSize, int terms) {
+    const char* ops = "+-*/";
+    vector<string> pool;
+    for (int i = 0; i < poolSize; i++) {
+        pool.push_back("v" + to_string(rng() % 16) + " " + ops[rng() % 4] + " " + to_string(1 + rng() % 9));
+    }
+    for (int level = 1; level < levels; level++) {
+        vector<string> next;
+        for (int i = 0; i < poolSize; i++) {
+            string expr = "(" + pool[rng() % poolSize] + ")";
+            for (int j = 0; j < 2; j++) {
+                expr += string(" ") + ops[rng() % 3] + " (" + pool[rng() % poolSize] + ")";
+            }
+            next.push_back(expr);
+        }
+        pool = move(next);
+    }
+    string formula;
+    for (int i = 0; i < terms; i++) {
+        if (i > 0) formula += " + ";
+        formula += "(" + pool[rng() % poolSize] + ")";
+    }
+    return formula;
+}
+
+// Usage: dag_bench [input sets]
+int main(int argc, char** argv) {
+    int inputSets = argc > 1 ? stoi(argv[1]) : 200;
+
+    // Small example: the repeated (a + b) * c is built once
+    const string example = "(a + b) * c + (b + a) * c - ((a + b) * c) / 2";
+    ExpressionArena shared(true);
+    ExpressionParser exampleParser(shared);
+    ParseResult parsed = exampleParser.parse(example);
+    SharingStats stats = sharingStats(shared, parsed.root);
+    cout << "Expression: " << example << endl;
+    cout << "Tree nodes: " << stats.treeNodes << ", DAG nodes: " << stats.uniqueNodes
+         << ", sharing ratio: " << stats.sharingRatio << endl;
+    vector<double> exampleValues = {2, 3, 4}, nodeValues;
+    evaluateArena(shared, exampleValues, nodeValues);
+    cout << "With a=2, b=3, c=4: " << nodeValues[parsed.root] << endl << endl;
+
+    cout << inputSets << " input sets per formula" << endl;
+    cout << left << setw(16) << "Formula" << right << setw(10) << "Chars" << setw(10) << "Tree" << setw(9) << "DAG"
+         << setw(9) << "Ratio" << setw(10) << "Tree KB" << setw(9) << "DAG KB" << setw(12) << "Tree parse"
+         << setw(11) << "DAG parse" << setw(10) << "Tree us" << setw(9) << "DAG us" << setw(9) << "Speedup"
+         << setw(7) << "Match" << endl;
+
+    mt19937 rng(38);
+    struct Case {
+        const char* name;
+        int levels, poolSize, terms;
+    };
+    for (Case c : {Case{"1 level", 1, 4000, 4000}, Case{"2 levels", 2, 64, 1000},
+                   Case{"3 levels", 3, 32, 1000}, Case{"4 levels", 4, 16, 1000}}) {
+        string formula = repeatedFormula(rng, c.levels, c.poolSize, c.terms);
+
+        ExpressionArena tree;
+        ExpressionParser treeParser(tree);
+        auto start = steady_clock::now();
+        ParseResult treeRoot = treeParser.parse(formula);
+        double treeParseMs = duration<double, milli>(steady_clock::now() - start).count();
+
+        ExpressionArena dag(true);
+        ExpressionParser dagParser(dag);
+        start = steady_clock::now();
+        ParseResult dagRoot = dagParser.parse(formula);
+        double dagParseMs = duration<double, milli>(steady_clock::now() - start).count();
+        if (!treeRoot.ok || !dagRoot.ok) {
+            cout << c.name << ": " << treeRoot.error << endl;
+            continue;
+        }
+        SharingStats sharing = sharingStats(dag, dagRoot.root);
+
+        // Both arenas intern names in first-use order, so the inputs line up
+        vector<vector<double>> inputs(inputSets, vector<double>(tree.names.size()));
+        uniform_real_distribution<double> dist(1.0, 10.0);
+        for (auto& input : inputs) {
+            for (double& value : input) value = dist(rng);
+        }
+
+        vector<double> treeOut(inputSets), dagOut(inputSets);
+        start = steady_clock::now();
+        for (int i = 0; i < inputSets; i++) treeOut[i] = evaluateNode(tree, treeRoot.root, inputs[i]);
+        double treeUs = duration<double, micro>(steady_clock::now() - start).count() / inputSets;
+
+        vector<double> values;
+        start = steady_clock::now();
+        for (int i = 0; i < inputSets; i++) {
+            evaluateArena(dag, inputs[i], values);
+            dagOut[i] = values[dagRoot.root];
+        }
+        double dagUs = duration<double, micro>(steady_clock::now() - start).count() / inputSets;
+
+        // Reordering the operands of + and * is exact, so results match bit for bit
+        bool match = true;
+        for (int i = 0; i < inputSets; i++) {
+            if (treeOut[i] != dagOut[i] && !(isnan(treeOut[i]) && isnan(dagOut[i]))) match = false;
+        }
+
+        cout << left << setw(16) << c.name << right << setw(10) << formula.size() << setw(10) << tree.size()
+             << setw(9) << dag.size() << fixed << setprecision(1) << setw(9) << sharing.sharingRatio
+             << setw(10) << tree.memoryBytes() / 1024.0 << setw(9) << dag.memoryBytes() / 1024.0
+             << setw(12) << treeParseMs << setw(11) << dagParseMs << setw(10) << treeUs << setw(9) << dagUs
+             << setw(8) << treeUs / dagUs << "x" << setw(7) << (match ? "yes" : "NO") << defaultfloat << endl;
+    }
+
+    return 0;
+}
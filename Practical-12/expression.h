@@ -0,0 +1,547 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cctype>
+#include <cstdint>
+#include <cmath>
+#include <charconv>
+#include <algorithm>
+#include <cstring>
+#include "../Practical-11/literal.h"
+#include "../Practical-11/descent.h"
+
+using namespace std;
+
+// Expression nodes live in a flat arena and refer to their children by index.
+// The grammar is the usual one with unary minus:
+//   E : E '+' T | E '-' T | T
+//   T : T '*' U | T '/' U | U
+//   U : '-' U | F
+//   F : '(' E ')' | number | identifier
+
+// Node operators; binary operators use their own character
+const char NODE_NUMBER = 'n';
+const char NODE_VARIABLE = 'v';
+const char NODE_NEGATE = '~';
+
+// Structure to represent one node
+struct ExprNode {
+    char op;        // NODE_NUMBER, NODE_VARIABLE, NODE_NEGATE or one of + - * /
+    double value;   // NODE_NUMBER
+    uint32_t name;  // NODE_VARIABLE, index into ExpressionArena::names
+    int left;       // Operand of NODE_NEGATE, or left child
+    int right;
+};
+
+// Structure to hold the outcome of parsing
+struct ParseResult {
+    bool ok;
+    int root;           // Index of the root node
+    const char* error;  // Static message, nullptr when ok
+    size_t position;    // Offset of the error in the expression
+};
+
+// Structure to key a node by its contents for hash-consing
+struct NodeKey {
+    char op;
+    uint64_t payload;  // Bits of the value, or the variable's name index
+    int left;
+    int right;
+    bool operator==(const NodeKey& other) const {
+        return op == other.op && payload == other.payload && left == other.left && right == other.right;
+    }
+};
+
+struct NodeKeyHash {
+    size_t operator()(const NodeKey& key) const {
+        size_t h = key.payload * 0x9E3779B97F4A7C15ull;
+        h ^= ((size_t)(uint32_t)key.left << 32 | (uint32_t)key.right) * 0xC2B2AE3D27D4EB4Full;
+        return h ^ (h >> 29) ^ (size_t)key.op;
+    }
+};
+
+// Nodes are appended after their children, so index order is a topological
+// order. With sharing on, structurally equal nodes are created once (hash-
+// consing) and the arena is a DAG; the operands of + and * are put in index
+// order first so a + b and b + a are the same node.
+class ExpressionArena {
+public:
+    vector<ExprNode> nodes;
+    vector<string> names;
+    unordered_map<string, uint32_t> nameIndex;
+    bool shareNodes;
+    unordered_map<NodeKey, int, NodeKeyHash> uniqueNodes;
+
+    explicit ExpressionArena(bool share = false) : shareNodes(share) {}
+
+    int number(double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return add({NODE_NUMBER, value, 0, -1, -1}, bits);
+    }
+
+    int variable(string_view name) {
+        auto it = nameIndex.find(string(name));
+        uint32_t index;
+        if (it != nameIndex.end()) {
+            index = it->second;
+        } else {
+            index = (uint32_t)names.size();
+            names.push_back(string(name));
+            nameIndex[names.back()] = index;
+        }
+        return add({NODE_VARIABLE, 0, index, -1, -1}, index);
+    }
+
+    int unary(int operand) {
+        return add({NODE_NEGATE, 0, 0, operand, -1}, 0);
+    }
+
+    int binary(char op, int left, int right) {
+        if (shareNodes && (op == '+' || op == '*') && left > right) swap(left, right);
+        return add({op, 0, 0, left, right}, 0);
+    }
+
+    const ExprNode& operator[](int node) const { return nodes[node]; }
+    size_t size() const { return nodes.size(); }
+
+    void clear() {
+        nodes.clear();
+        names.clear();
+        nameIndex.clear();
+        uniqueNodes.clear();
+    }
+
+    // Approximate heap bytes held by the nodes and the sharing table
+    size_t memoryBytes() const {
+        size_t bytes = nodes.capacity() * sizeof(ExprNode);
+        if (shareNodes) {
+            bytes += uniqueNodes.bucket_count() * sizeof(void*);
+            bytes += uniqueNodes.size() * (sizeof(NodeKey) + sizeof(int) + 2 * sizeof(void*));
+        }
+        return bytes;
+    }
+
+private:
+    int add(const ExprNode& node, uint64_t payload) {
+        if (shareNodes) {
+            auto [it, inserted] = uniqueNodes.insert({{node.op, payload, node.left, node.right}, (int)nodes.size()});
+            if (!inserted) return it->second;
+        }
+        nodes.push_back(node);
+        return (int)nodes.size() - 1;
+    }
+};
+
+// Recursive-descent parser that builds nodes into an arena
+// (any whitespace, newlines included, separates tokens)
+class ExpressionParser : ExpressionScanner {
+    ExpressionArena& arena;
+
+public:
+    explicit ExpressionParser(ExpressionArena& a) : ExpressionScanner(true), arena(a) {}
+
+    ParseResult parse(const char* text, size_t length) {
+        start(text, length);
+        int root = parseExpression();
+        finish();
+
+        if (error) return {false, -1, error, errorPosition()};
+        return {true, root, nullptr, 0};
+    }
+
+    ParseResult parse(const string& expr) {
+        return parse(expr.data(), expr.size());
+    }
+
+private:
+    int parseExpression() {
+        int result = parseTerm();
+        while (!error) {
+            char op = peek();
+            if (op != '+' && op != '-') break;
+            cur++;
+            int operand = parseTerm();
+            result = arena.binary(op, result, operand);
+        }
+        return result;
+    }
+
+    int parseTerm() {
+        int result = parseUnary();
+        while (!error) {
+            char op = peek();
+            if (op != '*' && op != '/') break;
+            cur++;
+            int operand = parseUnary();
+            result = arena.binary(op, result, operand);
+        }
+        return result;
+    }
+
+    int parseUnary() {
+        if (peek() != '-') return parseFactor();
+        cur++;
+        if (!enterNesting()) return -1;
+        int operand = parseUnary();
+        leaveNesting();
+        return arena.unary(operand);
+    }
+
+    int parseFactor() {
+        char c = peek();
+        const char* start = cur;
+        if (c == '(') {
+            if (!enterNesting()) return -1;
+            cur++;
+            int result = parseExpression();
+            if (error) return -1;
+            if (peek() != ')') {
+                fail("Expected closing parenthesis");
+                return -1;
+            }
+            cur++;
+            leaveNesting();
+            return result;
+        }
+        if (isdigit((unsigned char)c) || c == '.') {
+            NumericLiteral literal;
+            const char* next = scanNumber(cur, end, literal);
+            if (literal.error) {
+                fail(literal.error);
+                return -1;
+            }
+            cur = next;
+            return arena.number(literal.value);
+        }
+        if (isalpha((unsigned char)c) || c == '_') {
+            while (cur < end && (isalnum((unsigned char)*cur) || *cur == '_')) cur++;
+            return arena.variable(string_view(start, cur - start));
+        }
+        fail(c == '\0' ? "Unexpected end of expression" : "Invalid character");
+        return -1;
+    }
+};
+
+// Function to evaluate a node; variables[i] is the value of arena.names[i]
+inline double evaluateNode(const ExpressionArena& arena, int node, const vector<double>& variables) {
+    const ExprNode& n = arena[node];
+    switch (n.op) {
+        case NODE_NUMBER: return n.value;
+        case NODE_VARIABLE: return variables[n.name];
+        case NODE_NEGATE: return -evaluateNode(arena, n.left, variables);
+        default: break;
+    }
+    double a = evaluateNode(arena, n.left, variables);
+    double b = evaluateNode(arena, n.right, variables);
+    switch (n.op) {
+        case '+': return a + b;
+        case '-': return a - b;
+        case '*': return a * b;
+        default: return a / b;
+    }
+}
+
+// Function to evaluate every node of the arena in one sweep in index order;
+// values[i] receives the value of node i, so each shared node is computed once
+inline void evaluateArena(const ExpressionArena& arena, const vector<double>& variables, vector<double>& values) {
+    values.resize(arena.size());
+    const ExprNode* nodes = arena.nodes.data();
+    double* v = values.data();
+    for (size_t i = 0; i < arena.size(); i++) {
+        const ExprNode& n = nodes[i];
+        switch (n.op) {
+            case NODE_NUMBER: v[i] = n.value; break;
+            case NODE_VARIABLE: v[i] = variables[n.name]; break;
+            case NODE_NEGATE: v[i] = -v[n.left]; break;
+            case '+': v[i] = v[n.left] + v[n.right]; break;
+            case '-': v[i] = v[n.left] - v[n.right]; break;
+            case '*': v[i] = v[n.left] * v[n.right]; break;
+            default: v[i] = v[n.left] / v[n.right]; break;
+        }
+    }
+}
+
+// Structure to describe how much a DAG shares
+struct SharingStats {
+    size_t uniqueNodes;  // Nodes reachable from the root
+    double treeNodes;    // Nodes the same expression needs as a tree
+    double sharingRatio; // treeNodes / uniqueNodes
+};
+
+// Function to measure sharing below a root with one sweep over the arena
+inline SharingStats sharingStats(const ExpressionArena& arena, int root) {
+    vector<char> reachable(arena.size(), 0);
+    reachable[root] = 1;
+    for (size_t i = arena.size(); i-- > 0;) {
+        if (!reachable[i]) continue;
+        const ExprNode& n = arena[(int)i];
+        if (n.left >= 0) reachable[n.left] = 1;
+        if (n.right >= 0) reachable[n.right] = 1;
+    }
+
+    vector<double> treeSize(arena.size(), 0);
+    size_t unique = 0;
+    for (size_t i = 0; i < arena.size(); i++) {
+        if (!reachable[i]) continue;
+        const ExprNode& n = arena[(int)i];
+        treeSize[i] = 1 + (n.left >= 0 ? treeSize[n.left] : 0) + (n.right >= 0 ? treeSize[n.right] : 0);
+        unique++;
+    }
+    return {unique, treeSize[root], treeSize[root] / unique};
+}
+
+// Operator precedence for printing
+inline int precedence(char op) {
+    switch (op) {
+        case '+': case '-': return 1;
+        case '*': case '/': return 2;
+        case NODE_NEGATE: return 3;
+        default: return 4;
+    }
+}
+
+// Function to format a number with the fewest digits that read back exactly
+inline string formatNumber(double value) {
+    char buffer[32];
+    auto [last, ec] = to_chars(buffer, buffer + sizeof(buffer), value);
+    return string(buffer, ec == errc() ? last - buffer : 0);
+}
+
+// Function to print a node with only the parentheses that are needed
+inline void appendNode(const ExpressionArena& arena, int node, string& out) {
+    const ExprNode& n = arena[node];
+    auto child = [&](int c, bool parenthesize) {
+        if (parenthesize) out += '(';
+        appendNode(arena, c, out);
+        if (parenthesize) out += ')';
+    };
+    switch (n.op) {
+        case NODE_NUMBER: out += formatNumber(n.value); return;
+        case NODE_VARIABLE: out += arena.names[n.name]; return;
+        case NODE_NEGATE:
+            out += '-';
+            child(n.left, precedence(arena[n.left].op) < precedence(NODE_NEGATE) || arena[n.left].op == NODE_NEGATE ||
+                          (arena[n.left].op == NODE_NUMBER && arena[n.left].value < 0));
+            return;
+        default: break;
+    }
+    int p = precedence(n.op);
+    // The left operand needs parentheses only when it binds more loosely; the
+    // right one also when it is at the same level under - or /
+    child(n.left, precedence(arena[n.left].op) < p);
+    out += ' ';
+    out += n.op;
+    out += ' ';
+    int rightPrecedence = precedence(arena[n.right].op);
+    bool rightNegative = arena[n.right].op == NODE_NUMBER && arena[n.right].value < 0;
+    child(n.right, rightPrecedence < p || (rightPrecedence == p && (n.op == '-' || n.op == '/')) || rightNegative);
+}
+
+inline string nodeToString(const ExpressionArena& arena, int node) {
+    string out;
+    appendNode(arena, node, out);
+    return out;
+}
+
+// Constant folding with reassociation. Chains of + and - are flattened into
+// signed terms and chains of * and / into numerator and denominator factors,
+// so constants anywhere in a chain are combined: 2 * x * 3 becomes 6 * x and
+// x + 3 * 5 - 2 becomes x + 13. Like -ffast-math this regroups floating-point
+// operations, so results can differ from the original in the last bits.
+// Division by a constant zero is left in place.
+class ConstantFolder {
+    ExpressionArena& arena;
+    vector<int> foldedOf;  // Memo so shared nodes of a DAG fold once
+
+    struct Term {
+        bool negative;  // Subtracted term, or denominator factor
+        int node;
+    };
+
+public:
+    explicit ConstantFolder(ExpressionArena& a) : arena(a) {}
+
+    // Function to fold a tree, adding the result's nodes to the same arena
+    int fold(int node) {
+        const ExprNode n = arena[node];
+        if (n.op == NODE_NUMBER || n.op == NODE_VARIABLE) return node;
+        if ((size_t)node < foldedOf.size() && foldedOf[node] >= 0) return foldedOf[node];
+        int folded;
+        if (n.op == '+' || n.op == '-' || (n.op == NODE_NEGATE && !isProduct(arena[n.left].op))) {
+            folded = foldSum(node);
+        } else {
+            folded = foldProduct(node);
+        }
+        if ((size_t)node >= foldedOf.size()) foldedOf.resize(arena.size(), -1);
+        foldedOf[node] = folded;
+        return folded;
+    }
+
+private:
+    static bool isProduct(char op) { return op == '*' || op == '/'; }
+
+    // Function to flatten + and - (and negation) into signed terms
+    void collectTerms(int node, bool negative, vector<Term>& terms, double& constant) {
+        // Walk the left spine in a loop so long chains do not recurse, then
+        // take the right operands in source order
+        vector<pair<int, bool>> pending;
+        while (true) {
+            const ExprNode n = arena[node];
+            if (n.op == '+' || n.op == '-') {
+                pending.push_back({n.right, negative != (n.op == '-')});
+                node = n.left;
+            } else if (n.op == NODE_NEGATE && !isProduct(arena[n.left].op)) {
+                negative = !negative;
+                node = n.left;
+            } else {
+                break;
+            }
+        }
+        addTerm(node, negative, terms, constant);
+        for (size_t i = pending.size(); i-- > 0;) addTerm(pending[i].first, pending[i].second, terms, constant);
+    }
+
+    void addTerm(int node, bool negative, vector<Term>& terms, double& constant) {
+        const ExprNode n = arena[node];
+        if (n.op == '+' || n.op == '-' || (n.op == NODE_NEGATE && !isProduct(arena[n.left].op))) {
+            collectTerms(node, negative, terms, constant);
+            return;
+        }
+        int folded = fold(node);
+        const ExprNode& f = arena[folded];
+        if (f.op == NODE_NUMBER) {
+            constant += negative ? -f.value : f.value;
+        } else if (f.op == '+' || f.op == '-' || f.op == NODE_NEGATE) {
+            collectTerms(folded, negative, terms, constant);  // Already folded, so only flattens
+        } else {
+            int stripped;
+            if (stripSign(folded, stripped)) terms.push_back({!negative, stripped});
+            else terms.push_back({negative, folded});
+        }
+    }
+
+    int foldSum(int node) {
+        vector<Term> terms;
+        double constant = 0;
+        collectTerms(node, false, terms, constant);
+        if (terms.empty()) return arena.number(constant);
+
+        // Lead with a positive term when there is one so no negation is needed
+        for (size_t i = 0; i < terms.size(); i++) {
+            if (!terms[i].negative) {
+                rotate(terms.begin(), terms.begin() + i, terms.begin() + i + 1);
+                break;
+            }
+        }
+
+        int result;
+        if (!terms[0].negative) {
+            result = terms[0].node;
+        } else if (constant != 0) {
+            result = arena.binary('-', arena.number(constant), terms[0].node);
+            constant = 0;
+        } else {
+            result = arena.unary(terms[0].node);
+        }
+        for (size_t i = 1; i < terms.size(); i++) {
+            result = arena.binary(terms[i].negative ? '-' : '+', result, terms[i].node);
+        }
+        if (constant > 0) result = arena.binary('+', result, arena.number(constant));
+        if (constant < 0) result = arena.binary('-', result, arena.number(-constant));
+        return result;
+    }
+
+    // Function to flatten * and / (and negation, as a factor of -1) into factors
+    void collectFactors(int node, bool inverted, vector<Term>& factors, double& numerator, double& denominator) {
+        vector<pair<int, bool>> pending;
+        while (true) {
+            const ExprNode n = arena[node];
+            if (isProduct(n.op)) {
+                pending.push_back({n.right, inverted != (n.op == '/')});
+                node = n.left;
+            } else if (n.op == NODE_NEGATE) {
+                numerator = -numerator;
+                node = n.left;
+            } else {
+                break;
+            }
+        }
+        addFactor(node, inverted, factors, numerator, denominator);
+        for (size_t i = pending.size(); i-- > 0;) {
+            addFactor(pending[i].first, pending[i].second, factors, numerator, denominator);
+        }
+    }
+
+    void addFactor(int node, bool inverted, vector<Term>& factors, double& numerator, double& denominator) {
+        const ExprNode n = arena[node];
+        if (isProduct(n.op) || n.op == NODE_NEGATE) {
+            collectFactors(node, inverted, factors, numerator, denominator);
+            return;
+        }
+        int folded = fold(node);
+        const ExprNode& f = arena[folded];
+        if (f.op == NODE_NUMBER && !(inverted && f.value == 0)) {
+            if (inverted) denominator *= f.value;
+            else numerator *= f.value;
+        } else if (isProduct(f.op) || f.op == NODE_NEGATE) {
+            collectFactors(folded, inverted, factors, numerator, denominator);
+        } else {
+            factors.push_back({inverted, folded});
+        }
+    }
+
+    int foldProduct(int node) {
+        vector<Term> factors;
+        double numerator = 1, denominator = 1;
+        collectFactors(node, false, factors, numerator, denominator);
+        double coefficient = numerator / denominator;
+
+        // Numerator factors first, then the divisions
+        stable_partition(factors.begin(), factors.end(), [](const Term& t) { return !t.negative; });
+        size_t i = 0;
+        int result;
+        if (factors.empty() || factors[0].negative) {
+            result = arena.number(coefficient);  // 15, 2 / x
+        } else {
+            // Only divisions by constants print as x / 8 rather than 0.125 * x
+            bool divideByConstant = fabs(numerator) == 1 && fabs(denominator) != 1;
+            int first = factors[i++].node;
+            if (fabs(coefficient) != 1 && !divideByConstant) {
+                result = arena.binary('*', arena.number(coefficient), first);  // 6 * x
+            } else {
+                result = coefficient < 0 ? arena.unary(first) : first;
+            }
+            for (; i < factors.size() && !factors[i].negative; i++) result = arena.binary('*', result, factors[i].node);
+            if (divideByConstant) result = arena.binary('/', result, arena.number(fabs(denominator)));
+        }
+        for (; i < factors.size(); i++) result = arena.binary('/', result, factors[i].node);
+        return result;
+    }
+
+    // Function to strip a leading minus from a folded product, so that a sum
+    // prints a - 6 * x rather than a + -6 * x
+    bool stripSign(int node, int& stripped) {
+        const ExprNode n = arena[node];
+        if (n.op == NODE_NEGATE) {
+            stripped = n.left;
+            return true;
+        }
+        if (n.op == NODE_NUMBER && n.value < 0) {
+            stripped = arena.number(-n.value);
+            return true;
+        }
+        int left;
+        if (isProduct(n.op) && stripSign(n.left, left)) {
+            stripped = arena.binary(n.op, left, n.right);
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif
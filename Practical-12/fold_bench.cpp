@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include "expression.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to generate a random expression mixing constants and variables.
+// constantShare is the chance (out of 100) that a leaf is a number.
+void appendExpression(string& out, mt19937& rng, int& operators, int depth, int constantShare, int variables) {
+    const char* ops = "+-*/";
+    for (int i = 0; i == 0 || (operators > 0 && rng() % 6 != 0); i++) {
+        if (i > 0) {
+            out += ' ';
+            out += ops[rng() % 4];
+            out += ' ';
+            operators--;
+        }
+        unsigned r = rng() % 100;
+        if (r < 15 && depth < 20) {
+            out += '(';
+            appendExpression(out, rng, operators, depth + 1, constantShare, variables);
+            out += ')';
+        } else if ((int)(rng() % 100) < constantShare) {
+            out += to_string(1 + rng() % 99);
+        } else {
+            out += "v" + to_string(rng() % variables);
+        }
+    }
+}
+
+// Function to count the nodes reachable from a root
+size_t countNodes(const ExpressionArena& arena, int node) {
+    const ExprNode& n = arena[node];
+    if (n.op == NODE_NUMBER || n.op == NODE_VARIABLE) return 1;
+    if (n.op == NODE_NEGATE) return 1 + countNodes(arena, n.left);
+    return 1 + countNodes(arena, n.left) + countNodes(arena, n.right);
+}
+
+// Usage: fold_bench [operators per expression] [expressions]
+int main(int argc, char** argv) {
+    int operators = argc > 1 ? stoi(argv[1]) : 20000;
+    int expressions = argc > 2 ? stoi(argv[2]) : 20;
+
+    cout << expressions << " expressions of " << operators << " operators" << endl;
+    cout << setw(10) << "Constants" << setw(12) << "Nodes in" << setw(12) << "Nodes out" << setw(12) << "Chars in"
+         << setw(12) << "Chars out" << setw(10) << "Parse ms" << setw(10) << "Fold ms" << setw(10) << "Print ms"
+         << setw(10) << "MB/s" << setw(12) << "Max rel err" << endl;
+
+    for (int constantShare : {20, 50, 80}) {
+        mt19937 rng(constantShare);
+        vector<string> inputs(expressions);
+        size_t charsIn = 0;
+        for (auto& expr : inputs) {
+            int remaining = operators;
+            while (remaining > 0) {
+                if (!expr.empty()) {
+                    expr += " + ";
+                    remaining--;
+                }
+                appendExpression(expr, rng, remaining, 0, constantShare, 32);
+            }
+            charsIn += expr.size();
+        }
+
+        double parseMs = 0, foldMs = 0, printMs = 0, maxError = 0;
+        size_t nodesIn = 0, nodesOut = 0, charsOut = 0;
+        ExpressionArena arena;
+        for (const auto& expr : inputs) {
+            arena.clear();
+            ExpressionParser parser(arena);
+            auto start = steady_clock::now();
+            ParseResult parsed = parser.parse(expr);
+            parseMs += duration<double, milli>(steady_clock::now() - start).count();
+            if (!parsed.ok) {
+                cout << "Parse error: " << parsed.error << " at " << parsed.position << endl;
+                return 1;
+            }
+
+            ConstantFolder folder(arena);
+            start = steady_clock::now();
+            int folded = folder.fold(parsed.root);
+            foldMs += duration<double, milli>(steady_clock::now() - start).count();
+
+            start = steady_clock::now();
+            string output = nodeToString(arena, folded);
+            printMs += duration<double, milli>(steady_clock::now() - start).count();
+
+            nodesIn += countNodes(arena, parsed.root);
+            nodesOut += countNodes(arena, folded);
+            charsOut += output.size();
+
+            // The printed output must parse back to the same value, up to the
+            // rounding that reassociation allows
+            ExpressionArena reparsedArena;
+            ExpressionParser reparser(reparsedArena);
+            ParseResult reparsed = reparser.parse(output);
+            vector<double> values(arena.names.size()), reparsedValues(reparsedArena.names.size());
+            for (size_t v = 0; v < values.size(); v++) values[v] = 1.0 + 0.37 * v;
+            for (size_t v = 0; v < reparsedValues.size(); v++) {
+                reparsedValues[v] = values[arena.nameIndex.at(reparsedArena.names[v])];
+            }
+            double expected = evaluateNode(arena, parsed.root, values);
+            double actual = reparsed.ok ? evaluateNode(reparsedArena, reparsed.root, reparsedValues) : NAN;
+            if (!(isinf(expected) && expected == actual)) {
+                maxError = max(maxError, fabs(actual - expected) / max(1.0, fabs(expected)));
+            }
+        }
+
+        cout << setw(9) << constantShare << "%" << setw(12) << nodesIn << setw(12) << nodesOut
+             << setw(12) << charsIn << setw(12) << charsOut << fixed << setprecision(1)
+             << setw(10) << parseMs << setw(10) << foldMs << setw(10) << printMs
+             << setw(10) << charsIn / (parseMs + foldMs + printMs) / 1e3
+             << setw(12) << scientific << setprecision(1) << maxError << defaultfloat << endl;
+    }
+
+    return 0;
+}
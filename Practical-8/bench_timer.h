@@ -0,0 +1,39 @@
+#ifndef BENCH_TIMER_H
+#define BENCH_TIMER_H
+
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+// Timing helpers for the benchmark programs. Each run is repeated three
+// times and the fastest kept, which filters out the first run's cold caches
+// and page faults and most scheduling noise.
+
+// Function to run a call that times itself (returning a result with an
+// 'ms' field) three times and keep the whole result of the fastest run, so
+// anything else it counted comes from the run that was timed
+template <typename Run>
+auto fastestOfThree(Run run) -> decltype(run()) {
+    auto best = run();
+    for (int attempt = 1; attempt < 3; attempt++) {
+        auto result = run();
+        if (result.ms < best.ms) best = result;
+    }
+    return best;
+}
+
+// Function to time a call, taking the best of three runs, in milliseconds
+template <typename Run>
+double bestOfThree(Run run) {
+    struct Timed {
+        double ms;
+    };
+    return fastestOfThree([&]() {
+        auto start = chrono::steady_clock::now();
+        run();
+        return Timed{chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()};
+    }).ms;
+}
+
+#endif
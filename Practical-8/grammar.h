@@ -0,0 +1,315 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <cctype>
+#include <istream>
+#include <sstream>
+
+using namespace std;
+
+// Marker for the empty string inside First sets (derivations spell it "ε")
+const char EPSILON = '\0';
+
+// Structure to represent a production rule
+struct Production {
+    char nonTerminal;
+    vector<string> derivations;
+};
+
+// Check if a character is a terminal
+inline bool isTerminal(char symbol) {
+    return !isupper(symbol) && symbol != EPSILON;
+}
+
+// Check if a character is a non-terminal
+inline bool isNonTerminal(char symbol) {
+    return isupper(symbol);
+}
+
+// Function to compute First sets for all non-terminals
+inline map<char, set<char>> computeFirstSets(const vector<Production>& grammar) {
+    map<char, set<char>> firstSets;
+
+    // Initialize First sets for all non-terminals
+    for (const auto& production : grammar) {
+        firstSets[production.nonTerminal] = set<char>();
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (const auto& production : grammar) {
+            char nonTerminal = production.nonTerminal;
+
+            for (const string& derivation : production.derivations) {
+                // Case 1: If X -> ε is a production, then add ε to First(X)
+                if (derivation == "ε") {
+                    if (firstSets[nonTerminal].insert(EPSILON).second) {
+                        changed = true;
+                    }
+                    continue;
+                }
+
+                // Case 2: If X -> Y1Y2...Yn is a production
+                bool allDeriveEpsilon = true;
+                for (size_t i = 0; i < derivation.length(); i++) {
+                    char symbol = derivation[i];
+
+                    // If the symbol is a terminal, add it to First(X) and break
+                    if (isTerminal(symbol)) {
+                        if (firstSets[nonTerminal].insert(symbol).second) {
+                            changed = true;
+                        }
+                        allDeriveEpsilon = false;
+                        break;
+                    }
+
+                    // If the symbol is a non-terminal
+                    if (isNonTerminal(symbol)) {
+                        bool derivesEpsilon = false;
+
+                        // Add all non-epsilon terminals from First(Y) to First(X)
+                        for (char terminal : firstSets[symbol]) {
+                            if (terminal != EPSILON) {
+                                if (firstSets[nonTerminal].insert(terminal).second) {
+                                    changed = true;
+                                }
+                            } else {
+                                derivesEpsilon = true;
+                            }
+                        }
+
+                        // If Y does not derive ε, then stop here
+                        if (!derivesEpsilon) {
+                            allDeriveEpsilon = false;
+                            break;
+                        }
+
+                        // If it's the last symbol and it derives ε, then add ε to First(X)
+                        if (i == derivation.length() - 1 && derivesEpsilon) {
+                            if (firstSets[nonTerminal].insert(EPSILON).second) {
+                                changed = true;
+                            }
+                        }
+                    }
+                }
+
+                // If all symbols in the derivation can derive ε, add ε to First(X)
+                if (allDeriveEpsilon && derivation.length() > 0) {
+                    if (firstSets[nonTerminal].insert(EPSILON).second) {
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    return firstSets;
+}
+
+// Function to compute Follow sets for all non-terminals
+inline map<char, set<char>> computeFollowSets(const vector<Production>& grammar,
+                                       const map<char, set<char>>& firstSets) {
+    map<char, set<char>> followSets;
+
+    // Initialize Follow sets for all non-terminals
+    for (const auto& production : grammar) {
+        followSets[production.nonTerminal] = set<char>();
+    }
+
+    // Add $ to Follow(S), where S is the start symbol
+    followSets[grammar[0].nonTerminal].insert('$');
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (const auto& production : grammar) {
+            char nonTerminal = production.nonTerminal;
+
+            for (const string& derivation : production.derivations) {
+                if (derivation == "ε") continue;
+
+                for (size_t i = 0; i < derivation.length(); i++) {
+                    char symbol = derivation[i];
+
+                    // If the symbol is a non-terminal
+                    if (isNonTerminal(symbol)) {
+                        // Case 1: If A -> αBβ, add First(β) - {ε} to Follow(B)
+                        if (i < derivation.length() - 1) {
+                            bool allDerivesEpsilon = true;
+
+                            for (size_t j = i + 1; j < derivation.length(); j++) {
+                                char nextSymbol = derivation[j];
+
+                                if (isTerminal(nextSymbol)) {
+                                    if (followSets[symbol].insert(nextSymbol).second) {
+                                        changed = true;
+                                    }
+                                    allDerivesEpsilon = false;
+                                    break;
+                                } else {
+                                    // Add First(nextSymbol) - {ε} to Follow(symbol)
+                                    bool derivesEpsilon = false;
+                                    for (char terminal : firstSets.at(nextSymbol)) {
+                                        if (terminal != EPSILON) {
+                                            if (followSets[symbol].insert(terminal).second) {
+                                                changed = true;
+                                            }
+                                        } else {
+                                            derivesEpsilon = true;
+                                        }
+                                    }
+
+                                    // If nextSymbol does not derive ε, stop here
+                                    if (!derivesEpsilon) {
+                                        allDerivesEpsilon = false;
+                                        break;
+                                    }
+                                }
+                            }
+
+                            // Case 2: If A -> αBβ and β can derive ε, add Follow(A) to Follow(B)
+                            if (allDerivesEpsilon) {
+                                for (char terminal : followSets[nonTerminal]) {
+                                    if (followSets[symbol].insert(terminal).second) {
+                                        changed = true;
+                                    }
+                                }
+                            }
+                        }
+                        // Case 3: If A -> αB, add Follow(A) to Follow(B)
+                        else {
+                            for (char terminal : followSets[nonTerminal]) {
+                                if (followSets[symbol].insert(terminal).second) {
+                                    changed = true;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return followSets;
+}
+
+// Calculate the First set of a string of grammar symbols
+inline set<char> calculateFirstOfString(const string& str, const map<char, set<char>>& firstSets) {
+    set<char> result;
+
+    if (str.empty() || str == "ε") {
+        result.insert(EPSILON);
+        return result;
+    }
+
+    bool allDeriveEpsilon = true;
+
+    for (size_t i = 0; i < str.length(); i++) {
+        char symbol = str[i];
+
+        if (isTerminal(symbol)) {
+            result.insert(symbol);
+            allDeriveEpsilon = false;
+            break;
+        }
+
+        if (isNonTerminal(symbol)) {
+            bool derivesEpsilon = false;
+
+            for (char terminal : firstSets.at(symbol)) {
+                if (terminal != EPSILON) {
+                    result.insert(terminal);
+                } else {
+                    derivesEpsilon = true;
+                }
+            }
+
+            if (!derivesEpsilon) {
+                allDeriveEpsilon = false;
+                break;
+            }
+
+            if (i == str.length() - 1 && derivesEpsilon) {
+                result.insert(EPSILON);
+            }
+        }
+    }
+
+    if (allDeriveEpsilon && !str.empty()) {
+        result.insert(EPSILON);
+    }
+
+    return result;
+}
+
+// Get terminals from the grammar
+inline set<char> getTerminals(const vector<Production>& grammar) {
+    set<char> terminals;
+
+    for (const auto& production : grammar) {
+        for (const string& derivation : production.derivations) {
+            if (derivation == "ε") continue;
+
+            for (char symbol : derivation) {
+                if (isTerminal(symbol)) {
+                    terminals.insert(symbol);
+                }
+            }
+        }
+    }
+
+    return terminals;
+}
+
+// Get non-terminals from the grammar
+inline vector<char> getNonTerminals(const vector<Production>& grammar) {
+    vector<char> nonTerminals;
+
+    for (const auto& production : grammar) {
+        nonTerminals.push_back(production.nonTerminal);
+    }
+
+    return nonTerminals;
+}
+
+// The LL(1) expression grammar the benchmarks and the sentence generator
+// share: E -> TX, X -> +TX | ε, T -> FY, Y -> *FY | ε, F -> (E) | n
+inline vector<Production> expressionGrammar() {
+    return {{'E', {"TX"}}, {'X', {"+TX", "ε"}}, {'T', {"FY"}}, {'Y', {"*FY", "ε"}}, {'F', {"(E)", "n"}}};
+}
+
+// Function to read a grammar written one non-terminal per line:
+//   S -> ABC | D
+//   A -> a | ε
+inline vector<Production> readGrammar(istream& in) {
+    vector<Production> grammar;
+    string line;
+    while (getline(in, line)) {
+        size_t arrow = line.find("->");
+        if (arrow == string::npos) continue;
+        Production production = {0, {}};
+        for (char c : line.substr(0, arrow)) {
+            if (!isspace((unsigned char)c)) production.nonTerminal = c;
+        }
+        stringstream alternatives(line.substr(arrow + 2));
+        string alternative;
+        while (getline(alternatives, alternative, '|')) {
+            string symbols;
+            for (char c : alternative) {
+                if (!isspace((unsigned char)c)) symbols += c;
+            }
+            production.derivations.push_back(symbols.empty() ? "ε" : symbols);
+        }
+        if (production.nonTerminal) grammar.push_back(production);
+    }
+    return grammar;
+}
+
+#endif
@@ -0,0 +1,342 @@
+#ifndef INCREMENTAL_LL1_H
+#define INCREMENTAL_LL1_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+#include <algorithm>
+#include "ll1.h"
+
+using namespace std;
+
+// Incremental LL(1) parsing for an editor buffer that changes a little at a
+// time. The parse stack is checkpointed every 'interval' characters, at the
+// moment the previous character has been matched. Checkpoints are chains
+// of StackNodes, and a checkpoint shares every node below the lowest depth
+// the stack reached since the one before it, so keeping thousands of
+// checkpoints costs little more than the stack changes between them.
+//
+// After an edit the parse restarts from the last checkpoint before the
+// edit. Past the edit it compares its stack with the old checkpoints at
+// the same (shifted) positions, and as soon as one matches, the rest of
+// the old parse, and its result, still hold. The work is the distance from
+// the checkpoint to the edit, the edit itself and the distance to the next
+// checkpoint at which the stacks agree, plus one pass over the checkpoint
+// positions to shift them.
+//
+// When a reparse does not rejoin, the old parse's checkpoints past the
+// edit are kept as detached checkpoints, together with the result they led
+// to, so that undoing a typo rejoins them instead of parsing the whole
+// tail again.
+
+// Structure to report what one reparse did
+struct ReparseStats {
+    size_t resumedAt = 0;           // Position of the checkpoint the parse restarted from
+    size_t rejoinedAt = SIZE_MAX;   // Position where the stack matched the old parse
+    size_t charactersParsed = 0;
+    size_t checkpointsCompared = 0;
+};
+
+class IncrementalLL1 {
+    struct StackNode {
+        char symbol;
+        int parent;                 // -1 below the bottom
+    };
+
+    struct Checkpoint {
+        size_t position;
+        int node;                   // Top of the stack
+        int depth;
+    };
+
+    enum Outcome { ACCEPTED, REJECTED, REJOINED };
+
+    vector<int> cells;              // 256 x 256: (non-terminal, lookahead) to production, or -1
+    vector<string> productions;     // Reversed, ready to push
+    char startSymbol;
+    size_t interval;
+
+    vector<StackNode> nodes;
+    size_t nodesAfterCompaction = 0;
+    vector<Checkpoint> checkpoints; // The current parse's, by position
+    bool isAccepted = false;
+    size_t errorAt = 0;
+    vector<Checkpoint> detachedCheckpoints;  // An earlier parse's, past the last edit
+    bool detachedAccepted = false;           // Where that parse led
+    size_t detachedErrorAt = 0;
+
+    // Parse state
+    vector<char> stack;
+    int lastNode = -1;              // Latest checkpoint's top, and its depth
+    int lastDepth = 0;
+    int lowWater = 0;               // Lowest depth since that checkpoint
+
+    // Function to record the stack as a checkpoint, sharing what is left of
+    // the previous one
+    Checkpoint snapshot(size_t position) {
+        int node = lastNode;
+        for (int depth = lastDepth; depth > lowWater; depth--) node = nodes[node].parent;
+        for (size_t d = lowWater; d < stack.size(); d++) {
+            nodes.push_back({stack[d], node});
+            node = (int)nodes.size() - 1;
+        }
+        lastNode = node;
+        lastDepth = lowWater = (int)stack.size();
+        return {position, node, lastDepth};
+    }
+
+    void restore(const Checkpoint& checkpoint) {
+        stack.resize(checkpoint.depth);
+        int node = checkpoint.node;
+        for (int d = checkpoint.depth - 1; d >= 0; d--) {
+            stack[d] = nodes[node].symbol;
+            node = nodes[node].parent;
+        }
+        lastNode = checkpoint.node;
+        lastDepth = lowWater = checkpoint.depth;
+    }
+
+    // Function to compare two checkpoints' stacks, which stops where they
+    // start sharing nodes
+    bool sameStack(const Checkpoint& a, const Checkpoint& b) const {
+        if (a.depth != b.depth) return false;
+        int x = a.node, y = b.node;
+        while (x != y) {
+            if (nodes[x].symbol != nodes[y].symbol) return false;
+            x = nodes[x].parent;
+            y = nodes[y].parent;
+        }
+        return true;
+    }
+
+    // Function to parse from the restored stack at pos. Checkpoints are
+    // taken every interval characters and at each candidate position;
+    // a candidate whose stack matches ends the parse as REJOINED, with
+    // candidate its index.
+    Outcome run(const string& text, size_t pos, const vector<Checkpoint>& candidates, vector<Checkpoint>& taken,
+                size_t& stoppedAt, size_t& candidate, ReparseStats& stats) {
+        size_t n = text.size();
+        size_t from = pos;
+        size_t nextRegular = pos + interval;
+        candidate = 0;
+        while (true) {
+            if (pos != from) {
+                while (candidate < candidates.size() && candidates[candidate].position < pos) candidate++;
+                bool atCandidate = candidate < candidates.size() && candidates[candidate].position == pos;
+                if (atCandidate || pos >= nextRegular) {
+                    Checkpoint checkpoint = snapshot(pos);
+                    // Both the old parse and the detached checkpoints may
+                    // have one here
+                    for (; candidate < candidates.size() && candidates[candidate].position == pos; candidate++) {
+                        stats.checkpointsCompared++;
+                        if (sameStack(checkpoint, candidates[candidate])) {
+                            stats.charactersParsed = pos - from;
+                            stoppedAt = pos;
+                            return REJOINED;
+                        }
+                    }
+                    taken.push_back(checkpoint);
+                    nextRegular = pos + interval;
+                }
+            }
+
+            // Expand until a terminal on top meets the lookahead
+            char lookahead = pos < n ? text[pos] : '$';
+            bool matched = false;
+            while (true) {
+                char top = stack.back();
+                if (isNonTerminal(top)) {
+                    int production = cells[(unsigned char)top * 256 + (unsigned char)lookahead];
+                    if (production < 0) break;
+                    stack.pop_back();
+                    lowWater = min(lowWater, (int)stack.size());
+                    stack.insert(stack.end(), productions[production].begin(), productions[production].end());
+                    continue;
+                }
+                if (top != lookahead) break;
+                stack.pop_back();
+                lowWater = min(lowWater, (int)stack.size());
+                if (top == '$') {
+                    stats.charactersParsed = pos - from;
+                    stoppedAt = pos;
+                    return ACCEPTED;
+                }
+                pos++;
+                matched = true;
+                break;
+            }
+            if (!matched) break;
+        }
+        stats.charactersParsed = pos - from;
+        stoppedAt = pos;
+        return REJECTED;
+    }
+
+    // Function to drop nodes no checkpoint reaches any more. Nodes are
+    // pushed after their parents, so renumbering in order keeps that true.
+    void compact() {
+        vector<int> remap(nodes.size(), -1);
+        for (const vector<Checkpoint>* list : {&checkpoints, &detachedCheckpoints}) {
+            for (const Checkpoint& checkpoint : *list) {
+                for (int node = checkpoint.node; node >= 0 && remap[node] < 0; node = nodes[node].parent) remap[node] = 0;
+            }
+        }
+        int next = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (remap[i] < 0) continue;
+            remap[i] = next;
+            int parent = nodes[i].parent;
+            nodes[next++] = {nodes[i].symbol, parent < 0 ? -1 : remap[parent]};
+        }
+        nodes.resize(next);
+        for (Checkpoint& checkpoint : checkpoints) checkpoint.node = remap[checkpoint.node];
+        for (Checkpoint& checkpoint : detachedCheckpoints) checkpoint.node = remap[checkpoint.node];
+        nodesAfterCompaction = nodes.size();
+    }
+
+public:
+    IncrementalLL1(const map<char, map<char, TableEntry>>& table, char start, size_t checkpointInterval = 1024)
+        : cells(256 * 256, -1), startSymbol(start), interval(max<size_t>(checkpointInterval, 1)) {
+        for (const auto& [nonTerminal, row] : table) {
+            for (const auto& [lookahead, entry] : row) {
+                if (entry.production.empty()) continue;
+                string reversed = entry.production == "ε" ? "" : string(entry.production.rbegin(), entry.production.rend());
+                cells[(unsigned char)nonTerminal * 256 + (unsigned char)lookahead] = (int)productions.size();
+                productions.push_back(reversed);
+            }
+        }
+    }
+
+    // Function to parse a whole buffer, accepting exactly what
+    // validateString accepts with the same table
+    bool parse(const string& text) {
+        nodes.clear();
+        checkpoints.clear();
+        detachedCheckpoints.clear();
+        stack = {'$', startSymbol};
+        lastNode = -1;
+        lastDepth = lowWater = 0;
+        checkpoints.push_back(snapshot(0));
+
+        vector<Checkpoint> none;
+        ReparseStats stats;
+        size_t stoppedAt, candidate;
+        Outcome outcome = run(text, 0, none, checkpoints, stoppedAt, candidate, stats);
+        isAccepted = outcome == ACCEPTED;
+        errorAt = isAccepted ? 0 : stoppedAt;
+        nodesAfterCompaction = nodes.size();
+        return isAccepted;
+    }
+
+    // Function to reparse after the caller replaced 'erased' characters at
+    // offset with 'inserted' characters; text is the buffer after the edit
+    bool edit(const string& text, size_t offset, size_t erased, size_t inserted, ReparseStats* reparseStats = nullptr) {
+        ReparseStats localStats;
+        ReparseStats& stats = reparseStats ? *reparseStats : localStats;
+        stats = ReparseStats();
+        size_t oldEditEnd = offset + erased;
+        size_t newEditEnd = offset + inserted;
+        auto shift = [&](size_t position) { return position - erased + inserted; };
+
+        // Old checkpoints: those up to the edit can be resumed from, those
+        // after it (shifted) can be rejoined; the ones inside are gone. A
+        // detached checkpoint is only worth keeping while the text after it
+        // is unchanged, so it has to lie wholly after the edit.
+        vector<Checkpoint> prefix, live, detached;
+        for (Checkpoint checkpoint : checkpoints) {
+            if (checkpoint.position <= offset) {
+                prefix.push_back(checkpoint);
+            } else if (checkpoint.position >= oldEditEnd) {
+                checkpoint.position = shift(checkpoint.position);
+                live.push_back(checkpoint);
+            }
+        }
+        for (Checkpoint checkpoint : detachedCheckpoints) {
+            if (checkpoint.position > offset && checkpoint.position >= oldEditEnd) {
+                checkpoint.position = shift(checkpoint.position);
+                detached.push_back(checkpoint);
+            }
+        }
+        if (!detachedAccepted && !detached.empty()) detachedErrorAt = shift(detachedErrorAt);
+        detachedCheckpoints = detached;
+
+        // A parse that failed before the edit fails the same way
+        if (!isAccepted && errorAt < offset) {
+            checkpoints = prefix;
+            stats.resumedAt = errorAt;
+            return false;
+        }
+        bool oldAccepted = isAccepted;
+        size_t oldErrorAt = isAccepted ? 0 : shift(errorAt);
+
+        const Checkpoint& resume = prefix.back();
+        restore(resume);
+        stats.resumedAt = resume.position;
+
+        // Rejoin candidates past the edit, from both the old parse and the
+        // detached checkpoints, in position order
+        vector<Checkpoint> candidates;
+        vector<bool> fromDetached;
+        size_t l = 0, d = 0;
+        while (l < live.size() || d < detached.size()) {
+            bool takeDetached = l == live.size() || (d < detached.size() && detached[d].position < live[l].position);
+            const Checkpoint& checkpoint = takeDetached ? detached[d++] : live[l++];
+            if (checkpoint.position < newEditEnd) continue;
+            candidates.push_back(checkpoint);
+            fromDetached.push_back(takeDetached);
+        }
+
+        vector<Checkpoint> taken;
+        size_t stoppedAt, candidate;
+        Outcome outcome = run(text, resume.position, candidates, taken, stoppedAt, candidate, stats);
+
+        checkpoints = prefix;
+        checkpoints.insert(checkpoints.end(), taken.begin(), taken.end());
+        if (outcome == REJOINED) {
+            // The rest of whichever parse recorded the matching checkpoint
+            // holds, and the other set of checkpoints stays detached
+            stats.rejoinedAt = stoppedAt;
+            bool rejoinedDetached = fromDetached[candidate];
+            const vector<Checkpoint>& rest = rejoinedDetached ? detached : live;
+            for (const Checkpoint& checkpoint : rest) {
+                if (checkpoint.position >= stoppedAt) checkpoints.push_back(checkpoint);
+            }
+            if (rejoinedDetached) {
+                isAccepted = detachedAccepted;
+                errorAt = detachedErrorAt;
+                detachedCheckpoints = live;
+                detachedAccepted = oldAccepted;
+                detachedErrorAt = oldErrorAt;
+            } else {
+                isAccepted = oldAccepted;
+                errorAt = oldErrorAt;
+            }
+        } else {
+            isAccepted = outcome == ACCEPTED;
+            errorAt = isAccepted ? 0 : stoppedAt;
+            // Keep the old parse's checkpoints past the edit so that undoing
+            // the edit rejoins them
+            if (!live.empty()) {
+                detachedCheckpoints = live;
+                detachedAccepted = oldAccepted;
+                detachedErrorAt = oldErrorAt;
+            }
+        }
+
+        if (nodes.size() > 2 * nodesAfterCompaction + 4096) compact();
+        return isAccepted;
+    }
+
+    bool accepted() const { return isAccepted; }
+    size_t errorPosition() const { return errorAt; }
+    size_t checkpointCount() const { return checkpoints.size(); }
+    size_t detachedCount() const { return detachedCheckpoints.size(); }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t memoryBytes() const {
+        return nodes.capacity() * sizeof(StackNode) +
+               (checkpoints.capacity() + detachedCheckpoints.capacity()) * sizeof(Checkpoint) + cells.size() * sizeof(int);
+    }
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include "lr_tables.h"
+
+using namespace std;
+
+// Structure to bundle a grammar with its precedence declarations and test cases
+struct GrammarCase {
+    string name;
+    vector<Production> grammar;
+    vector<PrecedenceLevel> precedence;
+    vector<string> testCases;
+};
+
+// Function to render one ACTION entry
+string actionToString(int action) {
+    if (action > 0) return "s" + to_string(action - 1);
+    if (action == reduceAction(0)) return "acc";
+    if (action < 0) return "r" + to_string(-action - 1);
+    return "-";
+}
+
+// Print the numbered rules of the augmented grammar
+void printRules(const LALRTable& table) {
+    auto symbolName = [&](int symbol) {
+        if (symbol < table.numTerminals()) return string(1, table.terminals[symbol]);
+        char nonTerminal = table.nonTerminals[symbol - table.numTerminals()];
+        return nonTerminal == '\'' ? string("S'") : string(1, nonTerminal);
+    };
+
+    cout << "Rules:" << endl;
+    for (size_t r = 0; r < table.rules.size(); r++) {
+        cout << setw(4) << r << "  " << symbolName(table.rules[r].lhs) << " ->";
+        if (table.rules[r].rhs.empty()) cout << " ε";
+        for (int symbol : table.rules[r].rhs) cout << " " << symbolName(symbol);
+        cout << endl;
+    }
+}
+
+// Print the ACTION and GOTO tables
+void printLALRTable(const LALRTable& table) {
+    cout << "\nLALR(1) Parsing Table:\n";
+    cout << setw(6) << "State";
+    for (char terminal : table.terminals) cout << setw(6) << terminal;
+    cout << "  |";
+    for (int A = 0; A + 1 < table.numNonTerminals(); A++) cout << setw(5) << table.nonTerminals[A];
+    cout << endl;
+    cout << string(6 + table.numTerminals() * 6 + 3 + (table.numNonTerminals() - 1) * 5, '-') << endl;
+
+    for (int s = 0; s < table.numStates; s++) {
+        cout << setw(6) << s;
+        for (int t = 0; t < table.numTerminals(); t++) {
+            cout << setw(6) << actionToString(table.action[s * table.numTerminals() + t]);
+        }
+        cout << "  |";
+        for (int A = 0; A + 1 < table.numNonTerminals(); A++) {
+            int target = table.gotoTable[s * table.numNonTerminals() + A];
+            cout << setw(5) << (target == -1 ? string("-") : to_string(target));
+        }
+        cout << endl;
+    }
+}
+
+// Evaluate an expression with the dense tables of a calculator grammar: digits
+// are read as the token n, and E/T/F/G rules compute like practical-10.y.
+bool evaluateWithTable(const string& expr, const LALRTable& table, double& value) {
+    int terminalOf[256];
+    fill(terminalOf, terminalOf + 256, -1);
+    for (int t = 0; t < table.numTerminals(); t++) terminalOf[(unsigned char)table.terminals[t]] = t;
+
+    vector<int> states = {0};
+    vector<double> values = {0};
+    size_t index = 0;
+
+    while (true) {
+        char c = index < expr.size() ? expr[index] : '$';
+        int token = terminalOf[(unsigned char)(isdigit(c) ? 'n' : c)];
+        if (token < 0) return false;
+
+        int action = table.action[states.back() * table.numTerminals() + token];
+        if (action > 0) {
+            states.push_back(action - 1);
+            values.push_back(isdigit(c) ? c - '0' : 0);
+            index++;
+        } else if (action < 0) {
+            int rule = -action - 1;
+            if (rule == 0) {
+                value = values.back();
+                return true;
+            }
+
+            const LRRule& r = table.rules[rule];
+            size_t length = r.rhs.size();
+            double result = length > 0 ? values[values.size() - length] : 0;
+            if (length == 3) {
+                double a = values[values.size() - 3];
+                double b = values[values.size() - 1];
+                switch (table.terminals[r.rhs[1] < table.numTerminals() ? r.rhs[1] : 0]) {
+                    case '+': result = a + b; break;
+                    case '-': result = a - b; break;
+                    case '*': result = a * b; break;
+                    case '/': result = a / b; break;
+                    case '^': result = pow(a, b); break;
+                    default: result = values[values.size() - 2]; break;  // ( E )
+                }
+            }
+
+            states.resize(states.size() - length);
+            values.resize(values.size() - length);
+            states.push_back(table.gotoTable[states.back() * table.numNonTerminals() + (r.lhs - table.numTerminals())]);
+            values.push_back(result);
+        } else {
+            return false;
+        }
+    }
+}
+
+int main() {
+    vector<GrammarCase> cases = {
+        // Practical-9: dangling else, Sdash written as X
+        {"Dangling else (Practical-9)",
+         {{'S', {"iEtSX", "a"}}, {'X', {"eS", "ε"}}, {'E', {"b"}}},
+         {},
+         {"a", "ibta", "ibtaea", "ibtibtaea", "ibt", "ibtae"}},
+        // Practical-10: layered calculator grammar, NUMBER written as n
+        {"Calculator (Practical-10)",
+         {{'L', {"E"}}, {'E', {"E+T", "E-T", "T"}}, {'T', {"T*F", "T/F", "F"}},
+          {'F', {"G^F", "G"}}, {'G', {"(E)", "n"}}},
+         {},
+         {"n", "n+n*n", "(n+n)^n^n", "n+", "(n"}},
+        // Ambiguous calculator grammar disambiguated with the practical-10.y declarations
+        {"Ambiguous calculator with %left/%right",
+         {{'E', {"E+E", "E-E", "E*E", "E/E", "E^E", "(E)", "n"}}},
+         {{Associativity::Left, "+-"}, {Associativity::Left, "*/"}, {Associativity::Right, "^"}},
+         {"n", "n-n-n", "n+n*n^n^n", "n*", ")n"}},
+    };
+
+    for (const auto& grammarCase : cases) {
+        cout << "Grammar: " << grammarCase.name << endl;
+        LALRTable table = buildLALRTable(grammarCase.grammar, grammarCase.precedence);
+        printRules(table);
+        printLALRTable(table);
+
+        cout << "\nStates: " << table.numStates
+             << ", shift/reduce conflicts: " << table.shiftReduceConflicts
+             << ", reduce/reduce conflicts: " << table.reduceReduceConflicts
+             << ", resolved by precedence: " << table.resolvedByPrecedence << endl;
+
+        DenseLRTables dense = buildDenseTables(table);
+        DefaultCombLRTables parser = buildDefaultCombTables(table);
+        cout << "Table size: dense " << dense.sizeInBytes() << " bytes, comb with defaults "
+             << parser.sizeInBytes() << " bytes" << endl;
+
+        cout << "\nValidating Test Cases:" << endl;
+        for (const string& testCase : grammarCase.testCases) {
+            cout << "\"" << testCase << "\" is " << (parseLR(testCase, parser) ? "Valid" : "Invalid")
+                 << " string" << endl;
+        }
+        cout << string(60, '=') << endl;
+    }
+
+    // Precedence must give the same values as the layered grammar
+    LALRTable layered = buildLALRTable(cases[1].grammar);
+    LALRTable ambiguous = buildLALRTable(cases[2].grammar, cases[2].precedence);
+    cout << "Evaluating with both calculator tables:" << endl;
+    for (string expr : {"2+3*4", "8-3-2", "2^3^2", "(1+2)*3^2/9", "9/3/3"}) {
+        double a = 0, b = 0;
+        bool okA = evaluateWithTable(expr, layered, a);
+        bool okB = evaluateWithTable(expr, ambiguous, b);
+        cout << expr << " = " << (okA ? to_string(a) : "error") << " (layered), "
+             << (okB ? to_string(b) : "error") << " (precedence)" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,404 @@
+#ifndef LALR_H
+#define LALR_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include "grammar.h"
+
+using namespace std;
+
+// Associativity of a precedence level, as in %left / %right / %nonassoc
+enum class Associativity { Left, Right, NonAssoc };
+
+// Structure to represent one precedence declaration; later levels bind tighter
+struct PrecedenceLevel {
+    Associativity associativity;
+    string terminals;
+};
+
+// Structure to represent a rule of the augmented grammar. Symbols are
+// numbered with terminals first ('$' is 0) followed by the non-terminals.
+struct LRRule {
+    int lhs;
+    vector<int> rhs;
+    int precedence;  // 0 when no terminal of the rule has a precedence
+};
+
+// Structure to represent an LR(0) item
+struct LRItem {
+    int rule;
+    int dot;
+
+    bool operator<(const LRItem& other) const {
+        return rule != other.rule ? rule < other.rule : dot < other.dot;
+    }
+    bool operator==(const LRItem& other) const {
+        return rule == other.rule && dot == other.dot;
+    }
+};
+
+// ACTION entries: 0 is an error, s + 1 shifts to state s and -(r + 1)
+// reduces by rule r. Reducing by rule 0 (S' -> S) accepts.
+const int ACTION_ERROR = 0;
+
+inline int shiftAction(int state) { return state + 1; }
+inline int reduceAction(int rule) { return -(rule + 1); }
+
+// Structure to hold the dense LALR(1) tables and how they were built
+struct LALRTable {
+    vector<char> terminals;     // Index 0 is '$'
+    vector<char> nonTerminals;  // The last entry is the augmented start symbol
+    vector<LRRule> rules;
+    int numStates = 0;
+    vector<int> action;         // numStates x terminals.size()
+    vector<int> gotoTable;      // numStates x nonTerminals.size(), -1 when empty
+    vector<bool> explicitError; // Errors set by %nonassoc; they must survive compression
+    int shiftReduceConflicts = 0;
+    int reduceReduceConflicts = 0;
+    int resolvedByPrecedence = 0;
+
+    int numTerminals() const { return (int)terminals.size(); }
+    int numNonTerminals() const { return (int)nonTerminals.size(); }
+};
+
+// Function to number the symbols and rules of a grammar
+inline void numberGrammar(const vector<Production>& grammar,
+                          const vector<PrecedenceLevel>& precedence,
+                          LALRTable& table,
+                          vector<int>& terminalPrecedence,
+                          vector<Associativity>& terminalAssociativity) {
+    int symbolIndex[256];
+    fill(symbolIndex, symbolIndex + 256, -1);
+
+    table.terminals = {'$'};
+    set<char> terminals = getTerminals(grammar);
+    terminals.erase('$');
+    table.terminals.insert(table.terminals.end(), terminals.begin(), terminals.end());
+    for (size_t i = 0; i < table.terminals.size(); i++) {
+        symbolIndex[(unsigned char)table.terminals[i]] = (int)i;
+    }
+
+    int numTerminals = (int)table.terminals.size();
+    table.nonTerminals.clear();
+    for (const auto& production : grammar) {
+        if (symbolIndex[(unsigned char)production.nonTerminal] == -1) {
+            symbolIndex[(unsigned char)production.nonTerminal] = numTerminals + (int)table.nonTerminals.size();
+            table.nonTerminals.push_back(production.nonTerminal);
+        }
+    }
+    // Upper-case symbols without productions still need a number
+    for (const auto& production : grammar) {
+        for (const string& derivation : production.derivations) {
+            if (derivation == "ε") continue;
+            for (char symbol : derivation) {
+                if (symbolIndex[(unsigned char)symbol] == -1) {
+                    symbolIndex[(unsigned char)symbol] = numTerminals + (int)table.nonTerminals.size();
+                    table.nonTerminals.push_back(symbol);
+                }
+            }
+        }
+    }
+    int augmentedStart = numTerminals + (int)table.nonTerminals.size();
+    table.nonTerminals.push_back('\'');
+
+    // Precedence levels are numbered from 1 in declaration order
+    terminalPrecedence.assign(numTerminals, 0);
+    terminalAssociativity.assign(numTerminals, Associativity::NonAssoc);
+    for (size_t level = 0; level < precedence.size(); level++) {
+        for (char terminal : precedence[level].terminals) {
+            int t = symbolIndex[(unsigned char)terminal];
+            if (t < 0 || t >= numTerminals) continue;
+            terminalPrecedence[t] = (int)level + 1;
+            terminalAssociativity[t] = precedence[level].associativity;
+        }
+    }
+
+    table.rules.clear();
+    table.rules.push_back({augmentedStart, {symbolIndex[(unsigned char)grammar[0].nonTerminal]}, 0});
+    for (const auto& production : grammar) {
+        int lhs = symbolIndex[(unsigned char)production.nonTerminal];
+        for (const string& derivation : production.derivations) {
+            LRRule rule = {lhs, {}, 0};
+            if (derivation != "ε") {
+                for (char symbol : derivation) {
+                    int index = symbolIndex[(unsigned char)symbol];
+                    rule.rhs.push_back(index);
+                    // The rule takes the precedence of its last terminal that has one
+                    if (index < numTerminals && terminalPrecedence[index] > 0) {
+                        rule.precedence = terminalPrecedence[index];
+                    }
+                }
+            }
+            table.rules.push_back(rule);
+        }
+    }
+}
+
+// Function to compute the closure of a set of LR(0) items
+inline vector<LRItem> closureOf(const vector<LRItem>& kernel,
+                                const vector<LRRule>& rules,
+                                const vector<vector<int>>& rulesOf,
+                                int numTerminals) {
+    vector<LRItem> items = kernel;
+    vector<bool> added(rulesOf.size(), false);
+
+    for (size_t i = 0; i < items.size(); i++) {
+        const LRRule& rule = rules[items[i].rule];
+        if (items[i].dot >= (int)rule.rhs.size()) continue;
+
+        int symbol = rule.rhs[items[i].dot];
+        if (symbol < numTerminals || added[symbol - numTerminals]) continue;
+        added[symbol - numTerminals] = true;
+        for (int r : rulesOf[symbol - numTerminals]) {
+            items.push_back({r, 0});
+        }
+    }
+    return items;
+}
+
+// Digraph algorithm (DeRemer & Pennello): F(x) = F'(x) ∪ ⋃{F(y) | x R y}.
+// sets holds F'(x) on entry and F(x) on return, words 64-bit words per set.
+inline void digraph(const vector<vector<int>>& relation, vector<uint64_t>& sets, int words) {
+    struct Frame {
+        int node;
+        size_t edge;
+        int depth;
+    };
+
+    int n = (int)relation.size();
+    const int done = INT32_MAX;
+    vector<int> depth(n, 0);
+    vector<int> stack;
+    vector<Frame> frames;
+
+    auto unite = [&](int into, int from) {
+        for (int w = 0; w < words; w++) sets[into * words + w] |= sets[from * words + w];
+    };
+
+    for (int start = 0; start < n; start++) {
+        if (depth[start] != 0) continue;
+
+        stack.push_back(start);
+        depth[start] = (int)stack.size();
+        frames.push_back({start, 0, depth[start]});
+
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            int x = frame.node;
+
+            if (frame.edge < relation[x].size()) {
+                int y = relation[x][frame.edge++];
+                if (depth[y] == 0) {
+                    stack.push_back(y);
+                    depth[y] = (int)stack.size();
+                    frames.push_back({y, 0, depth[y]});
+                } else {
+                    depth[x] = min(depth[x], depth[y]);
+                    unite(x, y);
+                }
+                continue;
+            }
+
+            // All edges of x are done: x may close a strongly connected component
+            if (depth[x] == frame.depth) {
+                while (true) {
+                    int top = stack.back();
+                    stack.pop_back();
+                    depth[top] = done;
+                    if (top == x) break;
+                    for (int w = 0; w < words; w++) sets[top * words + w] = sets[x * words + w];
+                }
+            }
+            frames.pop_back();
+            if (!frames.empty()) {
+                int parent = frames.back().node;
+                depth[parent] = min(depth[parent], depth[x]);
+                unite(parent, x);
+            }
+        }
+    }
+}
+
+// Function to build the LALR(1) ACTION and GOTO tables of a grammar. The first
+// production's non-terminal is the start symbol; conflicts are resolved with
+// the precedence levels the way yacc does, defaulting to shift.
+inline LALRTable buildLALRTable(const vector<Production>& grammar,
+                                const vector<PrecedenceLevel>& precedence = {}) {
+    LALRTable table;
+    vector<int> terminalPrecedence;
+    vector<Associativity> terminalAssociativity;
+    numberGrammar(grammar, precedence, table, terminalPrecedence, terminalAssociativity);
+
+    const vector<LRRule>& rules = table.rules;
+    int numTerminals = table.numTerminals();
+    int numNonTerminals = table.numNonTerminals();
+    int numSymbols = numTerminals + numNonTerminals;
+
+    vector<vector<int>> rulesOf(numNonTerminals);
+    for (size_t r = 0; r < rules.size(); r++) {
+        rulesOf[rules[r].lhs - numTerminals].push_back((int)r);
+    }
+
+    // Nullable non-terminals come from the First sets
+    map<char, set<char>> firstSets = computeFirstSets(grammar);
+    vector<bool> nullable(numNonTerminals, false);
+    for (int A = 0; A + 1 < numNonTerminals; A++) {
+        nullable[A] = firstSets[table.nonTerminals[A]].count(EPSILON) > 0;
+    }
+    auto isNullable = [&](int symbol) {
+        return symbol >= numTerminals && nullable[symbol - numTerminals];
+    };
+
+    // LR(0) automaton: states are identified by their sorted kernels
+    map<vector<LRItem>, int> stateOf;
+    vector<vector<LRItem>> kernels = {{{0, 0}}};
+    vector<int> transitions;                 // numStates x numSymbols, -1 when empty
+    vector<vector<int>> reductions;          // Complete rules of each state
+    stateOf[kernels[0]] = 0;
+
+    for (size_t s = 0; s < kernels.size(); s++) {
+        vector<LRItem> items = closureOf(kernels[s], rules, rulesOf, numTerminals);
+        map<int, vector<LRItem>> successors;
+        reductions.emplace_back();
+
+        for (const LRItem& item : items) {
+            const LRRule& rule = rules[item.rule];
+            if (item.dot == (int)rule.rhs.size()) {
+                reductions[s].push_back(item.rule);
+            } else {
+                successors[rule.rhs[item.dot]].push_back({item.rule, item.dot + 1});
+            }
+        }
+
+        transitions.resize((s + 1) * numSymbols, -1);
+        for (auto& successor : successors) {
+            sort(successor.second.begin(), successor.second.end());
+            auto inserted = stateOf.insert({successor.second, (int)kernels.size()});
+            if (inserted.second) kernels.push_back(successor.second);
+            transitions[s * numSymbols + successor.first] = inserted.first->second;
+        }
+    }
+    int numStates = (int)kernels.size();
+    auto gotoState = [&](int state, int symbol) { return transitions[state * numSymbols + symbol]; };
+
+    // Number the non-terminal transitions (p, A)
+    vector<int> transitionIndex(numStates * numNonTerminals, -1);
+    vector<pair<int, int>> ntTransitions;
+    for (int p = 0; p < numStates; p++) {
+        for (int A = numTerminals; A < numSymbols; A++) {
+            if (gotoState(p, A) != -1) {
+                transitionIndex[p * numNonTerminals + (A - numTerminals)] = (int)ntTransitions.size();
+                ntTransitions.push_back({p, A});
+            }
+        }
+    }
+    int numTransitions = (int)ntTransitions.size();
+    int words = (numTerminals + 63) / 64;
+
+    // Direct reads and the reads relation
+    vector<uint64_t> sets(numTransitions * words, 0);
+    vector<vector<int>> reads(numTransitions);
+    for (int x = 0; x < numTransitions; x++) {
+        int r = gotoState(ntTransitions[x].first, ntTransitions[x].second);
+        for (int t = 0; t < numTerminals; t++) {
+            if (gotoState(r, t) != -1) sets[x * words + t / 64] |= 1ULL << (t % 64);
+        }
+        if (kernels[r][0].rule == 0 && kernels[r][0].dot == 1) sets[x * words] |= 1;  // $ after S
+        for (int C = numTerminals; C < numSymbols; C++) {
+            if (isNullable(C) && gotoState(r, C) != -1) {
+                reads[x].push_back(transitionIndex[r * numNonTerminals + (C - numTerminals)]);
+            }
+        }
+    }
+    digraph(reads, sets, words);
+
+    // The includes and lookback relations
+    vector<vector<int>> includes(numTransitions);
+    vector<vector<pair<int, int>>> lookbacks(numStates);  // (rule, transition) per state
+    for (int x = 0; x < numTransitions; x++) {
+        int p = ntTransitions[x].first;
+        int B = ntTransitions[x].second;
+        for (int r : rulesOf[B - numTerminals]) {
+            const vector<int>& rhs = rules[r].rhs;
+            int state = p;
+            for (size_t i = 0; i < rhs.size(); i++) {
+                if (rhs[i] >= numTerminals) {
+                    bool restNullable = all_of(rhs.begin() + i + 1, rhs.end(), isNullable);
+                    if (restNullable) {
+                        includes[transitionIndex[state * numNonTerminals + (rhs[i] - numTerminals)]].push_back(x);
+                    }
+                }
+                state = gotoState(state, rhs[i]);
+            }
+            lookbacks[state].push_back({r, x});
+        }
+    }
+    digraph(includes, sets, words);
+
+    // Fill ACTION: shifts first, then reductions on their lookahead sets
+    table.numStates = numStates;
+    table.action.assign(numStates * numTerminals, ACTION_ERROR);
+    table.gotoTable.assign(numStates * numNonTerminals, -1);
+    for (int s = 0; s < numStates; s++) {
+        for (int t = 0; t < numTerminals; t++) {
+            if (gotoState(s, t) != -1) table.action[s * numTerminals + t] = shiftAction(gotoState(s, t));
+        }
+        for (int A = 0; A < numNonTerminals; A++) {
+            table.gotoTable[s * numNonTerminals + A] = gotoState(s, numTerminals + A);
+        }
+    }
+
+    // S' -> S . is never looked back to; it accepts on $
+    table.action[gotoState(0, rules[0].rhs[0]) * numTerminals + 0] = reduceAction(0);
+
+    vector<uint64_t> lookahead(words);
+    vector<bool>& explicitError = table.explicitError;
+    explicitError.assign(numStates * numTerminals, false);
+    for (int s = 0; s < numStates; s++) {
+        for (int r : reductions[s]) {
+            fill(lookahead.begin(), lookahead.end(), 0);
+            for (const auto& lookback : lookbacks[s]) {
+                if (lookback.first != r) continue;
+                for (int w = 0; w < words; w++) lookahead[w] |= sets[lookback.second * words + w];
+            }
+
+            for (int t = 0; t < numTerminals; t++) {
+                if (!(lookahead[t / 64] >> (t % 64) & 1)) continue;
+                int& entry = table.action[s * numTerminals + t];
+
+                if (entry == ACTION_ERROR && !explicitError[s * numTerminals + t]) {
+                    entry = reduceAction(r);
+                } else if (entry > 0) {
+                    // Shift/reduce: compare the rule with the lookahead token
+                    int rulePrecedence = rules[r].precedence;
+                    int tokenPrecedence = terminalPrecedence[t];
+                    if (rulePrecedence == 0 || tokenPrecedence == 0) {
+                        table.shiftReduceConflicts++;
+                    } else {
+                        table.resolvedByPrecedence++;
+                        if (rulePrecedence > tokenPrecedence ||
+                            (rulePrecedence == tokenPrecedence &&
+                             terminalAssociativity[t] == Associativity::Left)) {
+                            entry = reduceAction(r);
+                        } else if (rulePrecedence == tokenPrecedence &&
+                                   terminalAssociativity[t] == Associativity::NonAssoc) {
+                            entry = ACTION_ERROR;
+                            explicitError[s * numTerminals + t] = true;
+                        }
+                    }
+                } else if (entry < 0) {
+                    // Reduce/reduce: keep the rule listed first
+                    table.reduceReduceConflicts++;
+                    entry = max(entry, reduceAction(r));
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include "lr_tables.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Structure to describe a generated operator grammar
+struct GeneratedGrammar {
+    string name;
+    vector<Production> grammar;
+    vector<PrecedenceLevel> precedence;
+    string binaryOperators;
+    string prefixOperators;
+};
+
+// Terminals available for operators: printable, not upper-case and not
+// otherwise used by the generated grammars
+string operatorPool() {
+    string pool;
+    for (char c = '!'; c <= '~'; c++) {
+        if (isupper(c) || c == '(' || c == ')' || c == 'n' || c == '$') continue;
+        pool += c;
+    }
+    return pool;
+}
+
+// Function to build a layered expression grammar with one non-terminal per
+// precedence level (like Practical-10's E/T/F/G, but deeper and wider)
+GeneratedGrammar layeredGrammar(int levels, int operatorsPerLevel, int prefixOperators) {
+    string pool = operatorPool();
+    GeneratedGrammar g;
+    g.name = "layered-" + to_string(levels) + "x" + to_string(operatorsPerLevel);
+
+    size_t next = 0;
+    for (int level = 0; level < levels; level++) {
+        char self = (char)('A' + level);
+        char lower = (char)('A' + level + 1);
+        Production production = {self, {}};
+        for (int k = 0; k < operatorsPerLevel; k++) {
+            char op = pool[next++];
+            g.binaryOperators += op;
+            production.derivations.push_back(string(1, self) + op + lower);
+        }
+        production.derivations.push_back(string(1, lower));
+        g.grammar.push_back(production);
+    }
+
+    char bottom = (char)('A' + levels);
+    Production atom = {bottom, {"(A)", "n"}};
+    for (int k = 0; k < prefixOperators; k++) {
+        char op = pool[next++];
+        g.prefixOperators += op;
+        atom.derivations.push_back(string(1, op) + bottom);
+    }
+    g.grammar.push_back(atom);
+    return g;
+}
+
+// Function to build the ambiguous form E -> E op E with one precedence level
+// per group of operators, alternating left and right associativity
+GeneratedGrammar ambiguousGrammar(int levels, int operatorsPerLevel) {
+    string pool = operatorPool();
+    GeneratedGrammar g;
+    g.name = "ambiguous-" + to_string(levels) + "x" + to_string(operatorsPerLevel);
+
+    Production production = {'E', {"(E)", "n"}};
+    size_t next = 0;
+    for (int level = 0; level < levels; level++) {
+        PrecedenceLevel declaration = {level % 3 == 2 ? Associativity::Right : Associativity::Left, ""};
+        for (int k = 0; k < operatorsPerLevel; k++) {
+            char op = pool[next++];
+            g.binaryOperators += op;
+            declaration.terminals += op;
+            production.derivations.push_back(string("E") + op + "E");
+        }
+        g.precedence.push_back(declaration);
+    }
+    g.grammar.push_back(production);
+    return g;
+}
+
+// Function to generate a random sentence of roughly the requested length
+void appendOperand(string& out, const GeneratedGrammar& g, mt19937& rng, int depth);
+
+void appendExpression(string& out, const GeneratedGrammar& g, mt19937& rng, size_t length, int depth) {
+    appendOperand(out, g, rng, depth);
+    while (out.size() < length) {
+        out += g.binaryOperators[rng() % g.binaryOperators.size()];
+        appendOperand(out, g, rng, depth);
+    }
+}
+
+void appendOperand(string& out, const GeneratedGrammar& g, mt19937& rng, int depth) {
+    unsigned r = rng() % 16;
+    if (r == 0 && !g.prefixOperators.empty()) {
+        out += g.prefixOperators[rng() % g.prefixOperators.size()];
+        appendOperand(out, g, rng, depth);
+    } else if (r == 1 && depth < 8) {
+        out += '(';
+        appendExpression(out, g, rng, out.size() + 1 + rng() % 40, depth + 1);
+        out += ')';
+    } else {
+        out += 'n';
+    }
+}
+
+// Function to time parsing every sentence with one table encoding
+template <class Tables>
+void benchmarkEncoding(const string& name, const Tables& tables, size_t denseBytes,
+                       const vector<string>& sentences, size_t bytes) {
+    vector<int> stack;
+    size_t accepted = 0;
+    auto start = steady_clock::now();
+    for (const string& sentence : sentences) {
+        accepted += parseLR(sentence, tables, stack);
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    cout << "    " << left << setw(24) << name << right
+         << setw(9) << tables.numColumns
+         << setw(12) << tables.sizeInBytes()
+         << setw(9) << fixed << setprecision(1) << 100.0 * tables.sizeInBytes() / denseBytes << "%"
+         << setw(12) << setprecision(1) << bytes / seconds / 1e6;
+    if (accepted != sentences.size()) cout << "  rejected " << sentences.size() - accepted << " valid sentences";
+    cout << endl;
+}
+
+// Every token is one byte, so Mtok/s is also MB/s of input
+int main(int argc, char** argv) {
+    size_t totalBytes = argc > 1 ? stoul(argv[1]) : 16u << 20;
+    const size_t sentenceLength = 4096;
+    mt19937 rng(42);
+
+    vector<GeneratedGrammar> grammars = {
+        layeredGrammar(4, 2, 1),
+        layeredGrammar(12, 3, 2),
+        layeredGrammar(24, 2, 4),
+        ambiguousGrammar(8, 3),
+        ambiguousGrammar(16, 3),
+    };
+
+    for (const auto& g : grammars) {
+        // Build several times to get a stable construction time
+        const int builds = 5;
+        LALRTable table;
+        auto start = steady_clock::now();
+        for (int i = 0; i < builds; i++) table = buildLALRTable(g.grammar, g.precedence);
+        double buildMs = duration<double, milli>(steady_clock::now() - start).count() / builds;
+
+        cout << g.name << ": " << table.rules.size() << " rules, " << table.numStates << " states, "
+             << table.numTerminals() << " terminals, built in " << fixed << setprecision(2) << buildMs
+             << " ms (" << table.shiftReduceConflicts << " shift/reduce conflicts, "
+             << table.resolvedByPrecedence << " resolved by precedence)" << endl;
+
+        vector<string> sentences;
+        size_t bytes = 0;
+        while (bytes < totalBytes) {
+            string sentence;
+            appendExpression(sentence, g, rng, sentenceLength, 0);
+            bytes += sentence.size();
+            sentences.push_back(move(sentence));
+        }
+
+        DenseLRTables dense = buildDenseTables(table);
+        size_t denseBytes = dense.sizeInBytes();
+        cout << "    " << left << setw(24) << "Encoding" << right << setw(9) << "Columns"
+             << setw(12) << "Bytes" << setw(10) << "Of dense" << setw(12) << "Mtok/s" << endl;
+        benchmarkEncoding("dense", dense, denseBytes, sentences, bytes);
+        benchmarkEncoding("comb", buildCombTables(table), denseBytes, sentences, bytes);
+        benchmarkEncoding("comb+defaults", buildDefaultCombTables(table), denseBytes, sentences, bytes);
+        benchmarkEncoding("classes+shift comb", buildClassTables(table), denseBytes, sentences, bytes);
+        cout << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,418 @@
+#ifndef LL1_H
+#define LL1_H
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <stack>
+#include <iomanip>
+#include "grammar.h"
+
+#ifdef LL1_PROFILE
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#endif
+
+using namespace std;
+
+// Structure to store parsing table cell info
+struct TableEntry {
+    string production;
+    bool isValid;
+
+    TableEntry() : production(""), isValid(true) {}
+    TableEntry(string prod) : production(prod), isValid(true) {}
+};
+
+// Profiling: build with -DLL1_PROFILE and validateString counts, per thread,
+// hits per (non-terminal, lookahead) cell, matched terminals, the deepest
+// stack and where parses fail. mergeLL1Profiles() sums every thread's
+// counters and printLL1Profile() reports them. Without the flag the hooks
+// expand to nothing.
+#ifdef LL1_PROFILE
+#define LL1_PROFILE_ONLY(...) __VA_ARGS__
+
+// Structure to hold one thread's driver counters
+struct LL1Profile {
+    vector<uint64_t> cellHits;                   // 256 x 256, by (non-terminal, lookahead)
+    map<pair<char, char>, uint64_t> errorCells;  // Empty cell reached, by (non-terminal, lookahead)
+    map<pair<char, char>, uint64_t> mismatches;  // Terminal on the stack against the lookahead
+    uint64_t strings = 0;
+    uint64_t accepted = 0;
+    uint64_t matches = 0;
+    size_t maxStackDepth = 0;
+
+    LL1Profile() : cellHits(256 * 256, 0) {}
+
+    void merge(const LL1Profile& other) {
+        for (size_t i = 0; i < cellHits.size(); i++) cellHits[i] += other.cellHits[i];
+        for (const auto& [cell, count] : other.errorCells) errorCells[cell] += count;
+        for (const auto& [cell, count] : other.mismatches) mismatches[cell] += count;
+        strings += other.strings;
+        accepted += other.accepted;
+        matches += other.matches;
+        maxStackDepth = max(maxStackDepth, other.maxStackDepth);
+    }
+};
+
+// Structure to track every thread's counters; a thread that exits folds its
+// counters into retired so nothing is lost
+struct LL1ProfileRegistry {
+    mutex lock;
+    vector<LL1Profile*> live;
+    LL1Profile retired;
+};
+
+inline LL1ProfileRegistry& ll1ProfileRegistry() {
+    static LL1ProfileRegistry registry;
+    return registry;
+}
+
+struct LL1ThreadProfile {
+    LL1Profile counters;
+
+    LL1ThreadProfile() {
+        LL1ProfileRegistry& registry = ll1ProfileRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        registry.live.push_back(&counters);
+    }
+
+    ~LL1ThreadProfile() {
+        LL1ProfileRegistry& registry = ll1ProfileRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        registry.retired.merge(counters);
+        registry.live.erase(find(registry.live.begin(), registry.live.end(), &counters));
+    }
+};
+
+// The calling thread's counters, which only that thread writes
+inline LL1Profile& ll1ThreadProfile() {
+    thread_local LL1ThreadProfile profile;
+    return profile.counters;
+}
+
+// Function to sum the counters of every thread. Call it once the parsing
+// threads are done (or joined); live counters are read without a lock.
+inline LL1Profile mergeLL1Profiles() {
+    LL1ProfileRegistry& registry = ll1ProfileRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    LL1Profile total;
+    total.merge(registry.retired);
+    for (const LL1Profile* counters : registry.live) total.merge(*counters);
+    return total;
+}
+
+// Function to print a profile against the table it was collected on. Cells
+// taking at least hotShare of all expansions are flagged: a hot ε or
+// single non-terminal production is a chain worth inlining into its callers
+// by refactoring the grammar, any other hot cell is worth a specialized path.
+inline void printLL1Profile(const LL1Profile& profile,
+                            const map<char, map<char, TableEntry>>& table,
+                            double hotShare = 0.10) {
+    struct Cell {
+        char nonTerminal;
+        char lookahead;
+        uint64_t hits;
+    };
+    vector<Cell> cells;
+    map<pair<char, string>, uint64_t> expansionsByProduction;
+    uint64_t expansions = 0;
+    for (size_t i = 0; i < profile.cellHits.size(); i++) {
+        if (profile.cellHits[i] == 0) continue;
+        Cell cell = {(char)(i / 256), (char)(i % 256), profile.cellHits[i]};
+        cells.push_back(cell);
+        expansions += cell.hits;
+        expansionsByProduction[{cell.nonTerminal, table.at(cell.nonTerminal).at(cell.lookahead).production}] += cell.hits;
+    }
+    sort(cells.begin(), cells.end(), [](const Cell& a, const Cell& b) { return a.hits > b.hits; });
+
+    auto share = [](uint64_t part, uint64_t whole) { return whole ? 100.0 * part / whole : 0.0; };
+    // setw counts bytes, so the two-byte ε needs one more column
+    auto column = [](const string& text, int width) {
+        int shown = 0;
+        for (char c : text) shown += ((unsigned char)c & 0xC0) != 0x80;
+        return text + string(max(width - shown, 0), ' ');
+    };
+    auto isChain = [](const string& production) {
+        return production == "ε" || (production.size() == 1 && isNonTerminal(production[0]));
+    };
+
+    cout << "\nLL(1) Profile:\n";
+    cout << profile.strings << " strings, " << profile.accepted << " accepted, " << expansions << " expansions, "
+         << profile.matches << " matches, deepest stack " << profile.maxStackDepth << endl;
+
+    cout << "\nTable Cells:\n";
+    cout << left << setw(10) << "Cell" << setw(16) << "Production" << right << setw(14) << "Hits" << setw(9) << "Share"
+         << "  Note" << endl;
+    cout << string(70, '-') << endl;
+    for (const Cell& cell : cells) {
+        const string& production = table.at(cell.nonTerminal).at(cell.lookahead).production;
+        double percent = share(cell.hits, expansions);
+        string note;
+        if (percent >= hotShare * 100) {
+            note = isChain(production) ? "HOT chain, inline into callers" : "HOT, specialize";
+        }
+        cout << left << setw(10) << string("M[") + cell.nonTerminal + "," + cell.lookahead + "]"
+             << column(string(1, cell.nonTerminal) + " -> " + production, 16) << right << setw(14) << cell.hits
+             << setw(8) << fixed << setprecision(1) << percent << "%" << defaultfloat << "  " << note << endl;
+    }
+
+    cout << "\nProductions:\n";
+    vector<pair<pair<char, string>, uint64_t>> productions(expansionsByProduction.begin(), expansionsByProduction.end());
+    sort(productions.begin(), productions.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (const auto& [production, count] : productions) {
+        cout << column(string(1, production.first) + " -> " + production.second, 26) << right << setw(14)
+             << count << setw(8) << fixed << setprecision(1) << share(count, expansions) << "%" << defaultfloat << endl;
+    }
+
+    uint64_t errors = 0;
+    for (const auto& entry : profile.errorCells) errors += entry.second;
+    for (const auto& entry : profile.mismatches) errors += entry.second;
+    if (errors) {
+        cout << "\nErrors:\n";
+        vector<pair<string, uint64_t>> failures;
+        for (const auto& [cell, count] : profile.errorCells) {
+            failures.push_back({string("No production for ") + cell.first + " on " + cell.second, count});
+        }
+        for (const auto& [cell, count] : profile.mismatches) {
+            failures.push_back({string("Expected ") + cell.first + ", got " + cell.second, count});
+        }
+        sort(failures.begin(), failures.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        for (const auto& [failure, count] : failures) {
+            cout << left << setw(30) << failure << right << setw(10) << count << setw(8) << fixed << setprecision(1)
+                 << share(count, errors) << "%" << defaultfloat << endl;
+        }
+    }
+}
+#else
+#define LL1_PROFILE_ONLY(...)
+#endif
+
+// Construct the predictive parsing table
+inline map<char, map<char, TableEntry>> constructParsingTable(
+    const vector<Production>& grammar,
+    const map<char, set<char>>& firstSets,
+    const map<char, set<char>>& followSets,
+    bool& isLL1,
+    const set<char>& terminals) {
+
+    map<char, map<char, TableEntry>> table;
+    isLL1 = true;
+
+    // Initialize table cells
+    for (const auto& production : grammar) {
+        char nonTerminal = production.nonTerminal;
+        for (char terminal : terminals) {
+            table[nonTerminal][terminal] = TableEntry();
+        }
+        table[nonTerminal]['$'] = TableEntry();
+    }
+
+    // Fill the table
+    for (const auto& production : grammar) {
+        char nonTerminal = production.nonTerminal;
+
+        for (const string& derivation : production.derivations) {
+            set<char> firstOfDerivation = calculateFirstOfString(derivation, firstSets);
+
+            for (char terminal : firstOfDerivation) {
+                if (terminal != EPSILON) {
+                    // If already has an entry, it's not LL(1)
+                    if (!table[nonTerminal][terminal].production.empty()) {
+                        isLL1 = false;
+                        table[nonTerminal][terminal].isValid = false;
+                    }
+                    table[nonTerminal][terminal].production = derivation;
+                } else {
+                    // For epsilon, use Follow set
+                    for (char followTerminal : followSets.at(nonTerminal)) {
+                        if (!table[nonTerminal][followTerminal].production.empty()) {
+                            isLL1 = false;
+                            table[nonTerminal][followTerminal].isValid = false;
+                        }
+                        table[nonTerminal][followTerminal].production = derivation;
+                    }
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+// Function to build the parsing table straight from a grammar, for callers
+// that need neither the First/Follow sets nor the LL(1) flag
+inline map<char, map<char, TableEntry>> buildParsingTable(const vector<Production>& grammar) {
+    map<char, set<char>> firstSets = computeFirstSets(grammar);
+    map<char, set<char>> followSets = computeFollowSets(grammar, firstSets);
+    bool isLL1;
+    return constructParsingTable(grammar, firstSets, followSets, isLL1, getTerminals(grammar));
+}
+
+// Function to print a table cell right-aligned in 'width' columns. setw
+// pads by bytes, and ε is two bytes in UTF-8 but one column on screen.
+inline void printCell(const string& entry, int width) {
+    int columns = 0;
+    for (unsigned char c : entry) columns += (c & 0xC0) != 0x80;
+    cout << string(columns < width ? width - columns : 0, ' ') << entry;
+}
+
+// Print the parsing table
+inline void printParsingTable(const map<char, map<char, TableEntry>>& table,
+                              const vector<char>& nonTerminals,
+                              const set<char>& terminals) {
+    cout << "\nPredictive Parsing Table:\n";
+
+    // Print the header
+    cout << setw(5) << " ";
+    for (char terminal : terminals) {
+        cout << setw(10) << terminal;
+    }
+    cout << setw(10) << "$";
+    cout << endl;
+
+    // Calculate width for separator line
+    int lineWidth = 5 + (terminals.size() + 1) * 10;
+
+    // Print separator line
+    cout << string(lineWidth, '-') << endl;
+
+    // Print table rows
+    for (char nonTerminal : nonTerminals) {
+        cout << setw(5) << nonTerminal;
+        for (char terminal : terminals) {
+            string entry = table.at(nonTerminal).at(terminal).production;
+            if (entry.empty()) {
+                printCell("-", 10);
+            } else if (!table.at(nonTerminal).at(terminal).isValid) {
+                printCell(entry + "*", 10); // Mark conflicts
+            } else {
+                printCell(entry, 10);
+            }
+        }
+
+        // Print entry for $
+        string dollarEntry = table.at(nonTerminal).at('$').production;
+        if (dollarEntry.empty()) {
+            printCell("-", 10);
+        } else if (!table.at(nonTerminal).at('$').isValid) {
+            printCell(dollarEntry + "*", 10); // Mark conflicts
+        } else {
+            printCell(dollarEntry, 10);
+        }
+
+        cout << endl;
+    }
+}
+
+// Validate input string using the parsing table
+inline bool validateString(const string& input,
+                          const map<char, map<char, TableEntry>>& table,
+                          char startSymbol,
+                          bool showSteps) {
+    stack<char> parseStack;
+    size_t index = 0;
+
+    // Push end marker and start symbol
+    parseStack.push('$');
+    parseStack.push(startSymbol);
+    LL1_PROFILE_ONLY(LL1Profile& profile = ll1ThreadProfile(); profile.strings++;)
+
+    string inputWithEndMarker = input + "$";
+
+    if (showSteps) {
+        cout << "\nParsing Steps for \"" << input << "\":" << endl;
+        cout << left << setw(20) << "Stack" << setw(20) << "Input" << "Action" << endl;
+        cout << string(60, '-') << endl;
+    }
+
+    while (!parseStack.empty()) {
+        // Get top of stack and current input
+        char top = parseStack.top();
+        char currentInput = inputWithEndMarker[index];
+
+        if (showSteps) {
+            string stackStr = "";
+            stack<char> tempStack = parseStack;
+            while (!tempStack.empty()) {
+                stackStr = tempStack.top() + stackStr;
+                tempStack.pop();
+            }
+
+            // Print current state
+            cout << left << setw(20) << stackStr << setw(20) << inputWithEndMarker.substr(index);
+        }
+
+        // If top is a terminal, it should match current input
+        if (isTerminal(top) || top == '$') {
+            if (top == currentInput) {
+                if (showSteps) {
+                    cout << "Match and pop " << top << endl;
+                }
+                parseStack.pop();
+                index++;
+                LL1_PROFILE_ONLY(profile.matches++;)
+            } else {
+                if (showSteps) {
+                    cout << "Error: Expected " << top << ", got " << currentInput << endl;
+                }
+                LL1_PROFILE_ONLY(profile.mismatches[{top, currentInput}]++;)
+                return false;
+            }
+        }
+        // If top is a non-terminal, look up in table
+        else if (isNonTerminal(top)) {
+            if (table.count(top) == 0 || table.at(top).count(currentInput) == 0 ||
+                table.at(top).at(currentInput).production.empty()) {
+                if (showSteps) {
+                    cout << "Error: No production for " << top << " on input " << currentInput << endl;
+                }
+                LL1_PROFILE_ONLY(profile.errorCells[{top, currentInput}]++;)
+                return false;
+            }
+            LL1_PROFILE_ONLY(profile.cellHits[(unsigned char)top * 256 + (unsigned char)currentInput]++;)
+
+            string production = table.at(top).at(currentInput).production;
+            if (showSteps) {
+                cout << "Apply " << top << " -> " << production << endl;
+            }
+
+            parseStack.pop(); // Pop the non-terminal
+
+            // Push the production in reverse order
+            if (production != "ε") {
+                for (int i = production.length() - 1; i >= 0; i--) {
+                    parseStack.push(production[i]);
+                }
+            }
+            LL1_PROFILE_ONLY(profile.maxStackDepth = max(profile.maxStackDepth, parseStack.size());)
+        }
+    }
+
+    LL1_PROFILE_ONLY(profile.accepted++;)
+    return true;
+}
+
+// Parse and validate multiple test cases
+inline void validateMultipleStrings(const vector<string>& testCases,
+                                   const map<char, map<char, TableEntry>>& table,
+                                   char startSymbol,
+                                   bool showDetails) {
+    cout << "\nValidating Test Cases:" << endl;
+    cout << string(60, '-') << endl;
+
+    for (const string& testCase : testCases) {
+        bool isValid = validateString(testCase, table, startSymbol, showDetails);
+        cout << "\"" << testCase << "\" is " << (isValid ? "Valid" : "Invalid") << " string" << endl;
+
+        if (showDetails) {
+            cout << string(60, '-') << endl;
+        }
+    }
+}
+
+#endif
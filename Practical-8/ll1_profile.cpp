@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include "grammar.h"
+#include "ll1.h"
+#include "sentences.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Profiles the LL(1) driver on generated expressions, parsed by several
+// threads at once. Build it twice to see what the counters cost:
+//   g++ -std=c++17 -O2 -pthread -DLL1_PROFILE ll1_profile.cpp   (report)
+//   g++ -std=c++17 -O2 -pthread ll1_profile.cpp                 (timing only)
+// Usage: ll1_profile [threads] [sentences per thread] [mutation rate]
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? atoi(argv[1]) : 4;
+    size_t count = argc > 2 ? strtoull(argv[2], nullptr, 10) : 20000;
+    SentenceOptions options;
+    options.minLength = 1;
+    options.maxLength = 200;
+    options.mutationRate = argc > 3 ? atof(argv[3]) : 0.1;
+
+    vector<Production> grammar = expressionGrammar();
+    map<char, map<char, TableEntry>> table = buildParsingTable(grammar);
+
+    // Each thread parses its own corpus, generated before the clock starts
+    vector<vector<string>> corpora(threads);
+    size_t bytes = 0;
+    for (int t = 0; t < threads; t++) {
+        SentenceGenerator generator(grammar, 'E', 43 + t);
+        corpora[t].resize(count);
+        for (string& sentence : corpora[t]) {
+            generator.next(sentence, options);
+            bytes += sentence.size();
+        }
+    }
+
+    vector<size_t> accepted(threads, 0);
+    auto start = steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (const string& sentence : corpora[t]) accepted[t] += validateString(sentence, table, 'E', false);
+        });
+    }
+    for (thread& worker : workers) worker.join();
+    double ms = duration<double, milli>(steady_clock::now() - start).count();
+
+    size_t total = 0;
+    for (size_t a : accepted) total += a;
+    cout << threads << " threads parsed " << threads * count << " strings (" << bytes << " bytes) in " << ms
+         << " ms, " << bytes / ms / 1e3 << " MB/s; " << total << " accepted" << endl;
+
+#ifdef LL1_PROFILE
+    printLL1Profile(mergeLL1Profiles(), table);
+#else
+    cout << "Built without -DLL1_PROFILE, so no counters were kept" << endl;
+#endif
+    return 0;
+}
@@ -0,0 +1,477 @@
+#ifndef LLK_H
+#define LLK_H
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include "grammar.h"
+
+using namespace std;
+
+// LL(k) parsing for grammars whose LL(1) table has conflicts. The table is
+// the LL(1) table with every conflicting cell replaced by a lookahead trie:
+// the cell's own terminal is the first symbol, and the trie branches on the
+// next ones, only as deep as it takes to tell the productions apart (at
+// most maxK). Cells without a conflict stay a single lookup.
+//
+// Lookaheads are strong LL(k): a production's lookahead strings are
+// First_k(derivation Follow_k(A)), whatever the context A was expanded in.
+// A lookahead string ends early with '$' when the input can end there.
+// Conflicts left at maxK take the first production in grammar order, and
+// isLLk() is false; BacktrackingParser handles such grammars instead.
+
+// Function to concatenate two sets of lookahead strings, cut to k symbols.
+// Strings that are k long or end with '$' are complete and stay as they are.
+inline set<string> concatenateK(const set<string>& left, const set<string>& right, size_t k) {
+    set<string> result;
+    for (const string& prefix : left) {
+        if (prefix.size() >= k || (!prefix.empty() && prefix.back() == '$')) {
+            result.insert(prefix);
+            continue;
+        }
+        for (const string& suffix : right) result.insert((prefix + suffix).substr(0, k));
+    }
+    return result;
+}
+
+// Function to compute First_k of a string of grammar symbols
+inline set<string> firstKOfString(const string& symbols, const map<char, set<string>>& firstK, size_t k) {
+    set<string> result = {""};
+    if (symbols == "ε") return result;
+    for (char symbol : symbols) {
+        if (isNonTerminal(symbol)) {
+            auto found = firstK.find(symbol);
+            result = concatenateK(result, found == firstK.end() ? set<string>() : found->second, k);
+        } else {
+            result = concatenateK(result, {string(1, symbol)}, k);
+        }
+    }
+    return result;
+}
+
+// Function to compute First_k sets for all non-terminals
+inline map<char, set<string>> computeFirstKSets(const vector<Production>& grammar, size_t k) {
+    map<char, set<string>> firstK;
+    for (const auto& production : grammar) firstK[production.nonTerminal];
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& production : grammar) {
+            set<string>& first = firstK[production.nonTerminal];
+            for (const string& derivation : production.derivations) {
+                for (const string& lookahead : firstKOfString(derivation, firstK, k)) {
+                    changed |= first.insert(lookahead).second;
+                }
+            }
+        }
+    }
+    return firstK;
+}
+
+// Function to compute Follow_k sets, with grammar[0] as the start symbol
+inline map<char, set<string>> computeFollowKSets(const vector<Production>& grammar,
+                                                 const map<char, set<string>>& firstK,
+                                                 size_t k) {
+    map<char, set<string>> followK;
+    for (const auto& production : grammar) followK[production.nonTerminal];
+    followK[grammar[0].nonTerminal].insert("$");
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& production : grammar) {
+            for (const string& derivation : production.derivations) {
+                if (derivation == "ε") continue;
+                for (size_t i = 0; i < derivation.size(); i++) {
+                    if (!isNonTerminal(derivation[i])) continue;
+                    set<string> follow = concatenateK(firstKOfString(derivation.substr(i + 1), firstK, k),
+                                                      followK[production.nonTerminal], k);
+                    for (const string& lookahead : follow) changed |= followK[derivation[i]].insert(lookahead).second;
+                }
+            }
+        }
+    }
+    return followK;
+}
+
+// Structure to count what the LL(k) driver did
+struct LLkStats {
+    size_t expansions = 0;
+    size_t trieLookups = 0;     // Expansions that needed more than one symbol
+    size_t deepestLookahead = 1;
+};
+
+// Structure to report the size of an LL(k) table
+struct LLkTableSize {
+    size_t rows = 0, columns = 0;
+    size_t filledCells = 0;
+    size_t conflictCells = 0;
+    size_t trieNodes = 0, trieEdges = 0;
+    size_t bytes = 0;
+    size_t fullTableEntries = 0; // (non-terminal, k-string) pairs a plain LL(k) table would hold
+};
+
+class LLkTable {
+    // A trie node decides a production, or branches on the next symbol
+    struct LookaheadNode {
+        int production;         // -1 while undecided
+        int firstEdge;
+        int edgeCount;
+    };
+
+    struct ConflictCell {
+        char nonTerminal;
+        char lookahead;
+        vector<int> candidates;
+        int root = -1;
+        size_t depth = 1;       // Lookahead the trie needs
+        bool resolved = false;
+    };
+
+    vector<char> owners;                // Production index to non-terminal
+    vector<string> derivations;         // As written, "ε" for empty
+    vector<string> reversed;            // Ready to push
+    int rowOf[256];                     // 0, an all-error row, for non-terminals without productions
+    int columnOf[256];                  // 0 for symbols no production expects
+    size_t columns = 1;
+    vector<int> cells;                  // Production, -1 for error, or -(trie root + 2)
+    vector<LookaheadNode> nodes;
+    vector<pair<char, int>> edges;
+    vector<ConflictCell> conflicts;
+    char startSymbol;
+    size_t maxK;
+    size_t fullEntries = 0;
+
+    int& cell(char nonTerminal, char lookahead) {
+        return cells[rowOf[(unsigned char)nonTerminal] * columns + columnOf[(unsigned char)lookahead]];
+    }
+
+    // Function to build the trie below a prefix of 'depth' symbols from
+    // lookahead strings that all share it
+    int buildTrie(const vector<pair<string, int>>& strings, size_t depth) {
+        int index = (int)nodes.size();
+        nodes.push_back({-1, 0, 0});
+        bool decided = true;
+        for (const auto& entry : strings) decided &= entry.second == strings[0].second;
+        if (decided || strings[0].first.size() <= depth) {
+            nodes[index].production = strings[0].second;
+            return index;
+        }
+
+        // The strings are sorted, so each next symbol is a contiguous run
+        vector<pair<char, vector<pair<string, int>>>> groups;
+        for (const auto& entry : strings) {
+            char symbol = entry.first[depth];
+            if (groups.empty() || groups.back().first != symbol) groups.push_back({symbol, {}});
+            groups.back().second.push_back(entry);
+        }
+        int firstEdge = (int)edges.size();
+        edges.resize(edges.size() + groups.size());
+        nodes[index].firstEdge = firstEdge;
+        nodes[index].edgeCount = (int)groups.size();
+        for (size_t g = 0; g < groups.size(); g++) {
+            int child = buildTrie(groups[g].second, depth + 1);
+            edges[firstEdge + g] = {groups[g].first, child};
+        }
+        return index;
+    }
+
+    // Function to give each conflicting cell a trie over its candidates'
+    // lookahead strings at k, if they no longer overlap or k is the last try
+    void resolveConflicts(const vector<Production>& grammar, size_t k) {
+        map<char, set<string>> firstK = computeFirstKSets(grammar, k);
+        map<char, set<string>> followK = computeFollowKSets(grammar, firstK, k);
+        vector<set<string>> lookaheads(derivations.size());
+        for (size_t p = 0; p < derivations.size(); p++) {
+            lookaheads[p] = concatenateK(firstKOfString(derivations[p], firstK, k), followK[owners[p]], k);
+        }
+        if (k == maxK) {
+            fullEntries = 0;
+            for (const set<string>& strings : lookaheads) fullEntries += strings.size();
+        }
+
+        for (ConflictCell& conflict : conflicts) {
+            if (conflict.resolved) continue;
+            map<string, int> choice;
+            bool overlap = false;
+            for (int p : conflict.candidates) {
+                for (const string& lookahead : lookaheads[p]) {
+                    if (lookahead[0] != conflict.lookahead) continue;
+                    // Candidates are in grammar order, so the first one keeps the string
+                    overlap |= !choice.insert({lookahead, p}).second;
+                }
+            }
+            if (overlap && k < maxK) continue;
+            conflict.resolved = !overlap;
+            conflict.depth = k;
+            conflict.root = buildTrie(vector<pair<string, int>>(choice.begin(), choice.end()), 1);
+            cell(conflict.nonTerminal, conflict.lookahead) = -(conflict.root + 2);
+        }
+    }
+
+public:
+    LLkTable(const vector<Production>& grammar, size_t maxLookahead = 3)
+        : startSymbol(grammar[0].nonTerminal), maxK(max<size_t>(maxLookahead, 1)) {
+        fill(begin(rowOf), end(rowOf), 0);
+        fill(begin(columnOf), end(columnOf), 0);
+        int rows = 0;
+        for (const auto& production : grammar) {
+            if (!rowOf[(unsigned char)production.nonTerminal]) rowOf[(unsigned char)production.nonTerminal] = ++rows;
+            for (const string& derivation : production.derivations) {
+                owners.push_back(production.nonTerminal);
+                derivations.push_back(derivation);
+                reversed.push_back(derivation == "ε" ? "" : string(derivation.rbegin(), derivation.rend()));
+                for (char symbol : derivation) {
+                    if (derivation != "ε" && !isNonTerminal(symbol) && !columnOf[(unsigned char)symbol]) {
+                        columnOf[(unsigned char)symbol] = (int)columns++;
+                    }
+                }
+            }
+        }
+        columnOf[(unsigned char)'$'] = (int)columns++;
+        cells.assign((rows + 1) * columns, -1);
+
+        // The LL(1) table first; a cell more than one production wants
+        // becomes a conflict
+        map<char, set<string>> first = computeFirstKSets(grammar, 1);
+        map<char, set<string>> follow = computeFollowKSets(grammar, first, 1);
+        map<pair<char, char>, vector<int>> wanted;
+        for (size_t p = 0; p < derivations.size(); p++) {
+            set<string> lookaheads = concatenateK(firstKOfString(derivations[p], first, 1), follow[owners[p]], 1);
+            for (const string& lookahead : lookaheads) wanted[{owners[p], lookahead[0]}].push_back((int)p);
+        }
+        for (const auto& [key, candidates] : wanted) {
+            cell(key.first, key.second) = candidates[0];
+            if (candidates.size() > 1) {
+                ConflictCell conflict;
+                conflict.nonTerminal = key.first;
+                conflict.lookahead = key.second;
+                conflict.candidates = candidates;
+                conflicts.push_back(conflict);
+            }
+        }
+        // Deeper lookahead only while conflicts are left; maxK always runs,
+        // to count what a plain LL(k) table would hold
+        for (size_t k = min<size_t>(2, maxK); k <= maxK; k++) {
+            if (k == maxK || !isLLk()) resolveConflicts(grammar, k);
+        }
+    }
+
+    // Function to parse a string; the driver of validateString, reading
+    // further ahead only in a conflicting cell
+    bool parse(const string& input, LLkStats* stats = nullptr) const {
+        vector<char> stack = {'$', startSymbol};
+        size_t pos = 0, n = input.size();
+        while (true) {
+            char top = stack.back();
+            char lookahead = pos < n ? input[pos] : '$';
+            if (!isNonTerminal(top)) {
+                if (top != lookahead) return false;
+                stack.pop_back();
+                if (top == '$') return true;
+                pos++;
+                continue;
+            }
+
+            int production = cells[rowOf[(unsigned char)top] * columns + columnOf[(unsigned char)lookahead]];
+            if (production < -1) {
+                // Walk the trie on the symbols after the lookahead
+                int node = -production - 2;
+                size_t depth = 1;
+                while (nodes[node].production < 0) {
+                    char symbol = pos + depth < n ? input[pos + depth] : '$';
+                    const LookaheadNode& branch = nodes[node];
+                    node = -1;
+                    for (int e = branch.firstEdge; e < branch.firstEdge + branch.edgeCount; e++) {
+                        if (edges[e].first == symbol) {
+                            node = edges[e].second;
+                            break;
+                        }
+                    }
+                    if (node < 0) return false;
+                    depth++;
+                }
+                production = nodes[node].production;
+                if (stats) {
+                    stats->trieLookups++;
+                    stats->deepestLookahead = max(stats->deepestLookahead, depth);
+                }
+            }
+            if (production < 0) return false;
+            if (stats) stats->expansions++;
+            stack.pop_back();
+            stack.insert(stack.end(), reversed[production].begin(), reversed[production].end());
+        }
+    }
+
+    // True when every conflict was resolved within maxK symbols
+    bool isLLk() const {
+        return all_of(conflicts.begin(), conflicts.end(), [](const ConflictCell& conflict) { return conflict.resolved; });
+    }
+
+    // The lookahead the table needs: 1 without conflicts
+    size_t lookahead() const {
+        size_t k = 1;
+        for (const ConflictCell& conflict : conflicts) k = max(k, conflict.depth);
+        return k;
+    }
+
+    LLkTableSize size() const {
+        LLkTableSize size;
+        size.rows = cells.size() / columns;
+        size.columns = columns;
+        size.filledCells = count_if(cells.begin(), cells.end(), [](int value) { return value != -1; });
+        size.conflictCells = conflicts.size();
+        size.trieNodes = nodes.size();
+        size.trieEdges = edges.size();
+        size.bytes = cells.size() * sizeof(int) + nodes.size() * sizeof(LookaheadNode) +
+                     edges.size() * sizeof(pair<char, int>);
+        size.fullTableEntries = fullEntries;
+        return size;
+    }
+
+    // Function to print each conflicting cell and the trie that settles it
+    void printConflicts() const {
+        if (conflicts.empty()) {
+            cout << "No LL(1) conflicts" << endl;
+            return;
+        }
+        for (const ConflictCell& conflict : conflicts) {
+            cout << "M[" << conflict.nonTerminal << "," << conflict.lookahead << "]: " << conflict.nonTerminal << " ->";
+            for (size_t c = 0; c < conflict.candidates.size(); c++) {
+                cout << (c ? " | " : " ") << derivations[conflict.candidates[c]];
+            }
+            if (conflict.resolved) {
+                cout << ", LL(" << conflict.depth << ")" << endl;
+            } else {
+                cout << ", still a conflict at k = " << maxK << ", the first production wins" << endl;
+            }
+            printTrie(conflict.root, string(1, conflict.lookahead));
+        }
+    }
+
+    void printTrie(int node, const string& prefix) const {
+        if (nodes[node].production >= 0) {
+            cout << "    " << left << setw(8) << prefix << right << owners[nodes[node].production] << " -> "
+                 << derivations[nodes[node].production] << endl;
+            return;
+        }
+        for (int e = nodes[node].firstEdge; e < nodes[node].firstEdge + nodes[node].edgeCount; e++) {
+            printTrie(edges[e].second, prefix + edges[e].first);
+        }
+    }
+};
+
+// Structure to count what the backtracking parser did
+struct BacktrackStats {
+    size_t expansions = 0;
+    size_t backtracks = 0;
+    size_t maxChoicePoints = 0;
+};
+
+// A parser that tries a conflicting cell's productions in grammar order and
+// backs up to the latest choice when the input stops matching, so it takes
+// any grammar without left recursion. The stack is a chain of nodes shared
+// between choice points, so backing up costs no copying.
+class BacktrackingParser {
+    struct StackNode {
+        char symbol;
+        int parent;
+    };
+
+    struct ChoicePoint {
+        size_t pos;
+        int below;              // Stack under the expanded non-terminal
+        int cell;
+        size_t next;            // Next candidate to try
+        size_t nodeMark;        // Nodes from here on were pushed after the choice
+    };
+
+    vector<string> reversed;
+    vector<vector<int>> candidates; // 256 x 256: (non-terminal, lookahead) to productions
+    char startSymbol;
+    vector<StackNode> nodes;
+    vector<ChoicePoint> choices;
+
+    int expand(int below, int production) {
+        for (char symbol : reversed[production]) {
+            nodes.push_back({symbol, below});
+            below = (int)nodes.size() - 1;
+        }
+        return below;
+    }
+
+public:
+    BacktrackingParser(const vector<Production>& grammar) : candidates(256 * 256), startSymbol(grammar[0].nonTerminal) {
+        map<char, set<string>> first = computeFirstKSets(grammar, 1);
+        map<char, set<string>> follow = computeFollowKSets(grammar, first, 1);
+        for (const auto& production : grammar) {
+            for (const string& derivation : production.derivations) {
+                int index = (int)reversed.size();
+                reversed.push_back(derivation == "ε" ? "" : string(derivation.rbegin(), derivation.rend()));
+                for (const string& lookahead :
+                     concatenateK(firstKOfString(derivation, first, 1), follow[production.nonTerminal], 1)) {
+                    candidates[(unsigned char)production.nonTerminal * 256 + (unsigned char)lookahead[0]].push_back(index);
+                }
+            }
+        }
+    }
+
+    bool parse(const string& input, BacktrackStats* stats = nullptr) {
+        nodes.clear();
+        choices.clear();
+        nodes.push_back({'$', -1});
+        nodes.push_back({startSymbol, 0});
+        int top = 1;
+        size_t pos = 0, n = input.size();
+        while (true) {
+            char symbol = nodes[top].symbol;
+            char lookahead = pos < n ? input[pos] : '$';
+            bool failed = false;
+            if (!isNonTerminal(symbol)) {
+                if (symbol == lookahead) {
+                    if (symbol == '$') return true;
+                    pos++;
+                    top = nodes[top].parent;
+                    continue;
+                }
+                failed = true;
+            } else {
+                int cell = (unsigned char)symbol * 256 + (unsigned char)lookahead;
+                const vector<int>& alternatives = candidates[cell];
+                if (alternatives.empty()) {
+                    failed = true;
+                } else {
+                    int below = nodes[top].parent;
+                    if (alternatives.size() > 1) {
+                        choices.push_back({pos, below, cell, 1, nodes.size()});
+                        if (stats) stats->maxChoicePoints = max(stats->maxChoicePoints, choices.size());
+                    }
+                    top = expand(below, alternatives[0]);
+                    if (stats) stats->expansions++;
+                }
+            }
+            if (!failed) continue;
+
+            // Back up to the latest choice and take its next candidate
+            if (choices.empty()) return false;
+            ChoicePoint& choice = choices.back();
+            nodes.resize(choice.nodeMark);
+            pos = choice.pos;
+            const vector<int>& alternatives = candidates[choice.cell];
+            int production = alternatives[choice.next++];
+            int below = choice.below;
+            if (choice.next == alternatives.size()) choices.pop_back();
+            top = expand(below, production);
+            if (stats) {
+                stats->backtracks++;
+                stats->expansions++;
+            }
+        }
+    }
+};
+
+#endif // LLK_H
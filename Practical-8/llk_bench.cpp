@@ -0,0 +1,110 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "grammar.h"
+#include "sentences.h"
+#include "bench_timer.h"
+#include "transform.h"
+#include "llk.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Structure to name a grammar for the report
+struct NamedGrammar {
+    string name;
+    vector<Production> grammar;
+};
+
+// Usage: llk_bench [megabytes per grammar] [maximum k]
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 4;
+    size_t maxK = argc > 2 ? strtoull(argv[2], nullptr, 10) : 3;
+
+    vector<NamedGrammar> grammars = {
+        // LL(1) already: the tries must not cost it anything
+        {"expression", expressionGrammar()},
+        // Assignments and calls all start with an identifier: LL(3)
+        {"statements", {{'P', {"SP", "ε"}}, {'S', {"i=E;", "i(E);", "i();"}}, {'E', {"i+E", "i", "(E)"}}}},
+        // Runs of c before x or y: no k is enough
+        {"not LL(k)", {{'S', {"Ax", "By"}}, {'A', {"cA", "ε"}}, {'B', {"cB", "ε"}}}},
+    };
+
+    for (const NamedGrammar& named : grammars) {
+        const vector<Production>& grammar = named.grammar;
+        cout << "Grammar " << named.name << ":" << endl;
+        printGrammar(grammar);
+
+        auto start = steady_clock::now();
+        LLkTable table(grammar, maxK);
+        double buildMs = duration<double, milli>(steady_clock::now() - start).count();
+        BacktrackingParser backtracking(grammar);
+        table.printConflicts();
+        LLkTableSize size = table.size();
+        cout << (table.isLLk() ? "LL(" + to_string(table.lookahead()) + ")" : "Not LL(" + to_string(maxK) + ")")
+             << ": " << size.rows << " x " << size.columns << " cells (" << size.filledCells << " filled), "
+             << size.conflictCells << " conflicts, " << size.trieNodes << " trie nodes, " << size.trieEdges
+             << " edges, " << size.bytes << " bytes, built in " << fixed << setprecision(2) << buildMs << " ms"
+             << defaultfloat << endl;
+        cout << "A plain LL(" << maxK << ") table would hold " << size.fullTableEntries << " entries" << endl;
+
+        // Both parsers must agree on valid and mutated sentences
+        SentenceGenerator generator(grammar, grammar[0].nonTerminal, 47);
+        SentenceOptions options;
+        options.maxLength = 40;
+        options.mutationRate = 0.3;
+        size_t samples = 5000, agreed = 0, accepted = 0;
+        string sentence;
+        for (size_t s = 0; s < samples; s++) {
+            generator.next(sentence, options);
+            bool expected = backtracking.parse(sentence);
+            agreed += table.parse(sentence) == expected;
+            accepted += expected;
+        }
+        cout << "The LL(k) table and the backtracking parser agree on " << agreed << " of " << samples
+             << " sentences (" << accepted << " accepted)" << endl;
+
+        // Speed on valid sentences
+        options.maxLength = 256;
+        options.mutationRate = 0;
+        vector<string> inputs;
+        size_t bytes = 0;
+        while (bytes < megabytes << 20) {
+            generator.next(sentence, options);
+            inputs.push_back(sentence);
+            bytes += sentence.size();
+        }
+        LLkStats tableStats;
+        BacktrackStats backtrackStats;
+        size_t tableAccepted = 0, backtrackAccepted = 0;
+        double tableMs = bestOfThree([&]() {
+            tableStats = LLkStats();
+            tableAccepted = 0;
+            for (const string& input : inputs) tableAccepted += table.parse(input, &tableStats);
+        });
+        double backtrackMs = bestOfThree([&]() {
+            backtrackStats = BacktrackStats();
+            backtrackAccepted = 0;
+            for (const string& input : inputs) backtrackAccepted += backtracking.parse(input, &backtrackStats);
+        });
+
+        double megabyte = bytes / 1048576.0;
+        cout << "\n" << inputs.size() << " sentences, " << bytes << " bytes:" << endl;
+        cout << left << setw(14) << "Parser" << right << setw(10) << "ms" << setw(10) << "MB/s" << setw(10) << "Accepted"
+             << "  Work" << endl;
+        cout << string(70, '-') << endl;
+        cout << left << setw(14) << "LL(k) table" << right << fixed << setprecision(1) << setw(10) << tableMs << setw(10)
+             << megabyte / tableMs * 1000 << setw(10) << tableAccepted << "  " << tableStats.expansions
+             << " expansions, " << tableStats.trieLookups << " past the first symbol, deepest "
+             << tableStats.deepestLookahead << endl;
+        cout << left << setw(14) << "Backtracking" << right << setw(10) << backtrackMs << setw(10)
+             << megabyte / backtrackMs * 1000 << setw(10) << backtrackAccepted << "  " << backtrackStats.expansions
+             << " expansions, " << backtrackStats.backtracks << " backtracks, up to " << backtrackStats.maxChoicePoints
+             << " choice points" << defaultfloat << endl;
+        cout << "\n" << string(70, '=') << "\n" << endl;
+    }
+    return 0;
+}
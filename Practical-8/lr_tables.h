@@ -0,0 +1,377 @@
+#ifndef LR_TABLES_H
+#define LR_TABLES_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <climits>
+#include "lalr.h"
+
+using namespace std;
+
+// Compressed encodings of the LALR(1) ACTION/GOTO tables. Every encoding
+// offers actionAt(state, column) and gotoAt(state, nonTerminal) so the same
+// parser driver (parseLR) runs on any of them.
+
+// Marks a cell with no explicit entry while the tables are being compressed
+const int NO_ENTRY = INT_MIN;
+
+// Row-displacement ("comb") packing of a sparse 2-D table. Row r keeps its
+// entries at value[base[r] + column]; check[] tells which row owns a slot.
+struct CombTable {
+    vector<int> base;
+    vector<int> value;
+    vector<int> check;
+    int emptyValue = 0;
+
+    int lookup(int row, int column) const {
+        int i = base[row] + column;
+        return check[i] == row ? value[i] : emptyValue;
+    }
+
+    size_t sizeInBytes() const {
+        return (base.size() + value.size() + check.size()) * sizeof(int);
+    }
+};
+
+// Data shared by every encoding
+struct LRTablesBase {
+    vector<int> ruleLength;
+    vector<int> ruleLhs;      // Left side of each rule, numbered from 0
+    int columnOf[256];        // ACTION column of each input byte, -1 if none
+    int endColumn = 0;        // ACTION column of $
+    int numColumns = 0;       // Terminals, or terminal classes when merged
+    int numNonTerminals = 0;
+};
+
+// Plain 2-D arrays
+struct DenseLRTables : LRTablesBase {
+    vector<int> action;
+    vector<int> gotoTable;
+
+    int actionAt(int state, int column) const { return action[state * numColumns + column]; }
+    int gotoAt(int state, int nonTerminal) const { return gotoTable[state * numNonTerminals + nonTerminal]; }
+    size_t sizeInBytes() const { return (action.size() + gotoTable.size()) * sizeof(int); }
+};
+
+// ACTION and GOTO rows packed into comb vectors
+struct CombLRTables : LRTablesBase {
+    CombTable action;
+    CombTable gotoTable;
+
+    int actionAt(int state, int column) const { return action.lookup(state, column); }
+    int gotoAt(int state, int nonTerminal) const { return gotoTable.lookup(state, nonTerminal); }
+    size_t sizeInBytes() const { return action.sizeInBytes() + gotoTable.sizeInBytes(); }
+};
+
+// Comb vectors with a default reduction per state and a default target per
+// GOTO column, so only the entries that differ from the default are stored.
+// Default reductions may reduce before an error is noticed, but an erroneous
+// token is never shifted.
+struct DefaultCombLRTables : LRTablesBase {
+    CombTable action;
+    vector<int> defaultAction;
+    CombTable gotoColumns;    // One row per non-terminal, indexed by state
+    vector<int> defaultGoto;
+
+    int actionAt(int state, int column) const {
+        int i = action.base[state] + column;
+        return action.check[i] == state ? action.value[i] : defaultAction[state];
+    }
+    int gotoAt(int state, int nonTerminal) const {
+        int i = gotoColumns.base[nonTerminal] + state;
+        return gotoColumns.check[i] == nonTerminal ? gotoColumns.value[i] : defaultGoto[nonTerminal];
+    }
+    size_t sizeInBytes() const {
+        return action.sizeInBytes() + gotoColumns.sizeInBytes() +
+               (defaultAction.size() + defaultGoto.size()) * sizeof(int);
+    }
+};
+
+// Terminals that are shifted in the same states and reduce identically
+// everywhere else form a class. Reductions and errors are looked up per class
+// in a small dense table; shift targets, which always differ per terminal,
+// come from a comb vector. columnOf still gives the terminal, while
+// numColumns counts the classes.
+const int SHIFT_ENTRY = INT_MAX;
+
+struct ClassLRTables : LRTablesBase {
+    vector<int> classOf;
+    vector<int> classAction;  // numStates x numColumns: a reduction, an error or SHIFT_ENTRY
+    CombTable shifts;
+    CombTable gotoColumns;
+    vector<int> defaultGoto;
+
+    int actionAt(int state, int terminal) const {
+        int action = classAction[state * numColumns + classOf[terminal]];
+        return action != SHIFT_ENTRY ? action : shifts.lookup(state, terminal);
+    }
+    int gotoAt(int state, int nonTerminal) const {
+        int i = gotoColumns.base[nonTerminal] + state;
+        return gotoColumns.check[i] == nonTerminal ? gotoColumns.value[i] : defaultGoto[nonTerminal];
+    }
+    size_t sizeInBytes() const {
+        return (classOf.size() + classAction.size() + defaultGoto.size()) * sizeof(int) +
+               shifts.sizeInBytes() + gotoColumns.sizeInBytes();
+    }
+};
+
+// Function to pack sparse rows of (column, value) entries with row
+// displacement. Rows are placed densest first, each at the lowest base where
+// its entries fit.
+inline CombTable packRows(const vector<vector<pair<int, int>>>& rows, int columns, int emptyValue) {
+    CombTable comb;
+    comb.emptyValue = emptyValue;
+    comb.base.assign(rows.size(), 0);
+
+    vector<int> order(rows.size());
+    for (size_t r = 0; r < rows.size(); r++) order[r] = (int)r;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return rows[a].size() > rows[b].size();
+    });
+
+    vector<bool> used;
+    int firstFree = 0;
+    for (int r : order) {
+        if (rows[r].empty()) continue;
+
+        int base = max(0, firstFree - rows[r][0].first);
+        while (true) {
+            bool fits = true;
+            for (const auto& entry : rows[r]) {
+                if (base + entry.first < (int)used.size() && used[base + entry.first]) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) break;
+            base++;
+        }
+
+        comb.base[r] = base;
+        if ((int)used.size() < base + columns) {
+            used.resize(base + columns, false);
+            comb.value.resize(base + columns, emptyValue);
+            comb.check.resize(base + columns, -1);
+        }
+        for (const auto& entry : rows[r]) {
+            used[base + entry.first] = true;
+            comb.value[base + entry.first] = entry.second;
+            comb.check[base + entry.first] = r;
+        }
+        while (firstFree < (int)used.size() && used[firstFree]) firstFree++;
+    }
+
+    // Every lookup base[r] + column stays inside the vectors
+    int maxBase = rows.empty() ? 0 : *max_element(comb.base.begin(), comb.base.end());
+    comb.value.resize(max((int)comb.value.size(), maxBase + columns), emptyValue);
+    comb.check.resize(comb.value.size(), -1);
+    return comb;
+}
+
+// Function to pick the most frequent reduction of each state as its default
+inline vector<int> defaultReductions(const LALRTable& table) {
+    vector<int> defaults(table.numStates, ACTION_ERROR);
+    for (int s = 0; s < table.numStates; s++) {
+        map<int, int> counts;
+        for (int t = 0; t < table.numTerminals(); t++) {
+            int action = table.action[s * table.numTerminals() + t];
+            if (action < 0 && action != reduceAction(0)) counts[action]++;  // Never accept by default
+        }
+        int best = 0;
+        for (const auto& count : counts) {
+            if (count.second > best) {
+                best = count.second;
+                defaults[s] = count.first;
+            }
+        }
+    }
+    return defaults;
+}
+
+// Function to list the explicit ACTION cells of every state. Cells equal to
+// the state's default, and plain errors, become NO_ENTRY.
+inline vector<int> actionCells(const LALRTable& table, const vector<int>& defaults) {
+    int columns = table.numTerminals();
+    vector<int> cells(table.action.size());
+    for (int s = 0; s < table.numStates; s++) {
+        for (int t = 0; t < columns; t++) {
+            int i = s * columns + t;
+            int action = table.action[i];
+            bool isError = action == ACTION_ERROR;
+            if ((isError && !table.explicitError[i]) || (!isError && action == defaults[s])) {
+                cells[i] = NO_ENTRY;
+            } else {
+                cells[i] = action;
+            }
+        }
+    }
+    return cells;
+}
+
+// Function to copy the rules and map every input byte to its terminal
+inline void copyRules(const LALRTable& table, LRTablesBase& tables) {
+    tables.numColumns = table.numTerminals();
+    tables.numNonTerminals = table.numNonTerminals();
+    fill(tables.columnOf, tables.columnOf + 256, -1);
+    for (int t = 0; t < table.numTerminals(); t++) {
+        tables.columnOf[(unsigned char)table.terminals[t]] = t;
+    }
+    tables.endColumn = 0;
+    for (const LRRule& rule : table.rules) {
+        tables.ruleLength.push_back((int)rule.rhs.size());
+        tables.ruleLhs.push_back(rule.lhs - table.numTerminals());
+    }
+}
+
+// Function to collect the non-empty entries of each row of a dense table
+inline vector<vector<pair<int, int>>> sparseRows(const vector<int>& cells, int rows, int columns, int emptyValue) {
+    vector<vector<pair<int, int>>> result(rows);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < columns; c++) {
+            int cell = cells[r * columns + c];
+            if (cell != NO_ENTRY && cell != emptyValue) result[r].push_back({c, cell});
+        }
+    }
+    return result;
+}
+
+// Function to pack GOTO by column, with the most common target of each
+// non-terminal as its default
+inline void packGotoColumns(const LALRTable& table, CombTable& gotoColumns, vector<int>& defaultGoto) {
+    int nonTerminals = table.numNonTerminals();
+    defaultGoto.assign(nonTerminals, -1);
+    vector<vector<pair<int, int>>> columns(nonTerminals);
+
+    for (int A = 0; A < nonTerminals; A++) {
+        map<int, int> counts;
+        for (int s = 0; s < table.numStates; s++) {
+            int target = table.gotoTable[s * nonTerminals + A];
+            if (target != -1) counts[target]++;
+        }
+        int best = 0;
+        for (const auto& count : counts) {
+            if (count.second > best) {
+                best = count.second;
+                defaultGoto[A] = count.first;
+            }
+        }
+        for (int s = 0; s < table.numStates; s++) {
+            int target = table.gotoTable[s * nonTerminals + A];
+            if (target != -1 && target != defaultGoto[A]) columns[A].push_back({s, target});
+        }
+    }
+    gotoColumns = packRows(columns, table.numStates, -1);
+}
+
+// Function to build the uncompressed encoding
+inline DenseLRTables buildDenseTables(const LALRTable& table) {
+    DenseLRTables tables;
+    copyRules(table, tables);
+    tables.action = table.action;
+    tables.gotoTable = table.gotoTable;
+    return tables;
+}
+
+// Function to build comb vectors holding every non-error entry
+inline CombLRTables buildCombTables(const LALRTable& table) {
+    CombLRTables tables;
+    copyRules(table, tables);
+    vector<int> noDefaults(table.numStates, ACTION_ERROR);
+    vector<int> cells = actionCells(table, noDefaults);
+    tables.action = packRows(sparseRows(cells, table.numStates, tables.numColumns, ACTION_ERROR),
+                             tables.numColumns, ACTION_ERROR);
+    tables.gotoTable = packRows(sparseRows(table.gotoTable, table.numStates, tables.numNonTerminals, -1),
+                                tables.numNonTerminals, -1);
+    return tables;
+}
+
+// Function to build comb vectors holding only the entries that differ from the defaults
+inline DefaultCombLRTables buildDefaultCombTables(const LALRTable& table) {
+    DefaultCombLRTables tables;
+    copyRules(table, tables);
+    tables.defaultAction = defaultReductions(table);
+    vector<int> cells = actionCells(table, tables.defaultAction);
+
+    // Explicit %nonassoc errors are kept as stored zeroes, so no empty value is skipped
+    tables.action = packRows(sparseRows(cells, table.numStates, tables.numColumns, NO_ENTRY),
+                             tables.numColumns, ACTION_ERROR);
+    packGotoColumns(table, tables.gotoColumns, tables.defaultGoto);
+    return tables;
+}
+
+// Function to build the terminal-class encoding
+inline ClassLRTables buildClassTables(const LALRTable& table) {
+    ClassLRTables tables;
+    copyRules(table, tables);
+    int terminals = table.numTerminals();
+
+    // A terminal's column with every shift target replaced by SHIFT_ENTRY
+    map<vector<int>, int> classOfColumn;
+    vector<int> representative;
+    tables.classOf.resize(terminals);
+    for (int t = 0; t < terminals; t++) {
+        vector<int> column(table.numStates);
+        for (int s = 0; s < table.numStates; s++) {
+            int action = table.action[s * terminals + t];
+            column[s] = action > 0 ? SHIFT_ENTRY : action;
+        }
+        auto inserted = classOfColumn.insert({column, (int)representative.size()});
+        if (inserted.second) representative.push_back(t);
+        tables.classOf[t] = inserted.first->second;
+    }
+    tables.numColumns = (int)representative.size();
+
+    tables.classAction.resize(table.numStates * tables.numColumns);
+    vector<vector<pair<int, int>>> shiftRows(table.numStates);
+    for (int s = 0; s < table.numStates; s++) {
+        for (int k = 0; k < tables.numColumns; k++) {
+            int action = table.action[s * terminals + representative[k]];
+            tables.classAction[s * tables.numColumns + k] = action > 0 ? SHIFT_ENTRY : action;
+        }
+        for (int t = 0; t < terminals; t++) {
+            int action = table.action[s * terminals + t];
+            if (action > 0) shiftRows[s].push_back({t, action});
+        }
+    }
+    tables.shifts = packRows(shiftRows, terminals, ACTION_ERROR);
+    packGotoColumns(table, tables.gotoColumns, tables.defaultGoto);
+    return tables;
+}
+
+// Validate input string with any of the table encodings; every byte is one token
+template <class Tables>
+bool parseLR(const string& input, const Tables& tables, vector<int>& stack) {
+    stack.clear();
+    stack.push_back(0);
+
+    size_t index = 0;
+    int token = input.empty() ? tables.endColumn : tables.columnOf[(unsigned char)input[0]];
+
+    while (true) {
+        if (token < 0) return false;
+        int action = tables.actionAt(stack.back(), token);
+
+        if (action > 0) {
+            stack.push_back(action - 1);
+            index++;
+            token = index < input.size() ? tables.columnOf[(unsigned char)input[index]] : tables.endColumn;
+        } else if (action < 0) {
+            int rule = -action - 1;
+            if (rule == 0) return true;
+            stack.resize(stack.size() - tables.ruleLength[rule]);
+            stack.push_back(tables.gotoAt(stack.back(), tables.ruleLhs[rule]));
+        } else {
+            return false;
+        }
+    }
+}
+
+template <class Tables>
+bool parseLR(const string& input, const Tables& tables) {
+    vector<int> stack;
+    return parseLR(input, tables, stack);
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "grammar.h"
+#include "ll1.h"
+#include "sentences.h"
+#include "transform.h"
+
+using namespace std;
+
+// Grammars that need rewriting before the LL(1) table can take them
+vector<Production> builtinGrammar(const string& name) {
+    if (name == "expression") {
+        // The grammar Practical-11 parses by hand
+        return {{'E', {"E+T", "E-T", "T"}}, {'T', {"T*F", "T/F", "F"}}, {'F', {"(E)", "n"}}};
+    }
+    if (name == "practical-8") {
+        return {{'S', {"ABC", "D"}}, {'A', {"a", "ε"}}, {'B', {"b", "ε"}}, {'C', {"(S)", "c"}}, {'D', {"AC"}}};
+    }
+    if (name == "indirect") {
+        return {{'S', {"Aa", "b"}}, {'A', {"Bc", "d"}}, {'B', {"Se", "f"}}};
+    }
+    if (name == "statements") {
+        return {{'P', {"PS;", "S;"}}, {'S', {"i=E", "i(E)", "i()"}}, {'E', {"E+i", "i"}}};
+    }
+    return {};
+}
+
+// Usage: make_ll1 [expression | practical-8 | indirect | statements | -f file] [sentences]
+int main(int argc, char** argv) {
+    vector<Production> grammar;
+    int next = 1;
+    if (argc > 2 && string(argv[1]) == "-f") {
+        ifstream in(argv[2]);
+        grammar = readGrammar(in);
+        next = 3;
+    } else {
+        grammar = builtinGrammar(argc > 1 ? argv[1] : "expression");
+        next = 2;
+    }
+    size_t samples = argc > next ? strtoull(argv[next], nullptr, 10) : 10000;
+    if (grammar.empty()) {
+        cerr << "Usage: " << argv[0] << " [expression | practical-8 | indirect | statements | -f file] [sentences]"
+             << endl;
+        return 1;
+    }
+
+    cout << "Grammar:" << endl;
+    printGrammar(grammar);
+    map<char, set<char>> firstSets = computeFirstSets(grammar);
+    map<char, set<char>> followSets = computeFollowSets(grammar, firstSets);
+    bool wasLL1;
+    constructParsingTable(grammar, firstSets, followSets, wasLL1, getTerminals(grammar));
+    cout << "The grammar is " << (wasLL1 ? "LL(1)" : "not LL(1)") << endl;
+
+    TransformReport report;
+    vector<Production> rewritten = makeLL1(grammar, report);
+    cout << "\nRewritten Grammar:" << endl;
+    printGrammar(rewritten);
+    printTransformReport(report);
+
+    firstSets = computeFirstSets(rewritten);
+    followSets = computeFollowSets(rewritten, firstSets);
+    bool isLL1;
+    set<char> terminals = getTerminals(rewritten);
+    map<char, map<char, TableEntry>> table = constructParsingTable(rewritten, firstSets, followSets, isLL1, terminals);
+    printParsingTable(table, getNonTerminals(rewritten), terminals);
+
+    // Sentences of the original grammar must all parse with the new table
+    if (isLL1 && samples) {
+        SentenceGenerator generator(grammar, grammar[0].nonTerminal, 44);
+        SentenceOptions options;
+        options.maxLength = 48;
+        size_t accepted = 0;
+        string sentence, firstRejected;
+        for (size_t i = 0; i < samples; i++) {
+            generator.next(sentence, options);
+            if (validateString(sentence, table, rewritten[0].nonTerminal, false)) {
+                accepted++;
+            } else if (firstRejected.empty()) {
+                firstRejected = sentence;
+            }
+        }
+        cout << "\nThe LL(1) parser accepted " << accepted << " of " << samples
+             << " sentences generated from the original grammar" << endl;
+        if (!firstRejected.empty()) cout << "First rejected: " << firstRejected << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include "grammar.h"
+#include "ll1.h"
+#include "sentences.h"
+#include "incremental_ll1.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to pick a random position just after an 'n', where the edits
+// below keep an expression valid
+size_t randomOperand(const string& text, mt19937_64& rng) {
+    while (true) {
+        size_t at = rng() % text.size();
+        size_t found = text.find('n', at);
+        if (found != string::npos) return found + 1;
+    }
+}
+
+// Usage: reparse_bench [megabytes] [edits] [checkpoint interval]
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10;
+    size_t editCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 2000;
+    size_t interval = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1024;
+
+    vector<Production> grammar = expressionGrammar();
+    map<char, map<char, TableEntry>> table = buildParsingTable(grammar);
+
+    // The buffer: generated expressions, each in parentheses, joined by +
+    SentenceGenerator generator(grammar, 'E', 46);
+    SentenceOptions options;
+    options.maxLength = 200;
+    string text, sentence;
+    while (text.size() < megabytes << 20) {
+        generator.next(sentence, options);
+        if (!text.empty()) text += '+';
+        text += "(" + sentence + ")";
+    }
+
+    IncrementalLL1 parser(table, 'E', interval);
+    auto start = steady_clock::now();
+    bool ok = parser.parse(text);
+    double fullMs = duration<double, milli>(steady_clock::now() - start).count();
+    start = steady_clock::now();
+    bool reference = validateString(text, table, 'E', false);
+    double validateMs = duration<double, milli>(steady_clock::now() - start).count();
+    cout << text.size() << " byte buffer: full parse " << fixed << setprecision(1) << fullMs << " ms ("
+         << (ok ? "accepted" : "rejected") << "), validateString " << validateMs << " ms ("
+         << (reference ? "accepted" : "rejected") << ")" << endl;
+    cout << parser.checkpointCount() << " checkpoints every " << interval << " characters, " << parser.nodeCount()
+         << " stack nodes, " << parser.memoryBytes() / 1024 << " KB" << endl;
+
+    // Random edits: typing an operand or a parenthesised term, replacing an
+    // operand, and typos (a deleted character) that the next edit undoes
+    mt19937_64 rng(460);
+    vector<double> micros;
+    size_t parsedTotal = 0, rejoined = 0, rejected = 0, checks = 0, agreed = 0;
+    string undo;
+    size_t undoAt = SIZE_MAX;
+    for (size_t e = 0; e < editCount; e++) {
+        size_t offset, erased;
+        string inserted;
+        if (undoAt != SIZE_MAX) {
+            offset = undoAt;
+            erased = 0;
+            inserted = undo;
+            undoAt = SIZE_MAX;
+        } else {
+            switch (rng() % 4) {
+                case 0: offset = randomOperand(text, rng); erased = 0; inserted = "+n"; break;
+                case 1: offset = randomOperand(text, rng); erased = 0; inserted = "*(n+n)"; break;
+                case 2: offset = randomOperand(text, rng) - 1; erased = 1; inserted = "(n*n)"; break;
+                default:
+                    offset = rng() % text.size();
+                    erased = 1;
+                    undo = text.substr(offset, 1);
+                    undoAt = offset;
+                    break;
+            }
+        }
+        text.replace(offset, erased, inserted);
+
+        ReparseStats stats;
+        start = steady_clock::now();
+        bool accepted = parser.edit(text, offset, erased, inserted.size(), &stats);
+        micros.push_back(duration<double, micro>(steady_clock::now() - start).count());
+        parsedTotal += stats.charactersParsed;
+        rejoined += stats.rejoinedAt != SIZE_MAX;
+        rejected += !accepted;
+
+        // Every 50th edit, and the last, must match a parse from scratch
+        if (e % 50 == 0 || e + 1 == editCount) {
+            IncrementalLL1 fresh(table, 'E', interval);
+            bool expected = fresh.parse(text);
+            checks++;
+            agreed += expected == accepted && (expected || fresh.errorPosition() == parser.errorPosition());
+        }
+    }
+    bool finalReference = validateString(text, table, 'E', false);
+
+    sort(micros.begin(), micros.end());
+    double total = 0;
+    for (double m : micros) total += m;
+    cout << "\n" << editCount << " edits (" << rejected << " left the buffer invalid), " << rejoined
+         << " rejoined the old parse" << endl;
+    cout << "Reparse time: mean " << setprecision(1) << total / micros.size() << " us, median "
+         << micros[micros.size() / 2] << " us, 99th percentile " << micros[micros.size() * 99 / 100] << " us, max "
+         << micros.back() << " us" << endl;
+    cout << "Characters reparsed per edit: " << setprecision(0) << (double)parsedTotal / editCount << " of "
+         << text.size() << "; speedup over a full parse " << setprecision(0) << fullMs * 1000 / (total / micros.size())
+         << "x" << endl;
+    cout << "Agreed with a parse from scratch on " << agreed << " of " << checks << " checks; validateString "
+         << (finalReference == parser.accepted() ? "agrees" : "DISAGREES") << " on the final buffer" << endl;
+    cout << parser.checkpointCount() << " checkpoints, " << parser.nodeCount() << " stack nodes, "
+         << parser.memoryBytes() / 1024 << " KB" << endl;
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "grammar.h"
+#include "ll1.h"
+#include "sentences.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Built-in grammars: practical-8's own, the LL(1) expression grammar, and
+// the bracket lists Practical-6's RDP parser reads
+vector<Production> builtinGrammar(const string& name) {
+    if (name == "practical-8") {
+        return {{'S', {"ABC", "D"}}, {'A', {"a", "ε"}}, {'B', {"b", "ε"}}, {'C', {"(S)", "c"}}, {'D', {"AC"}}};
+    }
+    if (name == "expression") {
+        return expressionGrammar();
+    }
+    if (name == "practical-6") {
+        return {{'S', {"(L)", "a"}}, {'L', {"L,S", "S"}}};
+    }
+    return {};
+}
+
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [-g grammar | -f file] [-n count | -b bytes] [-l min:max] [-d min:max]\n"
+         << "       [-w 'A->x=weight' ...] [-m rate] [-s seed] [-p] [-c]\n"
+         << "  -g  practical-8, expression or practical-6 (default expression)\n"
+         << "  -f  grammar file, one 'S -> ABC | D' line per non-terminal; the first is the start\n"
+         << "  -n  sentences to write (default 10); -b writes until this many bytes instead\n"
+         << "  -l  target length range (default 1:64)\n"
+         << "  -d  target depth range of the derivation tree (default 4:24); alternatives other\n"
+         << "      than the shortest get rarer towards it, and past it only the shortest is taken\n"
+         << "  -w  relative weight of one alternative (default 1), e.g. -w 'F->(E)=0.3'\n"
+         << "  -m  fraction of sentences given one random edit (default 0)\n"
+         << "  -p  start with the sentence count, as Practical-6 reads it (needs -n)\n"
+         << "  -c  check every sentence with the LL(1) parser and report the results\n";
+}
+
+// Writes one sentence per line to stdout and a summary to stderr
+int main(int argc, char** argv) {
+    string grammarName = "expression", grammarFile;
+    size_t count = 10, bytes = 0;
+    SentenceOptions options;
+    uint64_t seed = 1;
+    bool prefixCount = false, check = false;
+    vector<string> weightSpecs;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "g:f:n:b:l:d:w:m:s:pc")) != -1) {
+        switch (opt) {
+            case 'g': grammarName = optarg; break;
+            case 'f': grammarFile = optarg; break;
+            case 'n': count = strtoull(optarg, nullptr, 10); break;
+            case 'b': bytes = strtoull(optarg, nullptr, 10); break;
+            case 'l':
+                if (sscanf(optarg, "%zu:%zu", &options.minLength, &options.maxLength) != 2) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'd':
+                if (sscanf(optarg, "%d:%d", &options.minDepth, &options.maxDepth) != 2) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'w': weightSpecs.push_back(optarg); break;
+            case 'm': options.mutationRate = atof(optarg); break;
+            case 's': seed = strtoull(optarg, nullptr, 10); break;
+            case 'p': prefixCount = true; break;
+            case 'c': check = true; break;
+            default: printUsage(argv[0]); return 1;
+        }
+    }
+
+    vector<Production> grammar;
+    if (!grammarFile.empty()) {
+        ifstream in(grammarFile);
+        grammar = readGrammar(in);
+    } else {
+        grammar = builtinGrammar(grammarName);
+    }
+    if (grammar.empty()) {
+        cerr << "No grammar" << endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    char startSymbol = grammar[0].nonTerminal;
+    SentenceGenerator generator(grammar, startSymbol, seed);
+    if (!generator.ok()) {
+        cerr << "The start symbol derives no terminal string" << endl;
+        return 1;
+    }
+    for (const string& spec : weightSpecs) {
+        size_t arrow = spec.find("->"), equals = spec.rfind('=');
+        if (arrow != 1 || equals == string::npos || equals < arrow + 2 ||
+            !generator.setWeight(spec[0], spec.substr(arrow + 2, equals - arrow - 2), atof(spec.c_str() + equals + 1))) {
+            cerr << "No alternative for -w " << spec << endl;
+            return 1;
+        }
+    }
+
+    // The LL(1) table, for -c
+    map<char, map<char, TableEntry>> table;
+    bool isLL1 = false;
+    if (check) {
+        map<char, set<char>> first = computeFirstSets(grammar);
+        map<char, set<char>> follow = computeFollowSets(grammar, first);
+        table = constructParsingTable(grammar, first, follow, isLL1, getTerminals(grammar));
+        if (!isLL1) cerr << "The grammar is not LL(1), so sentences are not checked" << endl;
+    }
+
+    // Sentences go out through one buffer; nothing is kept after it is written
+    vector<char> buffer(1 << 20);
+    size_t used = 0;
+    auto flush = [&]() {
+        fwrite(buffer.data(), 1, used, stdout);
+        used = 0;
+    };
+    auto emit = [&](const char* data, size_t length) {
+        if (used + length > buffer.size()) flush();
+        if (length > buffer.size()) {
+            fwrite(data, 1, length, stdout);
+            return;
+        }
+        memcpy(buffer.data() + used, data, length);
+        used += length;
+    };
+    if (prefixCount) {
+        string header = to_string(count) + "\n";
+        emit(header.data(), header.size());
+    }
+
+    size_t written = 0, sentences = 0, mutated = 0, minSeen = SIZE_MAX, maxSeen = 0;
+    size_t accepted = 0, acceptedMutated = 0, depthTotal = 0;
+    string sentence;
+    auto start = steady_clock::now();
+    while (bytes ? written < bytes : sentences < count) {
+        bool edited = generator.next(sentence, options);
+        sentence += '\n';
+        emit(sentence.data(), sentence.size());
+        written += sentence.size();
+        sentence.pop_back();
+        sentences++;
+        mutated += edited;
+        depthTotal += generator.lastDepth;
+        minSeen = min(minSeen, sentence.size());
+        maxSeen = max(maxSeen, sentence.size());
+        if (check && isLL1 && validateString(sentence, table, startSymbol, false)) {
+            accepted++;
+            acceptedMutated += edited;
+        }
+    }
+    flush();
+    fflush(stdout);
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    cerr << sentences << " sentences, " << written << " bytes in " << seconds << " s ("
+         << written / max(seconds, 1e-9) / 1e6 << " MB/s)" << endl;
+    cerr << "Length " << (sentences ? minSeen : 0) << " to " << maxSeen << ", mean "
+         << (sentences ? (double)(written - sentences) / sentences : 0) << "; depth mean "
+         << (sentences ? (double)depthTotal / sentences : 0) << ", deepest " << generator.deepest << "; "
+         << mutated << " mutated" << endl;
+    if (check && isLL1) {
+        cerr << "LL(1) parser accepted " << accepted - acceptedMutated << " of " << sentences - mutated
+             << " generated and " << acceptedMutated << " of " << mutated << " mutated sentences" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,246 @@
+#ifndef SENTENCES_H
+#define SENTENCES_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include "grammar.h"
+
+using namespace std;
+
+// Random sentence generation from a grammar in Production form, for load
+// testing the parsers. Every non-terminal knows the shortest sentence it can
+// derive, so generation can always finish within a length budget. Each
+// sentence draws a target length and a target depth. Below the target depth
+// a non-terminal picks among the alternatives that fit the budget by weight.
+// Every alternative but the shortest counts double at the root and fades
+// linearly to nothing at the target depth, so sentences grow in breadth and
+// nesting alike and thin out towards the target instead of piling up. Once
+// the budget is spent or the target depth is reached, every non-terminal
+// takes its shortest alternative. Expansion uses an explicit stack, so
+// neither long sentences nor deep grammars recurse.
+
+// Structure to describe the sentences to generate
+struct SentenceOptions {
+    size_t minLength = 1;       // Target length is drawn uniformly from
+    size_t maxLength = 64;      // [minLength, maxLength]
+    int minDepth = 4;           // Target depth (of the derivation tree) is drawn
+    int maxDepth = 24;          // uniformly from [minDepth, maxDepth]
+    double mutationRate = 0.0;  // Fraction of sentences given one random edit
+};
+
+class SentenceGenerator {
+    struct Alternative {
+        string symbols;         // Empty for ε
+        long length;            // Shortest terminal string it derives (LONG_MAX if none)
+        int height;             // Derivation tree height of that string
+        double weight;          // Relative probability among the alternatives, 1 by default
+    };
+
+    struct Pending {
+        char symbol;
+        int depth;
+    };
+
+    vector<vector<Alternative>> alternatives;  // By non-terminal
+    int index[256];                            // Non-terminal char to its slot, or -1
+    vector<long> minLength;                    // Shortest derivable length per slot
+    vector<int> minHeight;
+    vector<int> shortest;                      // Alternative reaching minLength
+    string terminals;
+    char start;
+    mt19937_64 rng;
+    vector<Pending> stack;
+    vector<char> choices;                      // More than one alternative to pick from, by slot
+
+    long symbolLength(char c) const { return index[(unsigned char)c] < 0 ? 1 : minLength[index[(unsigned char)c]]; }
+    int symbolHeight(char c) const { return index[(unsigned char)c] < 0 ? 0 : minHeight[index[(unsigned char)c]]; }
+
+    // Function to compute the shortest derivation of every non-terminal. A
+    // (length, height) pair only improves, so this reaches a fixed point, and
+    // each shortest alternative uses non-terminals of smaller height, so
+    // following shortest alternatives always terminates.
+    void computeShortest() {
+        size_t n = alternatives.size();
+        minLength.assign(n, LONG_MAX);
+        minHeight.assign(n, INT_MAX);
+        shortest.assign(n, -1);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t a = 0; a < n; a++) {
+                for (size_t k = 0; k < alternatives[a].size(); k++) {
+                    Alternative& alt = alternatives[a][k];
+                    long length = 0;
+                    int height = 0;
+                    for (char c : alt.symbols) {
+                        if (symbolLength(c) == LONG_MAX) {
+                            length = LONG_MAX;
+                            break;
+                        }
+                        length += symbolLength(c);
+                        height = max(height, symbolHeight(c));
+                    }
+                    alt.length = length;
+                    alt.height = length == LONG_MAX ? INT_MAX : height + 1;
+                    if (length < minLength[a] || (length == minLength[a] && alt.height < minHeight[a])) {
+                        minLength[a] = length;
+                        minHeight[a] = alt.height;
+                        shortest[a] = (int)k;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Function to apply one random edit: delete, insert, replace or swap
+    void mutate(string& sentence) {
+        unsigned kind = rng() % 4;
+        size_t at = sentence.empty() ? 0 : rng() % sentence.size();
+        char terminal = terminals.empty() ? '?' : terminals[rng() % terminals.size()];
+        // A one-symbol sentence is never deleted to nothing, since line readers
+        // such as Practical-6's cin >> would skip the empty line
+        if (sentence.empty() || kind == 1 || (kind == 0 && sentence.size() == 1)) {
+            sentence.insert(sentence.begin() + at, terminal);
+        } else if (kind == 0) {
+            sentence.erase(at, 1);
+        } else if (kind == 2 || sentence.size() < 2) {
+            if (terminal == sentence[at] && terminals.size() > 1) {
+                terminal = terminals[(terminals.find(terminal) + 1) % terminals.size()];
+            }
+            sentence[at] = terminal;
+        } else {
+            if (at + 1 == sentence.size()) at--;
+            swap(sentence[at], sentence[at + 1]);
+        }
+    }
+
+public:
+    int deepest = 0;    // Deepest expansion seen so far
+    int lastDepth = 0;  // Deepest expansion of the last sentence
+
+    SentenceGenerator(const vector<Production>& grammar, char startSymbol, uint64_t seed)
+        : start(startSymbol), rng(seed) {
+        fill(begin(index), end(index), -1);
+        for (const auto& production : grammar) {
+            if (index[(unsigned char)production.nonTerminal] < 0) {
+                index[(unsigned char)production.nonTerminal] = (int)alternatives.size();
+                alternatives.emplace_back();
+            }
+        }
+        for (const auto& production : grammar) {
+            for (const string& derivation : production.derivations) {
+                string symbols = derivation == "ε" ? "" : derivation;
+                alternatives[index[(unsigned char)production.nonTerminal]].push_back({symbols, LONG_MAX, INT_MAX, 1.0});
+                for (char c : symbols) {
+                    if (index[(unsigned char)c] < 0 && terminals.find(c) == string::npos) terminals += c;
+                }
+            }
+        }
+        computeShortest();
+        for (const auto& alts : alternatives) choices.push_back(alts.size() > 1);
+    }
+
+    // A grammar whose start symbol derives no terminal string cannot generate
+    bool ok() const { return index[(unsigned char)start] >= 0 && minLength[index[(unsigned char)start]] != LONG_MAX; }
+
+    // Function to set the relative weight of one alternative (written as in
+    // the grammar, "ε" for the empty one); false if there is no such alternative
+    bool setWeight(char nonTerminal, const string& derivation, double weight) {
+        int slot = index[(unsigned char)nonTerminal];
+        if (slot < 0 || weight < 0) return false;
+        string symbols = derivation == "ε" ? "" : derivation;
+        for (Alternative& alt : alternatives[slot]) {
+            if (alt.symbols == symbols) {
+                alt.weight = weight;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    long shortestLength(char nonTerminal) const {
+        int slot = index[(unsigned char)nonTerminal];
+        return slot < 0 ? -1 : minLength[slot];
+    }
+
+    // Function to generate one sentence into out; returns true when the
+    // sentence was mutated (and so is most likely, but not surely, invalid)
+    bool next(string& out, const SentenceOptions& options) {
+        out.clear();
+        size_t span = options.maxLength > options.minLength ? options.maxLength - options.minLength + 1 : 1;
+        long target = (long)(options.minLength + rng() % span);
+        int depthSpan = options.maxDepth > options.minDepth ? options.maxDepth - options.minDepth + 1 : 1;
+        int targetDepth = max(options.minDepth + (int)(rng() % depthSpan), 1);
+
+        stack.clear();
+        stack.push_back({start, 0});
+        lastDepth = 0;
+        long pending = symbolLength(start);  // Shortest length of everything on the stack
+        while (!stack.empty()) {
+            Pending item = stack.back();
+            stack.pop_back();
+            int slot = index[(unsigned char)item.symbol];
+            if (slot < 0) {
+                out += item.symbol;
+                pending--;
+                continue;
+            }
+            pending -= minLength[slot];
+            lastDepth = max(lastDepth, item.depth);
+
+            // Room left for this non-terminal once everything else is at its shortest
+            long budget = target - (long)out.size() - pending;
+            const vector<Alternative>& alts = alternatives[slot];
+            int choice = shortest[slot];
+            if (choices[slot] && item.depth < targetDepth && budget > minLength[slot]) {
+                // Growing alternatives fade out linearly towards the target depth
+                double growth = 2.0 * (targetDepth - item.depth) / targetDepth;
+                auto weightOf = [&](int k) {
+                    if (alts[k].length > budget) return 0.0;
+                    return alts[k].weight * (k == shortest[slot] ? 1.0 : growth);
+                };
+                double total = 0;
+                int feasibleCount = 0, only = choice;
+                for (int k = 0; k < (int)alts.size(); k++) {
+                    double weight = weightOf(k);
+                    if (weight <= 0) continue;
+                    total += weight;
+                    feasibleCount++;
+                    only = k;
+                }
+                if (feasibleCount == 1) {
+                    choice = only;
+                } else if (feasibleCount > 1) {
+                    double pick = (double)(rng() >> 11) / (double)(1ull << 53) * total;
+                    for (int k = 0; k < (int)alts.size(); k++) {
+                        double weight = weightOf(k);
+                        if (weight <= 0) continue;
+                        choice = k;
+                        if ((pick -= weight) < 0) break;
+                    }
+                }
+            }
+
+            // Leading terminals go straight out, the rest onto the stack
+            const string& symbols = alts[choice].symbols;
+            size_t lead = 0;
+            while (lead < symbols.size() && index[(unsigned char)symbols[lead]] < 0) out += symbols[lead++];
+            pending += alts[choice].length - (long)lead;
+            for (size_t i = symbols.size(); i-- > lead;) stack.push_back({symbols[i], item.depth + 1});
+        }
+        deepest = max(deepest, lastDepth);
+
+        if (options.mutationRate > 0 && (double)(rng() >> 11) / (double)(1ull << 53) < options.mutationRate) {
+            mutate(out);
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,459 @@
+#ifndef TABLE_CACHE_H
+#define TABLE_CACHE_H
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "grammar.h"
+#include "ll1.h"
+
+using namespace std;
+
+// A binary image of an analyzed grammar: symbols, productions, First and
+// Follow sets as 256-bit sets, and the LL(1) table as a dense array of
+// production indices. The image is written once and later mmap'd and read
+// in place: every section is a plain array at an offset from the header, so
+// loading is a map and a few bounds checks, not a parse.
+//
+// The header holds a hash of the grammar text. loadGrammarTables() maps
+// the file, and when it is missing, of another format version or byte
+// order, or of another grammar, computes the tables with grammar.h and
+// ll1.h as before and rewrites it.
+
+const uint32_t GRAMMAR_TABLE_VERSION = 1;
+const uint32_t GRAMMAR_TABLE_BYTE_ORDER = 0x01020304;
+const int32_t GRAMMAR_TABLE_CONFLICT = 1 << 30;    // Or'ed into a cell with more than one production
+
+// Structure at the start of the file; offsets are from the file's start
+struct GrammarTableHeader {
+    char magic[8];                  // "LL1TABLE"
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t grammarHash;
+    uint64_t fileBytes;
+    uint32_t nonTerminalCount;
+    uint32_t columnCount;           // Terminals in order, then '$'
+    uint32_t productionCount;
+    uint32_t textBytes;
+    char startSymbol;
+    uint8_t isLL1;
+    uint16_t reserved;
+    int16_t rowOf[256];             // Non-terminal to row, or -1
+    int16_t columnOf[256];          // Terminal to column, or -1
+    uint64_t nonTerminalsOffset;    // char[nonTerminalCount], in grammar order
+    uint64_t columnsOffset;         // char[columnCount]
+    uint64_t productionsOffset;     // CachedProduction[productionCount]
+    uint64_t textOffset;            // char[textBytes]
+    uint64_t firstOffset;           // uint64_t[nonTerminalCount][4]
+    uint64_t followOffset;          // uint64_t[nonTerminalCount][4]
+    uint64_t cellsOffset;           // int32_t[nonTerminalCount][columnCount]
+};
+
+// Structure to place one derivation in the text section
+struct CachedProduction {
+    uint32_t textOffset;
+    uint32_t length;                // Bytes as written, 0 for ε
+    char nonTerminal;
+    uint8_t reserved[3];
+};
+
+// Function to hash the grammar text (FNV-1a), one "A->x|y" line per production
+inline uint64_t hashGrammar(const vector<Production>& grammar) {
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](const string& text) {
+        for (char c : text) hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+    };
+    for (const auto& production : grammar) {
+        add(string(1, production.nonTerminal) + "->");
+        for (size_t i = 0; i < production.derivations.size(); i++) add((i ? "|" : "") + production.derivations[i]);
+        add("\n");
+    }
+    return hash;
+}
+
+// Function to compute the tables and lay them out as a file image
+inline vector<char> buildGrammarImage(const vector<Production>& grammar) {
+    set<char> terminals = getTerminals(grammar);
+    vector<char> nonTerminals;
+    for (char nonTerminal : getNonTerminals(grammar)) {
+        if (find(nonTerminals.begin(), nonTerminals.end(), nonTerminal) == nonTerminals.end()) {
+            nonTerminals.push_back(nonTerminal);
+        }
+    }
+    map<char, set<char>> firstSets = computeFirstSets(grammar);
+    map<char, set<char>> followSets = computeFollowSets(grammar, firstSets);
+    bool isLL1;
+    map<char, map<char, TableEntry>> table = constructParsingTable(grammar, firstSets, followSets, isLL1, terminals);
+
+    GrammarTableHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "LL1TABLE", 8);
+    header.version = GRAMMAR_TABLE_VERSION;
+    header.byteOrder = GRAMMAR_TABLE_BYTE_ORDER;
+    header.grammarHash = hashGrammar(grammar);
+    header.startSymbol = grammar[0].nonTerminal;
+    header.isLL1 = isLL1;
+    fill(begin(header.rowOf), end(header.rowOf), -1);
+    fill(begin(header.columnOf), end(header.columnOf), -1);
+
+    vector<char> columns(terminals.begin(), terminals.end());
+    columns.push_back('$');
+    for (size_t r = 0; r < nonTerminals.size(); r++) header.rowOf[(unsigned char)nonTerminals[r]] = (int16_t)r;
+    for (size_t c = 0; c < columns.size(); c++) header.columnOf[(unsigned char)columns[c]] = (int16_t)c;
+
+    vector<CachedProduction> productions;
+    map<pair<char, string>, int32_t> productionIndex;
+    string text;
+    for (const auto& production : grammar) {
+        for (const string& derivation : production.derivations) {
+            CachedProduction cached = {(uint32_t)text.size(), 0, production.nonTerminal, {0, 0, 0}};
+            if (derivation != "ε") {
+                cached.length = (uint32_t)derivation.size();
+                text += derivation;
+            }
+            productionIndex.insert({{production.nonTerminal, derivation}, (int32_t)productions.size()});
+            productions.push_back(cached);
+        }
+    }
+
+    auto bits = [](const set<char>& symbols) {
+        vector<uint64_t> words(4, 0);
+        for (char symbol : symbols) words[(unsigned char)symbol / 64] |= 1ull << ((unsigned char)symbol % 64);
+        return words;
+    };
+    vector<uint64_t> first, follow;
+    vector<int32_t> cells;
+    for (char nonTerminal : nonTerminals) {
+        vector<uint64_t> words = bits(firstSets[nonTerminal]);
+        first.insert(first.end(), words.begin(), words.end());
+        words = bits(followSets[nonTerminal]);
+        follow.insert(follow.end(), words.begin(), words.end());
+        for (char column : columns) {
+            const TableEntry& entry = table[nonTerminal][column];
+            int32_t cell = entry.production.empty() ? -1 : productionIndex.at({nonTerminal, entry.production});
+            if (!entry.isValid) cell |= GRAMMAR_TABLE_CONFLICT;
+            cells.push_back(cell);
+        }
+    }
+
+    // Lay the sections out after the header, each 8-byte aligned
+    vector<char> image(sizeof(header));
+    auto append = [&image](const void* data, size_t bytes) {
+        image.resize((image.size() + 7) / 8 * 8);
+        uint64_t offset = image.size();
+        image.insert(image.end(), (const char*)data, (const char*)data + bytes);
+        return offset;
+    };
+    header.nonTerminalCount = (uint32_t)nonTerminals.size();
+    header.columnCount = (uint32_t)columns.size();
+    header.productionCount = (uint32_t)productions.size();
+    header.textBytes = (uint32_t)text.size();
+    header.nonTerminalsOffset = append(nonTerminals.data(), nonTerminals.size());
+    header.columnsOffset = append(columns.data(), columns.size());
+    header.productionsOffset = append(productions.data(), productions.size() * sizeof(CachedProduction));
+    header.textOffset = append(text.data(), text.size());
+    header.firstOffset = append(first.data(), first.size() * sizeof(uint64_t));
+    header.followOffset = append(follow.data(), follow.size() * sizeof(uint64_t));
+    header.cellsOffset = append(cells.data(), cells.size() * sizeof(int32_t));
+    image.resize((image.size() + 7) / 8 * 8);
+    header.fileBytes = image.size();
+    memcpy(image.data(), &header, sizeof(header));
+    return image;
+}
+
+// Function to write an image next to its path and rename it into place, so
+// a reader never maps a half-written file
+inline bool writeGrammarImage(const vector<char>& image, const string& path) {
+    string temporary = path + ".tmp" + to_string(getpid());
+    {
+        ofstream out(temporary, ios::binary | ios::trunc);
+        if (!out.write(image.data(), image.size())) return false;
+    }
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Where the tables in use came from
+enum GrammarTableSource { TABLES_MAPPED, TABLES_REBUILT, TABLES_BUILT_UNSAVED };
+
+// Structure to own the tables, mapped from a file or built in memory, and
+// to read them in place
+class GrammarTables {
+    const char* base = nullptr;
+    size_t mappedBytes = 0;         // Non-zero when base is a mapping
+    vector<char> owned;             // The image when it was built here
+
+    const GrammarTableHeader& header() const { return *(const GrammarTableHeader*)base; }
+
+    template <typename T>
+    const T* section(uint64_t offset) const {
+        return (const T*)(base + offset);
+    }
+
+    bool setContains(uint64_t offset, char nonTerminal, char symbol) const {
+        int row = header().rowOf[(unsigned char)nonTerminal];
+        if (row < 0) return false;
+        const uint64_t* words = section<uint64_t>(offset) + row * 4;
+        return (words[(unsigned char)symbol / 64] >> ((unsigned char)symbol % 64)) & 1;
+    }
+
+public:
+    GrammarTables() {}
+    GrammarTables(const GrammarTables&) = delete;
+    GrammarTables& operator=(const GrammarTables&) = delete;
+    GrammarTables(GrammarTables&& other) noexcept { *this = move(other); }
+    GrammarTables& operator=(GrammarTables&& other) noexcept {
+        swap(base, other.base);
+        swap(mappedBytes, other.mappedBytes);
+        swap(owned, other.owned);
+        return *this;
+    }
+    ~GrammarTables() { release(); }
+
+    void release() {
+        if (mappedBytes) munmap((void*)base, mappedBytes);
+        base = nullptr;
+        mappedBytes = 0;
+        owned.clear();
+    }
+
+    // Function to use an image built in memory
+    void adopt(vector<char> image) {
+        release();
+        owned = move(image);
+        base = owned.data();
+    }
+
+    // Function to map a file and check it holds tables for this hash; the
+    // checks read the header and the cells, nothing is copied
+    bool mapFile(const string& path, uint64_t grammarHash) {
+        release();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(GrammarTableHeader)) {
+            data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (data == MAP_FAILED) return false;
+        base = (const char*)data;
+        mappedBytes = st.st_size;
+        if (!valid(grammarHash)) {
+            release();
+            return false;
+        }
+        return true;
+    }
+
+    // Function to check the header, that every section lies inside the
+    // file, and that every cell and production points inside its section
+    bool valid(uint64_t grammarHash) const {
+        const GrammarTableHeader& h = header();
+        size_t bytes = mappedBytes ? mappedBytes : owned.size();
+        if (memcmp(h.magic, "LL1TABLE", 8) != 0 || h.version != GRAMMAR_TABLE_VERSION ||
+            h.byteOrder != GRAMMAR_TABLE_BYTE_ORDER || h.grammarHash != grammarHash || h.fileBytes != bytes ||
+            h.nonTerminalCount > 256 || h.columnCount > 256) {
+            return false;
+        }
+        auto inside = [bytes](uint64_t offset, uint64_t length) {
+            return offset % 8 == 0 && offset <= bytes && length <= bytes - offset;
+        };
+        uint64_t sets = (uint64_t)h.nonTerminalCount * 4 * sizeof(uint64_t);
+        if (!inside(h.nonTerminalsOffset, h.nonTerminalCount) || !inside(h.columnsOffset, h.columnCount) ||
+            !inside(h.productionsOffset, (uint64_t)h.productionCount * sizeof(CachedProduction)) ||
+            !inside(h.textOffset, h.textBytes) || !inside(h.firstOffset, sets) || !inside(h.followOffset, sets) ||
+            !inside(h.cellsOffset, (uint64_t)h.nonTerminalCount * h.columnCount * sizeof(int32_t))) {
+            return false;
+        }
+        for (int i = 0; i < 256; i++) {
+            if (h.rowOf[i] >= (int)h.nonTerminalCount || h.columnOf[i] >= (int)h.columnCount) return false;
+        }
+        const CachedProduction* productions = section<CachedProduction>(h.productionsOffset);
+        for (uint32_t p = 0; p < h.productionCount; p++) {
+            if (productions[p].textOffset > h.textBytes || productions[p].length > h.textBytes - productions[p].textOffset) {
+                return false;
+            }
+        }
+        const int32_t* cells = section<int32_t>(h.cellsOffset);
+        for (uint64_t i = 0; i < (uint64_t)h.nonTerminalCount * h.columnCount; i++) {
+            if (cells[i] != -1 && (uint32_t)(cells[i] & ~GRAMMAR_TABLE_CONFLICT) >= h.productionCount) return false;
+        }
+        return h.rowOf[(unsigned char)h.startSymbol] >= 0;
+    }
+
+    bool mapped() const { return mappedBytes != 0; }
+    size_t bytes() const { return mappedBytes ? mappedBytes : owned.size(); }
+    char startSymbol() const { return header().startSymbol; }
+    bool isLL1() const { return header().isLL1; }
+
+    size_t nonTerminalCount() const { return header().nonTerminalCount; }
+    char nonTerminal(size_t row) const { return section<char>(header().nonTerminalsOffset)[row]; }
+    size_t columnCount() const { return header().columnCount; }
+    char column(size_t index) const { return section<char>(header().columnsOffset)[index]; }
+
+    bool inFirst(char nonTerminal, char symbol) const { return setContains(header().firstOffset, nonTerminal, symbol); }
+    bool inFollow(char nonTerminal, char symbol) const { return setContains(header().followOffset, nonTerminal, symbol); }
+
+    // Function to look up M[nonTerminal, lookahead]: a production index,
+    // possibly with GRAMMAR_TABLE_CONFLICT set, or -1
+    int32_t cell(char nonTerminal, char lookahead) const {
+        int row = header().rowOf[(unsigned char)nonTerminal];
+        int column = header().columnOf[(unsigned char)lookahead];
+        if (row < 0 || column < 0) return -1;
+        return section<int32_t>(header().cellsOffset)[row * header().columnCount + column];
+    }
+
+    // The derivation's symbols; empty for ε
+    const char* productionText(int32_t production, size_t& length) const {
+        const CachedProduction& cached = section<CachedProduction>(header().productionsOffset)[production];
+        length = cached.length;
+        return section<char>(header().textOffset) + cached.textOffset;
+    }
+
+    string productionString(int32_t production) const {
+        size_t length;
+        const char* text = productionText(production, length);
+        return length ? string(text, length) : "ε";
+    }
+};
+
+// Function to map the tables for a grammar from path, or compute them and
+// save them there when the file is missing or stale
+inline GrammarTables loadGrammarTables(const vector<Production>& grammar, const string& path,
+                                       GrammarTableSource* source = nullptr) {
+    GrammarTables tables;
+    uint64_t hash = hashGrammar(grammar);
+    if (tables.mapFile(path, hash)) {
+        if (source) *source = TABLES_MAPPED;
+        return tables;
+    }
+    vector<char> image = buildGrammarImage(grammar);
+    bool saved = writeGrammarImage(image, path);
+    // Map what was written, so later reads go through the same pages as
+    // every other run's
+    if (!saved || !tables.mapFile(path, hash)) tables.adopt(move(image));
+    if (source) *source = saved && tables.mapped() ? TABLES_REBUILT : TABLES_BUILT_UNSAVED;
+    return tables;
+}
+
+// Function to print First and Follow sets from the tables, in the format of
+// practical-8
+inline void printCachedSets(const GrammarTables& tables) {
+    vector<char> nonTerminals;
+    for (size_t r = 0; r < tables.nonTerminalCount(); r++) nonTerminals.push_back(tables.nonTerminal(r));
+    sort(nonTerminals.begin(), nonTerminals.end());
+    for (int which = 0; which < 2; which++) {
+        cout << (which ? "\nFollow Sets:" : "First Sets:") << endl;
+        for (char nonTerminal : nonTerminals) {
+            cout << (which ? "Follow(" : "First(") << nonTerminal << ") = {";
+            bool first = true;
+            for (int symbol = 0; symbol < 128; symbol++) {
+                bool present = which ? tables.inFollow(nonTerminal, (char)symbol) : tables.inFirst(nonTerminal, (char)symbol);
+                if (!present) continue;
+                if (!first) cout << ", ";
+                if (symbol == EPSILON) cout << "ε"; else cout << (char)symbol;
+                first = false;
+            }
+            cout << "}" << endl;
+        }
+    }
+}
+
+// Function to print the parsing table from the tables, in the format of
+// printParsingTable
+inline void printParsingTable(const GrammarTables& tables) {
+    cout << "\nPredictive Parsing Table:\n";
+    cout << setw(5) << " ";
+    for (size_t c = 0; c < tables.columnCount(); c++) cout << setw(10) << tables.column(c);
+    cout << endl;
+    cout << string(5 + tables.columnCount() * 10, '-') << endl;
+    for (size_t r = 0; r < tables.nonTerminalCount(); r++) {
+        char nonTerminal = tables.nonTerminal(r);
+        cout << setw(5) << nonTerminal;
+        for (size_t c = 0; c < tables.columnCount(); c++) {
+            int32_t cell = tables.cell(nonTerminal, tables.column(c));
+            if (cell < 0) {
+                printCell("-", 10);
+            } else {
+                string entry = tables.productionString(cell & ~GRAMMAR_TABLE_CONFLICT);
+                printCell((cell & GRAMMAR_TABLE_CONFLICT) ? entry + "*" : entry, 10);
+            }
+        }
+        cout << endl;
+    }
+}
+
+// Validate input string using the mapped tables; the same driver and trace
+// as validateString, reading the dense table in place
+inline bool validateString(const string& input, const GrammarTables& tables, char startSymbol, bool showSteps) {
+    vector<char> parseStack = {'$', startSymbol};
+    size_t index = 0;
+    string inputWithEndMarker = input + "$";
+
+    if (showSteps) {
+        cout << "\nParsing Steps for \"" << input << "\":" << endl;
+        cout << left << setw(20) << "Stack" << setw(20) << "Input" << "Action" << endl;
+        cout << string(60, '-') << endl;
+    }
+
+    while (!parseStack.empty()) {
+        char top = parseStack.back();
+        char currentInput = inputWithEndMarker[index];
+        if (showSteps) {
+            cout << left << setw(20) << string(parseStack.begin(), parseStack.end()) << setw(20)
+                 << inputWithEndMarker.substr(index);
+        }
+
+        if (isTerminal(top) || top == '$') {
+            if (top != currentInput) {
+                if (showSteps) cout << "Error: Expected " << top << ", got " << currentInput << endl;
+                return false;
+            }
+            if (showSteps) cout << "Match and pop " << top << endl;
+            parseStack.pop_back();
+            index++;
+        } else if (isNonTerminal(top)) {
+            int32_t cell = tables.cell(top, currentInput);
+            if (cell < 0) {
+                if (showSteps) cout << "Error: No production for " << top << " on input " << currentInput << endl;
+                return false;
+            }
+            size_t length;
+            const char* production = tables.productionText(cell & ~GRAMMAR_TABLE_CONFLICT, length);
+            if (showSteps) cout << "Apply " << top << " -> " << tables.productionString(cell & ~GRAMMAR_TABLE_CONFLICT) << endl;
+            parseStack.pop_back();
+            for (size_t i = length; i > 0; i--) parseStack.push_back(production[i - 1]);
+        }
+    }
+    return true;
+}
+
+// Parse and validate multiple test cases with the mapped tables
+inline void validateMultipleStrings(const vector<string>& testCases, const GrammarTables& tables, char startSymbol,
+                                    bool showDetails) {
+    cout << "\nValidating Test Cases:" << endl;
+    cout << string(60, '-') << endl;
+    for (const string& testCase : testCases) {
+        bool isValid = validateString(testCase, tables, startSymbol, showDetails);
+        cout << "\"" << testCase << "\" is " << (isValid ? "Valid" : "Invalid") << " string" << endl;
+        if (showDetails) cout << string(60, '-') << endl;
+    }
+}
+
+#endif // TABLE_CACHE_H
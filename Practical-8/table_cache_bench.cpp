@@ -0,0 +1,169 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include "grammar.h"
+#include "ll1.h"
+#include "sentences.h"
+#include "table_cache.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Function to make a grammar over all 26 non-terminals, S first, with
+// 'alternatives' productions each of up to 'length' symbols; every
+// non-terminal has one production of terminals only, so all are productive
+vector<Production> randomGrammar(int alternatives, int length, uint64_t seed) {
+    mt19937_64 rng(seed);
+    string terminals = "abcdefghijklmnopqrstuvwxyz0123456789+-*/%=<>!&|^~.,;:?@#()[]{}";
+    string nonTerminals = "SABCDEFGHIJKLMNOPQRTUVWXYZ";
+    vector<Production> grammar;
+    for (char nonTerminal : nonTerminals) {
+        Production production = {nonTerminal, {}};
+        for (int a = 0; a < alternatives; a++) {
+            string derivation(1, terminals[rng() % terminals.size()]);
+            int symbols = 1 + rng() % length;
+            for (int i = 1; i < symbols; i++) {
+                bool terminal = a == 0 || rng() % 3 != 0;
+                derivation += terminal ? terminals[rng() % terminals.size()] : nonTerminals[rng() % nonTerminals.size()];
+            }
+            production.derivations.push_back(derivation);
+        }
+        if (rng() % 4 == 0) production.derivations.push_back("ε");
+        grammar.push_back(production);
+    }
+    return grammar;
+}
+
+double millisecondsSince(steady_clock::time_point start) {
+    return duration<double, milli>(steady_clock::now() - start).count();
+}
+
+// Function to take the median of a set of timings
+double median(vector<double> times) {
+    sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+// Function to compare the mapped tables with the ones computed by ll1.h,
+// cell by cell and set by set, and the two drivers on generated sentences
+bool agrees(const vector<Production>& grammar, const GrammarTables& tables, size_t& sentences) {
+    set<char> terminals = getTerminals(grammar);
+    map<char, set<char>> firstSets = computeFirstSets(grammar);
+    map<char, set<char>> followSets = computeFollowSets(grammar, firstSets);
+    bool isLL1;
+    map<char, map<char, TableEntry>> table = constructParsingTable(grammar, firstSets, followSets, isLL1, terminals);
+    if (isLL1 != tables.isLL1()) return false;
+    for (const auto& [nonTerminal, row] : table) {
+        for (int symbol = 0; symbol < 128; symbol++) {
+            if (firstSets[nonTerminal].count((char)symbol) != tables.inFirst(nonTerminal, (char)symbol)) return false;
+            if (followSets[nonTerminal].count((char)symbol) != tables.inFollow(nonTerminal, (char)symbol)) return false;
+        }
+        for (const auto& [lookahead, entry] : row) {
+            int32_t cell = tables.cell(nonTerminal, lookahead);
+            string production = cell < 0 ? "" : tables.productionString(cell & ~GRAMMAR_TABLE_CONFLICT);
+            bool conflict = cell >= 0 && (cell & GRAMMAR_TABLE_CONFLICT);
+            if (production != entry.production || conflict == entry.isValid) return false;
+        }
+    }
+
+    SentenceGenerator generator(grammar, grammar[0].nonTerminal, 48);
+    SentenceOptions options;
+    options.maxLength = 64;
+    options.mutationRate = 0.3;
+    string sentence;
+    for (sentences = 0; sentences < 2000; sentences++) {
+        generator.next(sentence, options);
+        if (validateString(sentence, table, grammar[0].nonTerminal, false) !=
+            validateString(sentence, tables, grammar[0].nonTerminal, false)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Usage: table_cache_bench [-f grammar file] [cache path]
+int main(int argc, char** argv) {
+    vector<pair<string, vector<Production>>> grammars;
+    int next = 1;
+    if (argc > 2 && string(argv[1]) == "-f") {
+        ifstream in(argv[2]);
+        grammars.push_back({argv[2], readGrammar(in)});
+        next = 3;
+    } else {
+        grammars.push_back({"practical-8", {{'S', {"ABC", "D"}}, {'A', {"a", "ε"}}, {'B', {"b", "ε"}},
+                                            {'C', {"(S)", "c"}}, {'D', {"AC"}}}});
+        grammars.push_back({"26 x 8 x 8", randomGrammar(8, 8, 1)});
+        grammars.push_back({"26 x 32 x 16", randomGrammar(32, 16, 2)});
+        grammars.push_back({"26 x 128 x 24", randomGrammar(128, 24, 3)});
+    }
+    string path = argc > next ? argv[next] : "table_cache_bench.tables";
+
+    cout << "Startup: computing First, Follow and the table (cold, no cache file) against mapping the" << endl;
+    cout << "cached tables (warm); medians, in ms" << endl;
+    cout << left << setw(16) << "Grammar" << right << setw(8) << "Prods" << setw(10) << "Bytes" << setw(12) << "Compute"
+         << setw(12) << "Cold" << setw(12) << "Warm" << setw(10) << "Speedup" << "  Check" << endl;
+    cout << string(92, '-') << endl;
+    for (const auto& [name, grammar] : grammars) {
+        if (grammar.empty()) {
+            cerr << "No grammar in " << name << endl;
+            return 1;
+        }
+        size_t productions = 0;
+        for (const auto& production : grammar) productions += production.derivations.size();
+
+        // What every run paid before: the analysis alone
+        vector<double> compute, cold, warm;
+        for (int run = 0; run < 5; run++) {
+            auto start = steady_clock::now();
+            map<char, set<char>> firstSets = computeFirstSets(grammar);
+            map<char, set<char>> followSets = computeFollowSets(grammar, firstSets);
+            bool isLL1;
+            constructParsingTable(grammar, firstSets, followSets, isLL1, getTerminals(grammar));
+            compute.push_back(millisecondsSince(start));
+        }
+
+        // A missing file: compute, write and map
+        GrammarTableSource source = TABLES_MAPPED;
+        for (int run = 0; run < 5; run++) {
+            remove(path.c_str());
+            auto start = steady_clock::now();
+            GrammarTables tables = loadGrammarTables(grammar, path, &source);
+            cold.push_back(millisecondsSince(start));
+        }
+        bool saved = source == TABLES_REBUILT;
+
+        // The file in place: map and check it
+        size_t bytes = 0;
+        for (int run = 0; run < 101; run++) {
+            auto start = steady_clock::now();
+            GrammarTables tables = loadGrammarTables(grammar, path, &source);
+            warm.push_back(millisecondsSince(start));
+            bytes = tables.bytes();
+            saved &= source == TABLES_MAPPED;
+        }
+
+        GrammarTables tables = loadGrammarTables(grammar, path, &source);
+        size_t sentences = 0;
+        bool same = agrees(grammar, tables, sentences);
+
+        // An edited grammar must not pick up the old tables
+        vector<Production> edited = grammar;
+        edited.back().derivations.push_back("z");
+        GrammarTableSource editedSource;
+        GrammarTables rebuilt = loadGrammarTables(edited, path, &editedSource);
+        bool stale = editedSource == TABLES_REBUILT && rebuilt.productionString((int32_t)productions) == "z";
+
+        cout << left << setw(16) << name << right << setw(8) << productions << setw(10) << bytes << fixed
+             << setprecision(3) << setw(12) << median(compute) << setw(12) << median(cold) << setw(12) << median(warm)
+             << setprecision(0) << setw(9) << median(compute) / median(warm) << "x" << defaultfloat << "  "
+             << (same && saved && stale ? "ok" : "MISMATCH") << ", " << sentences << " sentences" << endl;
+    }
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,416 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <map>
+#include <string>
+#include <algorithm>
+#include "grammar.h"
+#include "ll1.h"
+
+using namespace std;
+
+// Grammar rewrites that turn a grammar into an equivalent LL(1) one, so the
+// table-driven parser can take it: left recursion elimination (direct and
+// indirect) and left factoring. Non-terminals are single upper-case letters,
+// so each new non-terminal takes an unused letter; a grammar that needs more
+// than 26 is reported as incomplete. The start symbol stays first, since
+// computeFollowSets takes grammar[0] as the start.
+
+// Structure to report what the rewrites did
+struct TransformReport {
+    size_t nonTerminalsBefore = 0, alternativesBefore = 0, symbolsBefore = 0;
+    size_t nonTerminalsAfter = 0, alternativesAfter = 0, symbolsAfter = 0;
+    vector<string> steps;       // One line per rewrite
+    vector<string> conflicts;   // Conflicts the rewrites could not remove
+    bool complete = true;       // False when letters or rounds ran out
+    bool isLL1 = false;         // Result of re-running constructParsingTable
+};
+
+// Function to count non-terminals, alternatives and symbols (ε counts as none)
+inline void grammarSize(const vector<Production>& grammar, size_t& nonTerminals, size_t& alternatives, size_t& symbols) {
+    nonTerminals = grammar.size();
+    alternatives = symbols = 0;
+    for (const auto& production : grammar) {
+        alternatives += production.derivations.size();
+        for (const string& derivation : production.derivations) {
+            if (derivation != "ε") symbols += derivation.size();
+        }
+    }
+}
+
+// Function to print a grammar one non-terminal per line
+inline void printGrammar(const vector<Production>& grammar) {
+    for (const auto& production : grammar) {
+        cout << "  " << production.nonTerminal << " ->";
+        for (size_t i = 0; i < production.derivations.size(); i++) {
+            cout << (i ? " | " : " ") << production.derivations[i];
+        }
+        cout << endl;
+    }
+}
+
+// The rewrites work on alternatives with ε spelled as the empty string
+class GrammarRewriter {
+    vector<Production> grammar;
+    TransformReport& report;
+
+    int find(char nonTerminal) const {
+        for (size_t i = 0; i < grammar.size(); i++) {
+            if (grammar[i].nonTerminal == nonTerminal) return (int)i;
+        }
+        return -1;
+    }
+
+    // Function to take an unused upper-case letter for a new non-terminal
+    char freshNonTerminal(char base) {
+        set<char> used;
+        for (const auto& production : grammar) {
+            used.insert(production.nonTerminal);
+            for (const string& derivation : production.derivations) {
+                used.insert(derivation.begin(), derivation.end());
+            }
+        }
+        for (char c = 'Z'; c >= 'A'; c--) {
+            if (!used.count(c)) return c;
+        }
+        report.complete = false;
+        report.steps.push_back(string("No letter left for a new non-terminal from ") + base);
+        return 0;
+    }
+
+    static void removeDuplicates(vector<string>& derivations) {
+        vector<string> unique;
+        for (const string& derivation : derivations) {
+            if (std::find(unique.begin(), unique.end(), derivation) == unique.end()) unique.push_back(derivation);
+        }
+        derivations = unique;
+    }
+
+    // Function to find the non-terminals each one can begin with
+    map<char, set<char>> leftCorners() const {
+        map<char, set<char>> corners;
+        for (const auto& production : grammar) {
+            for (const string& derivation : production.derivations) {
+                if (!derivation.empty() && isNonTerminal(derivation[0])) {
+                    corners[production.nonTerminal].insert(derivation[0]);
+                }
+            }
+        }
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto& [nonTerminal, reach] : corners) {
+                for (char via : set<char>(reach)) {
+                    for (char next : corners[via]) {
+                        if (reach.insert(next).second) changed = true;
+                    }
+                }
+            }
+        }
+        return corners;
+    }
+
+    // Function to replace A -> A α | β with A -> β A', A' -> α A' | ε
+    void eliminateDirect(size_t i) {
+        char a = grammar[i].nonTerminal;
+        vector<string> recursive, other;
+        for (const string& derivation : grammar[i].derivations) {
+            if (!derivation.empty() && derivation[0] == a) {
+                // A -> A adds nothing
+                if (derivation.size() > 1) recursive.push_back(derivation.substr(1));
+            } else {
+                other.push_back(derivation);
+            }
+        }
+        if (recursive.empty()) {
+            grammar[i].derivations = other;
+            return;
+        }
+        char tail = freshNonTerminal(a);
+        if (!tail) return;
+
+        Production tailProduction = {tail, {}};
+        for (const string& alpha : recursive) tailProduction.derivations.push_back(alpha + tail);
+        tailProduction.derivations.push_back("");
+        grammar[i].derivations.clear();
+        for (const string& beta : other) grammar[i].derivations.push_back(beta + tail);
+        grammar.insert(grammar.begin() + i + 1, tailProduction);
+        report.steps.push_back(string("Removed left recursion on ") + a + " with new non-terminal " + tail);
+    }
+
+    // Function to replace the leading non-terminal of A's alternatives in
+    // 'which' by each of its own alternatives; false if the grammar is unchanged
+    bool substituteLeading(size_t i, const set<size_t>& which) {
+        vector<string> result;
+        vector<string> steps;
+        const vector<string> derivations = grammar[i].derivations;
+        auto lead = [&](size_t k) {
+            const string& derivation = derivations[k];
+            return which.count(k) && !derivation.empty() && isNonTerminal(derivation[0]) ? find(derivation[0]) : -1;
+        };
+        for (size_t k = 0; k < derivations.size(); k++) {
+            const string& derivation = derivations[k];
+            int from = lead(k);
+            if (from < 0 || (size_t)from == i) {
+                result.push_back(derivation);
+                continue;
+            }
+            // An expansion adds something unless an alternative that stays already spells it
+            bool adds = false;
+            for (const string& expansion : grammar[from].derivations) {
+                string alternative = expansion + derivation.substr(1);
+                bool present = std::find(result.begin(), result.end(), alternative) != result.end();
+                for (size_t m = k + 1; m < derivations.size() && !present; m++) {
+                    present = derivations[m] == alternative && (lead(m) < 0 || (size_t)lead(m) == i);
+                }
+                adds = adds || !present;
+                result.push_back(alternative);
+            }
+            string rule = string(1, grammar[i].nonTerminal) + " -> " + derivation;
+            steps.push_back(adds ? string("Substituted ") + derivation[0] + " into " + rule
+                                 : "Dropped " + rule + ", its expansions are already alternatives");
+        }
+        removeDuplicates(result);
+        if (result == derivations) return false;
+        report.steps.insert(report.steps.end(), steps.begin(), steps.end());
+        grammar[i].derivations = result;
+        return true;
+    }
+
+    // Function to factor one group of alternatives sharing a first symbol
+    bool factorOnce(size_t i) {
+        vector<string>& derivations = grammar[i].derivations;
+        for (size_t k = 0; k < derivations.size(); k++) {
+            if (derivations[k].empty()) continue;
+            vector<size_t> group;
+            for (size_t m = k; m < derivations.size(); m++) {
+                if (!derivations[m].empty() && derivations[m][0] == derivations[k][0]) group.push_back(m);
+            }
+            if (group.size() < 2) continue;
+
+            // Longest prefix the whole group shares
+            size_t length = derivations[k].size();
+            for (size_t m : group) {
+                size_t common = 0;
+                while (common < length && common < derivations[m].size() && derivations[m][common] == derivations[k][common]) {
+                    common++;
+                }
+                length = common;
+            }
+            string prefix = derivations[k].substr(0, length);
+            char tail = freshNonTerminal(grammar[i].nonTerminal);
+            if (!tail) return false;
+
+            Production tailProduction = {tail, {}};
+            vector<string> kept;
+            for (size_t m = 0; m < derivations.size(); m++) {
+                if (std::find(group.begin(), group.end(), m) != group.end()) {
+                    tailProduction.derivations.push_back(derivations[m].substr(length));
+                } else {
+                    kept.push_back(derivations[m]);
+                }
+            }
+            kept.insert(kept.begin() + k, prefix + tail);
+            derivations = kept;
+            report.steps.push_back(string("Factored ") + grammar[i].nonTerminal + " -> " + prefix + "... into " + tail);
+            grammar.insert(grammar.begin() + i + 1, tailProduction);
+            return true;
+        }
+        return false;
+    }
+
+    // Function to find two alternatives of one non-terminal that the LL(1)
+    // table cannot tell apart. Returns the non-terminal's index, or -1, and
+    // the clashing alternatives in 'which'.
+    int findConflict(set<size_t>& which, string& description) const {
+        vector<Production> external = exported();
+        map<char, set<char>> firstSets = computeFirstSets(external);
+        map<char, set<char>> followSets = computeFollowSets(external, firstSets);
+        for (size_t i = 0; i < external.size(); i++) {
+            const vector<string>& derivations = external[i].derivations;
+            vector<set<char>> firsts;
+            for (const string& derivation : derivations) firsts.push_back(calculateFirstOfString(derivation, firstSets));
+            for (size_t k = 0; k < derivations.size(); k++) {
+                for (size_t m = k + 1; m < derivations.size(); m++) {
+                    for (char c : firsts[k]) {
+                        bool clash = c != EPSILON && firsts[m].count(c);
+                        bool bothEmpty = c == EPSILON && firsts[m].count(EPSILON);
+                        if (clash || bothEmpty) {
+                            which = {k, m};
+                            description = string("First/First on ") + external[i].nonTerminal + ": " + derivations[k] +
+                                          " | " + derivations[m];
+                            return (int)i;
+                        }
+                    }
+                    // One alternative derives ε and the other starts with
+                    // something that may follow the non-terminal
+                    for (int side = 0; side < 2; side++) {
+                        const set<char>& nullable = side ? firsts[m] : firsts[k];
+                        const set<char>& other = side ? firsts[k] : firsts[m];
+                        if (!nullable.count(EPSILON)) continue;
+                        for (char c : followSets.at(external[i].nonTerminal)) {
+                            if (other.count(c)) {
+                                which = {k, m};
+                                description = string("First/Follow on ") + external[i].nonTerminal + ": " +
+                                              derivations[k] + " | " + derivations[m];
+                                return (int)i;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return -1;
+    }
+
+public:
+    GrammarRewriter(const vector<Production>& input, TransformReport& transformReport) : report(transformReport) {
+        grammar = input;
+        for (auto& production : grammar) {
+            for (string& derivation : production.derivations) {
+                if (derivation == "ε") derivation.clear();
+            }
+            removeDuplicates(production.derivations);
+        }
+    }
+
+    // The grammar with ε spelled out again, as the rest of Practical-8 expects
+    vector<Production> exported() const {
+        vector<Production> result = grammar;
+        for (auto& production : result) {
+            for (string& derivation : production.derivations) {
+                if (derivation.empty()) derivation = "ε";
+            }
+        }
+        return result;
+    }
+
+    // Function to eliminate left recursion. Non-terminals are taken from the
+    // last to the start symbol, so a cycle through several of them is
+    // unrolled into the one declared first, which is usually the one the
+    // recursion belongs to. A_i -> A_j γ (A_j taken earlier) is expanded only
+    // when A_j can begin with A_i, so grammars without indirect recursion are
+    // left as they are. Recursion hidden behind a nullable prefix
+    // (A -> B A c, B =>* ε) surfaces when leftFactor substitutes B, and is
+    // removed then.
+    void eliminateLeftRecursion() {
+        vector<char> order;
+        for (auto it = grammar.rbegin(); it != grammar.rend(); ++it) order.push_back(it->nonTerminal);
+        for (size_t p = 0; p < order.size(); p++) {
+            for (size_t q = 0; q < p; q++) {
+                map<char, set<char>> corners = leftCorners();
+                if (!corners[order[q]].count(order[p])) continue;
+                int i = find(order[p]);
+                set<size_t> which;
+                for (size_t k = 0; k < grammar[i].derivations.size(); k++) {
+                    const string& derivation = grammar[i].derivations[k];
+                    if (!derivation.empty() && derivation[0] == order[q]) which.insert(k);
+                }
+                if (!which.empty()) substituteLeading(i, which);
+            }
+            eliminateDirect(find(order[p]));
+        }
+    }
+
+    // Function to left-factor common prefixes, and, when two alternatives
+    // still clash through a leading non-terminal, substitute it so the
+    // clash becomes a common prefix. Stops after maxRounds substitutions,
+    // since a grammar that is not LL(1) for any rewriting never settles.
+    void leftFactor(int maxRounds = 32) {
+        for (int round = 0; round <= maxRounds && report.complete; round++) {
+            bool factored = true;
+            while (factored && report.complete) {
+                factored = false;
+                for (size_t i = 0; i < grammar.size(); i++) {
+                    if (factorOnce(i)) factored = true;
+                }
+            }
+
+            // Productions no longer reachable would still feed Follow sets
+            removeUnreachable();
+            set<size_t> which;
+            string description;
+            int i = findConflict(which, description);
+            if (i < 0) return;
+            if (round == maxRounds || !substituteLeading(i, which)) {
+                report.conflicts.push_back(description);
+                if (round == maxRounds) report.complete = false;
+                return;
+            }
+            // Substituting a nullable prefix can expose left recursion
+            eliminateDirect(i);
+        }
+    }
+
+    // Function to drop non-terminals the start symbol can no longer reach
+    void removeUnreachable() {
+        if (grammar.empty()) return;
+        set<char> reached = {grammar[0].nonTerminal};
+        vector<char> work = {grammar[0].nonTerminal};
+        while (!work.empty()) {
+            int i = find(work.back());
+            work.pop_back();
+            if (i < 0) continue;
+            for (const string& derivation : grammar[i].derivations) {
+                for (char c : derivation) {
+                    if (isNonTerminal(c) && reached.insert(c).second) work.push_back(c);
+                }
+            }
+        }
+        vector<Production> kept;
+        for (const auto& production : grammar) {
+            if (reached.count(production.nonTerminal)) {
+                kept.push_back(production);
+            } else {
+                report.steps.push_back(string("Dropped unreachable ") + production.nonTerminal);
+            }
+        }
+        grammar = kept;
+    }
+};
+
+// Function to rewrite a grammar into LL(1) form: eliminate left recursion,
+// left-factor, drop what became unreachable, then re-run the conflict check
+// constructParsingTable does
+inline vector<Production> makeLL1(const vector<Production>& grammar, TransformReport& report) {
+    report = TransformReport();
+    grammarSize(grammar, report.nonTerminalsBefore, report.alternativesBefore, report.symbolsBefore);
+
+    GrammarRewriter rewriter(grammar, report);
+    rewriter.eliminateLeftRecursion();
+    if (report.complete) rewriter.leftFactor();
+    rewriter.removeUnreachable();
+    vector<Production> result = rewriter.exported();
+
+    grammarSize(result, report.nonTerminalsAfter, report.alternativesAfter, report.symbolsAfter);
+    map<char, set<char>> firstSets = computeFirstSets(result);
+    map<char, set<char>> followSets = computeFollowSets(result, firstSets);
+    constructParsingTable(result, firstSets, followSets, report.isLL1, getTerminals(result));
+    return result;
+}
+
+// Print what makeLL1 did
+inline void printTransformReport(const TransformReport& report) {
+    cout << "\nRewrites:" << endl;
+    for (const string& step : report.steps) cout << "  " << step << endl;
+    if (report.steps.empty()) cout << "  (none)" << endl;
+    for (const string& conflict : report.conflicts) cout << "  Unresolved " << conflict << endl;
+
+    cout << "\nGrammar Size:" << endl;
+    cout << left << setw(16) << "" << right << setw(8) << "Before" << setw(8) << "After" << endl;
+    cout << left << setw(16) << "Non-terminals" << right << setw(8) << report.nonTerminalsBefore << setw(8)
+         << report.nonTerminalsAfter << endl;
+    cout << left << setw(16) << "Alternatives" << right << setw(8) << report.alternativesBefore << setw(8)
+         << report.alternativesAfter << endl;
+    cout << left << setw(16) << "Symbols" << right << setw(8) << report.symbolsBefore << setw(8)
+         << report.symbolsAfter << endl;
+
+    cout << "\nThe rewritten grammar is " << (report.isLL1 ? "LL(1)" : "not LL(1)")
+         << (report.complete ? "" : " (rewriting stopped early)") << endl;
+}
+
+#endif
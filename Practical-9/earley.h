@@ -0,0 +1,449 @@
+#ifndef EARLEY_H
+#define EARLEY_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include "../Practical-8/grammar.h"
+
+using namespace std;
+
+// General context-free parsing for the grammars bison only accepts by
+// resolving conflicts, such as this practical's dangling else:
+//   S -> iEtSD | a,  D -> eS | ε,  E -> b
+// EarleyParser::parse builds a shared packed parse forest (SPPF) following
+// Scott's construction from the Earley recogniser: one node per
+// (symbol or partial rule, start, end), with each way of deriving it kept
+// as a packed family under that node. Every parse of the input shares the
+// same nodes, so the forest holds O(n^3) families even when there are
+// exponentially many trees. EarleyParser::recognize answers yes/no
+// without a forest and uses Leo's transitive items, which make
+// right-recursive grammars linear instead of quadratic.
+
+// Structure for one way of deriving a forest node: left is the node for
+// everything before the last symbol (or -1), right the node for the last
+// symbol (or -1 for ε)
+struct PackedFamily {
+    int left;
+    int right;
+};
+
+// Structure for a forest node. label is a grammar symbol (0-255) or, for
+// a partial rule, 256 + the parser's slot number.
+struct ForestNode {
+    int label;
+    int start;
+    int end;
+    vector<PackedFamily> families;
+};
+
+// Structure to hold the counts the parser reports
+struct EarleyStats {
+    size_t items = 0;          // Earley items over every set
+    size_t largestSet = 0;
+    size_t leoShortcuts = 0;   // Completions taken through a Leo item
+    size_t nodes = 0;          // Forest size
+    size_t families = 0;
+    size_t ambiguousNodes = 0; // Nodes with more than one family
+};
+
+class EarleyParser {
+    struct Rule {
+        char lhs;
+        string rhs;            // Empty for ε
+        int slotBase;          // Slot of the item with the dot at the start
+    };
+
+    struct Item {
+        int slot;
+        int origin;
+        int node;              // Forest node so far, or -1
+        int nextWaiting;       // Previous item in this set waiting on the same symbol
+    };
+
+    struct ItemKey {
+        int slot, origin, node;
+        bool operator==(const ItemKey& other) const {
+            return slot == other.slot && origin == other.origin && node == other.node;
+        }
+    };
+
+    struct ItemKeyHash {
+        size_t operator()(const ItemKey& key) const {
+            uint64_t h = (uint64_t)(uint32_t)key.slot * 0x9E3779B97F4A7C15ull;
+            h ^= ((uint64_t)(uint32_t)key.origin << 32 | (uint32_t)key.node) * 0xC2B2AE3D27D4EB4Full;
+            return (size_t)(h ^ (h >> 29));
+        }
+    };
+
+    vector<Rule> rules;
+    vector<int> slotRule;                 // Slot to its rule
+    vector<int> slotDot;                  // Slot to the dot position
+    vector<vector<int>> rulesFor;         // Non-terminal index to its rules
+    int nonTerminalIndex[256];
+    vector<char> nonTerminals;
+    char start;
+
+    // Per parse
+    const string* input = nullptr;
+    bool buildForest = false;
+    bool useLeo = false;
+    vector<vector<Item>> sets;
+    vector<int> waitingHeads;             // sets x non-terminals, first waiting item or -1
+    unordered_set<ItemKey, ItemKeyHash> seenCurrent, seenNext;
+    vector<Item> scanCurrent, scanNext;   // Items about to read the next character
+    vector<int> nullableNode;             // Per non-terminal: (D, i, i) completed in this set, or -1
+    vector<int> nullableTouched;
+    vector<pair<int, int>> leoMemo;       // sets x non-terminals: topmost (slot, origin); slot -1 none, -2 unknown
+    vector<ForestNode>* nodes = nullptr;
+    unordered_map<uint64_t, int> currentNodes;  // (label, start) to node, for nodes ending here
+    unordered_set<ItemKey, ItemKeyHash> familiesSeen;
+    EarleyStats* stats = nullptr;
+
+    char nextSymbol(int slot) const {
+        const Rule& rule = rules[slotRule[slot]];
+        size_t dot = slotDot[slot];
+        return dot < rule.rhs.size() ? rule.rhs[dot] : 0;
+    }
+
+    int findNode(int label, int from, int to) {
+        uint64_t key = (uint64_t)(uint32_t)label << 32 | (uint32_t)from;
+        auto it = currentNodes.find(key);
+        if (it != currentNodes.end()) return it->second;
+        nodes->push_back({label, from, to, {}});
+        currentNodes[key] = (int)nodes->size() - 1;
+        return (int)nodes->size() - 1;
+    }
+
+    void addFamily(int node, int left, int right) {
+        vector<PackedFamily>& families = (*nodes)[node].families;
+        // Most nodes have one or two families; only the rest need the table
+        if (families.size() < 8) {
+            for (const PackedFamily& family : families) {
+                if (family.left == left && family.right == right) return;
+            }
+            if (families.size() == 7) {
+                for (const PackedFamily& family : families) familiesSeen.insert({node, family.left, family.right});
+                familiesSeen.insert({node, left, right});
+            }
+            families.push_back({left, right});
+        } else if (familiesSeen.insert({node, left, right}).second) {
+            families.push_back({left, right});
+        }
+    }
+
+    // Function to give the item with the dot moved past a symbol whose
+    // node is v its forest node (Scott's MAKE_NODE)
+    int makeNode(int slotAfter, int from, int to, int w, int v) {
+        const Rule& rule = rules[slotRule[slotAfter]];
+        size_t dot = slotDot[slotAfter];
+        bool complete = dot == rule.rhs.size();
+        if (dot == 1 && !complete) return v;
+        int y = findNode(complete ? (unsigned char)rule.lhs : 256 + slotAfter, from, to);
+        addFamily(y, w, v);
+        return y;
+    }
+
+    // Function to add an item to the set being built; items about to read
+    // a terminal go to the scan list only if that terminal comes next
+    void addCurrent(size_t i, int slot, int origin, int node) {
+        if (!seenCurrent.insert({slot, origin, node}).second) return;
+        char next = nextSymbol(slot);
+        if (next && !isNonTerminal(next)) {
+            if (i < input->size() && (*input)[i] == next) scanCurrent.push_back({slot, origin, node, -1});
+            return;
+        }
+        pushItem(i, slot, origin, node);
+    }
+
+    void addNext(size_t i, int slot, int origin, int node) {
+        if (!seenNext.insert({slot, origin, node}).second) return;
+        char next = nextSymbol(slot);
+        if (next && !isNonTerminal(next)) {
+            if (i < input->size() && (*input)[i] == next) scanNext.push_back({slot, origin, node, -1});
+            return;
+        }
+        pushItem(i, slot, origin, node);
+    }
+
+    void pushItem(size_t i, int slot, int origin, int node) {
+        char next = nextSymbol(slot);
+        int link = -1;
+        if (next) {
+            int& head = waitingHeads[i * nonTerminals.size() + nonTerminalIndex[(unsigned char)next]];
+            link = head;
+            head = (int)sets[i].size();
+        }
+        sets[i].push_back({slot, origin, node, link});
+    }
+
+    // Function to find Leo's topmost item for completing non-terminal nt
+    // back to set h: when h holds exactly one item waiting on nt and nt is
+    // its last symbol, completing nt completes that item too, and so on up
+    // the chain. Returns {slot, origin} of the top, or slot -1 for none.
+    pair<int, int> leoItem(size_t h, int nt) {
+        pair<int, int>& memo = leoMemo[h * nonTerminals.size() + nt];
+        if (memo.first != -2) return memo;
+        memo = {-1, 0};  // Also guards against unit cycles
+        int only = waitingHeads[h * nonTerminals.size() + nt];
+        if (only < 0 || sets[h][only].nextWaiting >= 0) return memo;
+        const Item& item = sets[h][only];
+        const Rule& rule = rules[slotRule[item.slot]];
+        if ((size_t)slotDot[item.slot] + 1 != rule.rhs.size()) return memo;
+
+        pair<int, int> above = leoItem(item.origin, nonTerminalIndex[(unsigned char)rule.lhs]);
+        pair<int, int> result = above.first >= 0 ? above : make_pair(item.slot + 1, item.origin);
+        leoMemo[h * nonTerminals.size() + nt] = result;
+        return result;
+    }
+
+    void complete(size_t i, size_t index) {
+        Item item = sets[i][index];
+        const Rule& rule = rules[slotRule[item.slot]];
+        int nt = nonTerminalIndex[(unsigned char)rule.lhs];
+        int w = item.node;
+        if (buildForest && w < 0) {
+            // An ε rule: its node is (D, i, i) with an empty family
+            w = findNode((unsigned char)rule.lhs, (int)i, (int)i);
+            addFamily(w, -1, -1);
+            sets[i][index].node = w;
+        }
+        size_t h = item.origin;
+        if (h == i) {
+            if (nullableNode[nt] < 0) nullableTouched.push_back(nt);
+            nullableNode[nt] = buildForest ? w : 0;
+        }
+        if (useLeo && h < i) {
+            pair<int, int> top = leoItem(h, nt);
+            if (top.first >= 0) {
+                stats->leoShortcuts++;
+                addCurrent(i, top.first, top.second, -1);
+                return;
+            }
+        }
+        for (int k = waitingHeads[h * nonTerminals.size() + nt]; k >= 0; k = sets[h][k].nextWaiting) {
+            Item waiting = sets[h][k];
+            int y = buildForest ? makeNode(waiting.slot + 1, waiting.origin, (int)i, waiting.node, w) : -1;
+            addCurrent(i, waiting.slot + 1, waiting.origin, y);
+        }
+    }
+
+    void predict(size_t i, const Item& item) {
+        int nt = nonTerminalIndex[(unsigned char)nextSymbol(item.slot)];
+        for (int r : rulesFor[nt]) addCurrent(i, rules[r].slotBase, (int)i, -1);
+        // The non-terminal may already have been completed empty in this set
+        if (nullableNode[nt] >= 0) {
+            int y = buildForest ? makeNode(item.slot + 1, item.origin, (int)i, item.node, nullableNode[nt]) : -1;
+            addCurrent(i, item.slot + 1, item.origin, y);
+        }
+    }
+
+    // Function to run the recogniser, building the forest when asked.
+    // Returns the root node, 0 for an accepted recognise-only run, or -1.
+    int run(const string& text, bool forest, bool leo, vector<ForestNode>* forestNodes, EarleyStats* runStats) {
+        EarleyStats localStats;
+        stats = runStats ? runStats : &localStats;
+        *stats = EarleyStats();
+        input = &text;
+        buildForest = forest;
+        useLeo = leo;
+        nodes = forestNodes;
+        size_t n = text.size();
+        size_t width = nonTerminals.size();
+        if (index(start) < 0) return -1;
+
+        sets.assign(n + 1, {});
+        waitingHeads.assign((n + 1) * width, -1);
+        leoMemo.assign(leo ? (n + 1) * width : 0, {-2, 0});
+        nullableNode.assign(width, -1);
+        // Fresh tables: clear() keeps the buckets of an earlier, larger
+        // parse, and every set clears them again
+        seenCurrent = decltype(seenCurrent)();
+        seenNext = decltype(seenNext)();
+        currentNodes = decltype(currentNodes)();
+        familiesSeen = decltype(familiesSeen)();
+        scanCurrent.clear();
+        scanNext.clear();
+
+        for (int r : rulesFor[index(start)]) addCurrent(0, rules[r].slotBase, 0, -1);
+        for (size_t i = 0; i <= n; i++) {
+            for (size_t k = 0; k < sets[i].size(); k++) {
+                if (nextSymbol(sets[i][k].slot)) {
+                    predict(i, sets[i][k]);
+                } else {
+                    complete(i, k);
+                }
+            }
+            for (int nt : nullableTouched) nullableNode[nt] = -1;
+            nullableTouched.clear();
+            stats->items += sets[i].size() + scanCurrent.size();
+            stats->largestSet = max(stats->largestSet, sets[i].size() + scanCurrent.size());
+
+            // Read the next character
+            currentNodes.clear();
+            if (i < n) {
+                int v = -1;
+                if (buildForest && !scanCurrent.empty()) {
+                    nodes->push_back({(unsigned char)text[i], (int)i, (int)i + 1, {}});
+                    v = (int)nodes->size() - 1;
+                }
+                for (const Item& item : scanCurrent) {
+                    int y = buildForest ? makeNode(item.slot + 1, item.origin, (int)i + 1, item.node, v) : -1;
+                    addNext(i + 1, item.slot + 1, item.origin, y);
+                }
+            }
+            swap(seenCurrent, seenNext);
+            seenNext.clear();
+            swap(scanCurrent, scanNext);
+            scanNext.clear();
+            if (sets[min(i + 1, n)].empty() && scanCurrent.empty() && i < n) return -1;
+        }
+
+        for (const Item& item : sets[n]) {
+            const Rule& rule = rules[slotRule[item.slot]];
+            if (rule.lhs == start && item.origin == 0 && !nextSymbol(item.slot)) {
+                if (!buildForest) return 0;
+                return item.node;
+            }
+        }
+        return -1;
+    }
+
+    int index(char nonTerminal) const { return nonTerminalIndex[(unsigned char)nonTerminal]; }
+
+public:
+    EarleyParser(const vector<Production>& grammar, char startSymbol) : start(startSymbol) {
+        fill(begin(nonTerminalIndex), end(nonTerminalIndex), -1);
+        for (const auto& production : grammar) {
+            if (nonTerminalIndex[(unsigned char)production.nonTerminal] < 0) {
+                nonTerminalIndex[(unsigned char)production.nonTerminal] = (int)nonTerminals.size();
+                nonTerminals.push_back(production.nonTerminal);
+                rulesFor.emplace_back();
+            }
+        }
+        for (const auto& production : grammar) {
+            for (const string& derivation : production.derivations) {
+                string rhs = derivation == "ε" ? "" : derivation;
+                for (char c : rhs) {
+                    // A non-terminal with no productions derives nothing
+                    if (isNonTerminal(c) && nonTerminalIndex[(unsigned char)c] < 0) {
+                        nonTerminalIndex[(unsigned char)c] = (int)nonTerminals.size();
+                        nonTerminals.push_back(c);
+                        rulesFor.emplace_back();
+                    }
+                }
+                rulesFor[index(production.nonTerminal)].push_back((int)rules.size());
+                rules.push_back({production.nonTerminal, rhs, (int)slotRule.size()});
+                for (size_t dot = 0; dot <= rhs.size(); dot++) {
+                    slotRule.push_back((int)rules.size() - 1);
+                    slotDot.push_back((int)dot);
+                }
+            }
+        }
+    }
+
+    // Function to check whether the grammar derives text. Leo's items are
+    // used unless useLeoItems is false, which is only for comparison.
+    bool recognize(const string& text, EarleyStats* runStats = nullptr, bool useLeoItems = true) {
+        return run(text, false, useLeoItems, nullptr, runStats) >= 0;
+    }
+
+    // Function to parse text into a forest; returns the root, or -1 when
+    // the grammar does not derive text
+    int parse(const string& text, vector<ForestNode>& forest, EarleyStats* runStats = nullptr) {
+        forest.clear();
+        EarleyStats localStats;
+        if (!runStats) runStats = &localStats;
+        int root = run(text, true, false, &forest, runStats);
+        runStats->nodes = forest.size();
+        for (const ForestNode& node : forest) {
+            runStats->families += node.families.size();
+            runStats->ambiguousNodes += node.families.size() > 1;
+        }
+        return root;
+    }
+
+    // Function to name a forest node, e.g. (S, 0, 9) or (S -> iEt.SD, 0, 4)
+    string describe(const ForestNode& node) const {
+        string label;
+        if (node.label < 256) {
+            label = string(1, (char)node.label);
+        } else {
+            int slot = node.label - 256;
+            const Rule& rule = rules[slotRule[slot]];
+            label = string(1, rule.lhs) + " -> " + rule.rhs.substr(0, slotDot[slot]) + "." + rule.rhs.substr(slotDot[slot]);
+        }
+        return "(" + label + ", " + to_string(node.start) + ", " + to_string(node.end) + ")";
+    }
+};
+
+// Function to count the parse trees a forest packs, without unpacking it.
+// Saturates at infinity for cyclic grammars or counts beyond a double.
+inline double countTrees(const vector<ForestNode>& forest, int root) {
+    if (root < 0) return 0;
+    vector<double> count(forest.size(), -1);
+    vector<char> state(forest.size(), 0);   // 0 new, 1 on the stack, 2 done
+    vector<int> stack = {root};
+    auto value = [&](int node) { return node < 0 ? 1.0 : count[node]; };
+    while (!stack.empty()) {
+        int node = stack.back();
+        if (state[node] == 0) {
+            state[node] = 1;
+            for (const PackedFamily& family : forest[node].families) {
+                for (int child : {family.left, family.right}) {
+                    if (child < 0) continue;
+                    if (state[child] == 0) {
+                        stack.push_back(child);
+                    } else if (state[child] == 1) {
+                        count[child] = numeric_limits<double>::infinity();  // A cycle
+                    }
+                }
+            }
+            continue;
+        }
+        stack.pop_back();
+        if (state[node] == 2) continue;
+        state[node] = 2;
+        if (count[node] == numeric_limits<double>::infinity()) continue;
+        if (forest[node].families.empty()) {
+            count[node] = 1;  // A terminal
+            continue;
+        }
+        double total = 0;
+        for (const PackedFamily& family : forest[node].families) total += value(family.left) * value(family.right);
+        count[node] = total;
+    }
+    return count[root];
+}
+
+// Function to spell out up to limit of the trees under a node, as bracketed
+// strings like S[i E[b] t S[a] D[ε]]. Partial-rule nodes give the symbol
+// sequences they stand for. Only for small forests.
+inline vector<string> spellTrees(const vector<ForestNode>& forest, int node, size_t limit) {
+    const ForestNode& current = forest[node];
+    if (current.families.empty()) return {string(1, (char)current.label)};
+
+    vector<string> sequences;
+    for (const PackedFamily& family : current.families) {
+        vector<string> lefts = family.left < 0 ? vector<string>{""} : spellTrees(forest, family.left, limit);
+        vector<string> rights = family.right < 0 ? vector<string>{""} : spellTrees(forest, family.right, limit);
+        for (const string& left : lefts) {
+            for (const string& right : rights) {
+                if (sequences.size() >= limit) break;
+                sequences.push_back(left.empty() || right.empty() ? left + right : left + " " + right);
+            }
+        }
+    }
+    if (current.label >= 256) return sequences;
+    for (string& sequence : sequences) {
+        sequence = string(1, (char)current.label) + "[" + (sequence.empty() ? "ε" : sequence) + "]";
+    }
+    return sequences;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "earley.h"
+#include "../Practical-8/sentences.h"
+#include "../Practical-8/bench_timer.h"
+
+using namespace std;
+
+// The grammar of Practical_9.y, with Sdash written D
+vector<Production> danglingElse() {
+    return {{'S', {"iEtSD", "a"}}, {'D', {"eS", "ε"}}, {'E', {"b"}}};
+}
+
+// Function to time one forest parse and print a row of the table
+void benchParse(EarleyParser& parser, const string& name, const string& input) {
+    vector<ForestNode> forest;
+    EarleyStats stats;
+    int root = -1;
+    double ms = bestOfThree([&]() { root = parser.parse(input, forest, &stats); });
+    double trees = countTrees(forest, root);
+    cout << left << setw(14) << name << right << setw(7) << input.size() << setw(10) << fixed << setprecision(2) << ms
+         << setw(11) << stats.items << setw(10) << stats.nodes << setw(10) << stats.families << setw(10)
+         << stats.ambiguousNodes << setw(12) << scientific << setprecision(3) << trees << defaultfloat << endl;
+}
+
+// Usage: earley_bench [scale], where scale multiplies the input sizes
+int main(int argc, char** argv) {
+    int scale = argc > 1 ? max(1, atoi(argv[1])) : 1;
+    EarleyParser dangling(danglingElse(), 'S');
+
+    // The two readings bison has to choose between
+    string example = "ibtibtaea";
+    vector<ForestNode> forest;
+    int root = dangling.parse(example, forest);
+    cout << "Parses of " << example << ":" << endl;
+    for (const string& tree : spellTrees(forest, root, 8)) {
+        // With the else on the inner if, the outer if's D is empty
+        string innerElse = "D[ε]]";
+        bool nearest = tree.size() >= innerElse.size() &&
+                       tree.compare(tree.size() - innerElse.size(), innerElse.size(), innerElse) == 0;
+        cout << "  " << tree << (nearest ? "  (bison's choice: else binds to the nearest if)" : "") << endl;
+    }
+
+    // The recogniser with and without Leo's items and the forest parser
+    // must agree, on valid and mutated sentences alike
+    SentenceGenerator generator(danglingElse(), 'S', 45);
+    SentenceOptions options;
+    options.maxLength = 60;
+    options.mutationRate = 0.5;
+    size_t agreed = 0, accepted = 0, samples = 2000;
+    string sentence;
+    for (size_t s = 0; s < samples; s++) {
+        generator.next(sentence, options);
+        bool leo = dangling.recognize(sentence);
+        bool plain = dangling.recognize(sentence, nullptr, false);
+        bool parsed = dangling.parse(sentence, forest) >= 0;
+        agreed += leo == plain && plain == parsed;
+        accepted += parsed;
+    }
+    cout << "\nRecogniser, recogniser without Leo items and forest parser agree on " << agreed << " of " << samples
+         << " sentences (" << accepted << " accepted)" << endl;
+
+    cout << "\nForest Parsing:" << endl;
+    cout << left << setw(14) << "Input" << right << setw(7) << "Length" << setw(10) << "ms" << setw(11) << "Items"
+         << setw(10) << "Nodes" << setw(10) << "Families" << setw(10) << "Packed" << setw(12) << "Trees" << endl;
+    cout << string(84, '-') << endl;
+
+    // (ibt)^2k a (ea)^k: twice as many ifs as elses, so each else can
+    // attach to several ifs
+    for (int k : {4, 16, 64, 256}) {
+        string input;
+        for (int j = 0; j < 2 * k * scale; j++) input += "ibt";
+        input += "a";
+        for (int j = 0; j < k * scale; j++) input += "ea";
+        benchParse(dangling, "if-else", input);
+    }
+
+    // S -> SS | a: Catalan-many trees, the worst case for the forest
+    EarleyParser pairs({{'S', {"SS", "a"}}}, 'S');
+    for (int n : {16, 32, 64, 128}) benchParse(pairs, "S -> SS | a", string(n * scale, 'a'));
+
+    // An else-if chain, (ibtae)^n ibta, is right recursive through D -> eS:
+    // after every a the input so far is a sentence, so without Leo's items
+    // each such set completes the whole chain of open ifs again
+    cout << "\nRight Recursion (ibtae)^n ibta, recognition:" << endl;
+    cout << left << setw(10) << "Length" << right << setw(12) << "Leo ms" << setw(12) << "Leo items" << setw(12)
+         << "Shortcuts" << setw(12) << "Plain ms" << setw(14) << "Plain items" << endl;
+    cout << string(72, '-') << endl;
+    for (int n : {250, 1000, 4000, 64000}) {
+        string input;
+        for (int j = 0; j < n * scale; j++) input += "ibtae";
+        input += "ibta";
+        EarleyStats leoStats, plainStats;
+        bool leoOk = false, plainOk = true;
+        double leoMs = bestOfThree([&]() { leoOk = dangling.recognize(input, &leoStats); });
+        cout << left << setw(10) << input.size() << right << fixed << setprecision(2) << setw(12) << leoMs << setw(12)
+             << leoStats.items << setw(12) << leoStats.leoShortcuts;
+        // Quadratic: the largest input would take minutes
+        if (n <= 4000) {
+            double plainMs = bestOfThree([&]() { plainOk = dangling.recognize(input, &plainStats, false); });
+            cout << setw(12) << plainMs << setw(14) << plainStats.items;
+        } else {
+            cout << setw(12) << "-" << setw(14) << "-";
+        }
+        cout << defaultfloat << (leoOk && plainOk ? "" : "  (rejected)") << endl;
+    }
+    return 0;
+}
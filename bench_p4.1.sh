@@ -0,0 +1,43 @@
+#!/bin/sh
+# Benchmark p4.1_batch.c against the flex scanner in p4.1.l.
+# Usage: sh bench_p4.1.sh [bytes] [seed]
+set -e
+
+SIZE=${1:-1000000000}
+SEED=${2:-1}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+gcc -O2 -march=native p4.1_batch.c -o "$DIR/p4.1_batch"
+"$DIR/p4.1_batch" -g "$SIZE" -s "$SEED" > "$DIR/input.txt"
+
+# Function to time a command and print its throughput in GB/s
+measure() {
+    label=$1
+    shift
+    start=$(date +%s.%N)
+    "$@" < "$DIR/input.txt" > "$DIR/$label.out" 2> /dev/null
+    end=$(date +%s.%N)
+    echo "$label $start $end $SIZE" | awk '{ t = $3 - $2; printf "%-12s %8.3f s  %6.2f GB/s\n", $1, t, $4 / t / 1e9 }'
+}
+
+echo "Input: $SIZE bytes (seed $SEED)"
+measure batch-text "$DIR/p4.1_batch"
+measure batch-binary "$DIR/p4.1_batch" -b
+measure batch-count "$DIR/p4.1_batch" -c
+
+if command -v flex > /dev/null 2>&1; then
+    flex -o "$DIR/p4.1.yy.c" p4.1.l
+    gcc -O2 "$DIR/p4.1.yy.c" -o "$DIR/p4.1_flex"
+    measure flex "$DIR/p4.1_flex"
+
+    # flex echoes the newlines it does not match, so compare the numbers only
+    if grep -v '^$' "$DIR/flex.out" | cmp -s - "$DIR/batch-text.out"; then
+        echo "Outputs match"
+    else
+        echo "Outputs differ"
+        exit 1
+    fi
+else
+    echo "flex not found, skipping the flex scanner"
+fi
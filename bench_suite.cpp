@@ -0,0 +1,880 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include "Practical-8/grammar.h"
+#include "Practical-8/ll1.h"
+#include "Practical-8/lr_tables.h"
+#include "Practical-10/calc_engine.h"
+#include "Practical-11/quadruple.h"
+#include "Practical-11/optimizer.h"
+#include "Practical-11/bytecode.h"
+#include "Practical-11/jit.h"
+#include "Practical-11/incremental.h"
+#include "Practical-12/expression.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Benchmark suite for every lexer, parser and evaluator in the repository.
+// Library code (Practical-8, 10, 11, 12) and the functions of p1.c-p3.c,
+// which bench_suite.sh links in with their main renamed, run in-process.
+// Programs that only exist as a main (Practical-6, the batch scanners and the
+// flex/bison programs) run as child processes on generated input files.
+// Every component runs in its own child process, so its peak RSS is its own.
+// Inputs come from one seed, so two runs on the same seed see the same data.
+// In-process latencies are single calls timed with steady_clock, so they
+// include the few tens of nanoseconds it takes to read the clock; external
+// latencies are whole runs, including process start-up.
+
+extern "C" {
+bool isValidString(const char* str);                // p1.c
+extern int transition[10][10];                      // p2.c
+extern int numStates, numSymbols, initialState, numAcceptStates, acceptStates[10];
+extern char symbols[10];
+void processString(char* str);
+void tokenize(char* str);                           // p3.c
+extern int tokenCount;
+}
+
+// Structure to hold what one component measured
+struct Measurement {
+    string unit;                // What items counts
+    size_t items = 0;
+    size_t operations = 0;      // Calls (or runs) the latencies are taken over
+    size_t bytes = 0;
+    double seconds = 0;
+    vector<double> latencies;   // Nanoseconds per operation, sampled
+    string skipped;             // Reason, when the component could not run
+};
+
+// Structure to hold the run configuration
+struct Options {
+    unsigned seed = 1;
+    double scale = 1.0;         // 0.1 with -q
+    string binaries;            // Directory holding the external programs
+    string revision = "unknown";
+    string filter;
+    string output;
+};
+
+// Function to time every operation once for throughput, then a sample of
+// them one at a time for latency. op(i) returns the items it processed.
+template <class Op>
+void timeOperations(Measurement& m, size_t count, Op op) {
+    m.operations = count;
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < count; i++) m.items += op(i);
+    m.seconds = duration<double>(steady_clock::now() - start).count();
+
+    size_t stride = max<size_t>(1, count / 20000);
+    for (size_t i = 0; i < count; i += stride) {
+        auto begin = steady_clock::now();
+        op(i);
+        m.latencies.push_back(duration<double, nano>(steady_clock::now() - begin).count());
+    }
+}
+
+size_t scaled(const Options& options, size_t count) {
+    return max<size_t>(1, (size_t)(count * options.scale));
+}
+
+// ---------------------------------------------------------------------------
+// Input generators
+
+// Function to build a sentence of E -> E+T | T, T -> T*F | F, F -> (E) | n
+void appendSentence(string& out, mt19937_64& rng, size_t length, int depth) {
+    while (true) {
+        if (depth < 6 && rng() % 8 == 0) {
+            out += '(';
+            appendSentence(out, rng, out.size() + 2 + rng() % 20, depth + 1);
+            out += ')';
+        } else {
+            out += 'n';
+        }
+        if (out.size() >= length) return;
+        out += rng() % 2 ? '+' : '*';
+    }
+}
+
+// Function to replace one character so that most of the sentence is still valid
+void mutate(string& s, mt19937_64& rng, const string& alphabet) {
+    if (!s.empty()) s[rng() % s.size()] = alphabet[rng() % alphabet.size()];
+}
+
+// Function to build an arithmetic formula with numbers and variables
+void appendFormula(string& out, mt19937_64& rng, int& operators, int depth, int variables) {
+    const char* ops = "+-*/";
+    for (int i = 0; i == 0 || (operators > 0 && rng() % 4 != 0); i++) {
+        if (i > 0) {
+            out += ' ';
+            out += ops[rng() % 4];
+            out += ' ';
+            operators--;
+        }
+        unsigned r = rng() % 8;
+        if (r == 0 && depth < 10) {
+            out += '(';
+            appendFormula(out, rng, operators, depth + 1, variables);
+            out += ')';
+        } else if (r < 3 || variables == 0) {
+            out += to_string(1 + rng() % 99);
+            if (r == 1) out += "." + to_string(rng() % 100);
+        } else {
+            out += "v" + to_string(rng() % variables);
+        }
+    }
+}
+
+string formula(mt19937_64& rng, int operators, int variables) {
+    string out;
+    while (operators > 0) {
+        if (!out.empty()) {
+            out += " + ";
+            operators--;
+        }
+        appendFormula(out, rng, operators, 0, variables);
+    }
+    return out;
+}
+
+// Function to build a random grammar over A.. and a..h for FIRST/FOLLOW
+vector<Production> randomGrammar(mt19937_64& rng, int nonTerminals) {
+    vector<Production> grammar;
+    for (int n = 0; n < nonTerminals; n++) {
+        Production production = {(char)('A' + n), {}};
+        int alternatives = 1 + rng() % 3;
+        for (int a = 0; a < alternatives; a++) {
+            int length = rng() % 5;
+            string derivation;
+            for (int k = 0; k < length; k++) {
+                if (rng() % 10 < 4) derivation += (char)('A' + rng() % nonTerminals);
+                else derivation += (char)('a' + rng() % 8);
+            }
+            production.derivations.push_back(derivation.empty() ? "ε" : derivation);
+        }
+        grammar.push_back(production);
+    }
+    return grammar;
+}
+
+// Function to build C-like text; statements stay under p3.c's 100-character
+// and 100-token limits
+string cStatement(mt19937_64& rng) {
+    const char* types[] = {"int", "char", "long", "void", "struct"};
+    const char* names[] = {"count", "buffer", "i", "j", "total", "node", "next", "value", "length", "result"};
+    const char* ops = "+-*/<>=";
+    string s = string(types[rng() % 5]) + " " + names[rng() % 10] + " = ";
+    while (s.size() < 60 + rng() % 30) {
+        unsigned r = rng() % 4;
+        if (r == 0) s += to_string(rng() % 1000);
+        else if (r == 1) s += string("(") + names[rng() % 10] + ")";
+        else s += names[rng() % 10];
+        s += ' ';
+        s += ops[rng() % 7];
+        s += ' ';
+    }
+    return s + "0;";
+}
+
+// Functions to write the input files of the external programs; each returns
+// the number of items it wrote
+size_t writeDigitText(ostream& out, mt19937_64& rng, size_t bytes) {
+    size_t written = 0, numbers = 0;
+    while (written < bytes) {
+        string line;
+        while (line.size() < 70) {
+            if (rng() % 3 == 0) {
+                line += to_string(rng() % 1000000) + " ";
+                numbers++;
+            } else {
+                line += string("word") + (char)('a' + rng() % 26) + " ";
+            }
+        }
+        out << line << '\n';
+        written += line.size() + 1;
+    }
+    return numbers;
+}
+
+size_t writeProse(ostream& out, mt19937_64& rng, size_t bytes) {
+    const char* words[] = {"the", "charusat", "student", "compiler", "lexer", "parser", "of", "and", "table", "grammar"};
+    size_t written = 0, lines = 0;
+    while (written < bytes) {
+        string line;
+        while (line.size() < 70) line += string(words[rng() % 10]) + (rng() % 8 ? " " : ", ");
+        out << line << '\n';
+        written += line.size() + 1;
+        lines++;
+    }
+    return lines;
+}
+
+size_t writePasswords(ostream& out, mt19937_64& rng, size_t bytes) {
+    const string alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789*;#$@";
+    size_t written = 0, lines = 0;
+    while (written < bytes) {
+        string line;
+        size_t length = 6 + rng() % 13;
+        for (size_t i = 0; i < length; i++) line += alphabet[rng() % alphabet.size()];
+        out << line << '\n';
+        written += line.size() + 1;
+        lines++;
+    }
+    return lines;
+}
+
+size_t writeCSource(ostream& out, mt19937_64& rng, size_t bytes) {
+    size_t written = 0, lines = 0;
+    while (written < bytes) {
+        string line;
+        switch (rng() % 8) {
+            case 0: line = "#include <stdio.h>"; break;
+            case 1: line = "float ratio = " + to_string(rng() % 100) + "." + to_string(rng() % 100) + ";"; break;
+            case 2: line = "printf(\"value %d\\n\", value);"; break;
+            default: line = cStatement(rng); break;
+        }
+        out << line << '\n';
+        written += line.size() + 1;
+        lines++;
+    }
+    return lines;
+}
+
+size_t writeBracketLists(ostream& out, mt19937_64& rng, size_t count) {
+    // S -> (L) | a, L -> S | L,S; about one in ten strings is broken
+    vector<string> strings(count);
+    for (string& s : strings) {
+        function<void(int)> appendS = [&](int depth) {
+            if (depth < 4 && rng() % 3 == 0) {
+                s += '(';
+                appendS(depth + 1);
+                while (rng() % 2) {
+                    s += ',';
+                    appendS(depth + 1);
+                }
+                s += ')';
+            } else {
+                s += 'a';
+            }
+        };
+        appendS(0);
+        if (rng() % 10 == 0) mutate(s, rng, "(),a");
+    }
+    out << count << '\n';
+    for (const string& s : strings) out << s << '\n';
+    return count;
+}
+
+size_t writeDanglingElse(ostream& out, mt19937_64& rng, size_t depth) {
+    // S -> i E t S Sdash | a, Sdash -> e S | ε, E -> b
+    string s;
+    for (size_t i = 0; i < depth; i++) s += "ibt";
+    s += 'a';
+    for (size_t i = 0; i < depth; i++) {
+        if (rng() % 2) s += "ea";
+    }
+    out << s << '\n';
+    return 1;
+}
+
+size_t writeCalcLine(ostream& out, mt19937_64& rng, size_t operators) {
+    string s = "1";
+    for (size_t i = 0; i < operators; i++) s += string(rng() % 2 ? "+" : "-") + to_string(rng() % 100);
+    out << s << '\n';
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// In-process components
+
+Measurement benchP1(const Options& options, mt19937_64& rng) {
+    vector<string> inputs(scaled(options, 2000000));
+    for (string& s : inputs) {
+        s = string(rng() % 90, 'a') + "bb";
+        if (rng() % 4 == 0) mutate(s, rng, "abc");
+    }
+    Measurement m;
+    m.unit = "strings";
+    for (const string& s : inputs) m.bytes += s.size();
+    size_t valid = 0;
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        valid += isValidString(inputs[i].c_str());
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchP2(const Options& options, mt19937_64& rng) {
+    // Strings over {a, b} that end in "ab"
+    numSymbols = 2;
+    symbols[0] = 'a';
+    symbols[1] = 'b';
+    numStates = 3;
+    initialState = 0;
+    numAcceptStates = 1;
+    acceptStates[0] = 2;
+    int table[3][2] = {{1, 0}, {1, 2}, {1, 0}};
+    for (int s = 0; s < 3; s++) {
+        for (int c = 0; c < 2; c++) transition[s][c] = table[s][c];
+    }
+
+    vector<string> inputs(scaled(options, 1000000));
+    for (string& s : inputs) {
+        size_t length = 1 + rng() % 98;
+        for (size_t i = 0; i < length; i++) s += rng() % 2 ? 'a' : 'b';
+    }
+    Measurement m;
+    m.unit = "strings";
+    for (const string& s : inputs) m.bytes += s.size();
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        processString(&inputs[i][0]);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchP3(const Options& options, mt19937_64& rng) {
+    vector<string> inputs(scaled(options, 500000));
+    for (string& s : inputs) s = cStatement(rng);
+    Measurement m;
+    m.unit = "tokens";
+    for (const string& s : inputs) m.bytes += s.size();
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        tokenCount = 0;
+        tokenize(&inputs[i][0]);
+        return (size_t)tokenCount;
+    });
+    return m;
+}
+
+Measurement benchFirstFollow(const Options& options, mt19937_64& rng) {
+    vector<vector<Production>> grammars(scaled(options, 5000));
+    for (auto& grammar : grammars) grammar = randomGrammar(rng, 12);
+    Measurement m;
+    m.unit = "grammars";
+    timeOperations(m, grammars.size(), [&](size_t i) {
+        map<char, set<char>> first = computeFirstSets(grammars[i]);
+        map<char, set<char>> follow = computeFollowSets(grammars[i], first);
+        return (size_t)!follow.empty();
+    });
+    return m;
+}
+
+Measurement benchLL1(const Options& options, mt19937_64& rng) {
+    auto table = buildParsingTable(expressionGrammar());
+
+    vector<string> inputs(scaled(options, 30000));
+    for (string& s : inputs) {
+        appendSentence(s, rng, 20 + rng() % 180, 0);
+        if (rng() % 10 == 0) mutate(s, rng, "n+*()");
+    }
+    Measurement m;
+    m.unit = "sentences";
+    for (const string& s : inputs) m.bytes += s.size();
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        validateString(inputs[i], table, 'E', false);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchLALR(const Options& options, mt19937_64& rng) {
+    vector<Production> grammar = {{'E', {"E+T", "T"}}, {'T', {"T*F", "F"}}, {'F', {"(E)", "n"}}};
+    DenseLRTables tables = buildDenseTables(buildLALRTable(grammar));
+
+    vector<string> inputs(scaled(options, 200000));
+    for (string& s : inputs) {
+        appendSentence(s, rng, 20 + rng() % 180, 0);
+        if (rng() % 10 == 0) mutate(s, rng, "n+*()");
+    }
+    Measurement m;
+    m.unit = "sentences";
+    for (const string& s : inputs) m.bytes += s.size();
+    vector<int> stack;
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        parseLR(inputs[i], tables, stack);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchCalc(const Options& options, mt19937_64& rng) {
+    vector<string> inputs(scaled(options, 200000));
+    for (string& s : inputs) {
+        int operators = 4 + rng() % 40;
+        s = formula(rng, operators, 0);
+        replace(s.begin(), s.end(), '.', '+');  // The calculator reads integers only
+    }
+    Measurement m;
+    m.unit = "expressions";
+    for (const string& s : inputs) m.bytes += s.size();
+    CalcEngine engine;
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        engine.evaluate(inputs[i]);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchQuadruples(const Options& options, mt19937_64& rng) {
+    vector<string> inputs(scaled(options, 100000));
+    for (string& s : inputs) s = formula(rng, 4 + rng() % 60, 8);
+    Measurement m;
+    m.unit = "expressions";
+    for (const string& s : inputs) m.bytes += s.size();
+    QuadrupleGenerator generator;
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        generator.generate(inputs[i]);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchOptimizer(const Options& options, mt19937_64& rng) {
+    vector<QuadrupleProgram> programs(scaled(options, 50000));
+    QuadrupleGenerator generator;
+    Measurement m;
+    m.unit = "programs";
+    for (auto& program : programs) {
+        string text = formula(rng, 8 + rng() % 60, 4);
+        generator.generate(text);
+        program = generator.program();
+        m.bytes += text.size();
+    }
+    PassManager pipeline = defaultPipeline();
+    QuadrupleProgram work;
+    timeOperations(m, programs.size(), [&](size_t i) {
+        work = programs[i];
+        pipeline.run(work);
+        return (size_t)1;
+    });
+    return m;
+}
+
+// Shared setup for the row-at-a-time evaluators: a 200-operator formula and
+// one input row per operation, by variableTable index
+struct RowWorkload {
+    QuadrupleProgram program;
+    vector<double> rows;
+    size_t numVariables = 0;
+    size_t count = 0;
+};
+
+RowWorkload rowWorkload(const Options& options, mt19937_64& rng) {
+    RowWorkload w;
+    QuadrupleGenerator generator;
+    generator.generate(formula(rng, 200, 12));
+    w.program = generator.program();
+    defaultPipeline().run(w.program);
+    w.numVariables = w.program.variableTable.size();
+    w.count = scaled(options, 2000000);
+    uniform_real_distribution<double> dist(1.0, 100.0);
+    w.rows.resize(w.count * w.numVariables);
+    for (double& value : w.rows) value = dist(rng);
+    return w;
+}
+
+Measurement benchBytecode(const Options& options, mt19937_64& rng) {
+    RowWorkload w = rowWorkload(options, rng);
+    TempAllocation allocation = allocateTemps(w.program, 16);
+    Bytecode bytecode;
+    compileQuadruples(w.program, bytecode, &allocation);
+    // Bytecode numbers its variables by first use
+    vector<size_t> column;
+    for (const string& name : bytecode.variables) column.push_back(w.program.variableTable.find(name));
+    vector<double> rows(w.count * column.size());
+    for (size_t i = 0; i < w.count; i++) {
+        for (size_t v = 0; v < column.size(); v++) rows[i * column.size() + v] = w.rows[i * w.numVariables + column[v]];
+    }
+
+    Measurement m;
+    m.unit = "rows";
+    BytecodeEvaluator evaluator(bytecode);
+    double checksum = 0;
+    timeOperations(m, w.count, [&](size_t i) {
+        checksum += evaluator.run(&rows[i * column.size()]);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchNative(const Options& options, mt19937_64& rng) {
+    RowWorkload w = rowWorkload(options, rng);
+    Measurement m;
+    m.unit = "rows";
+    JitFunction native;
+    if (!compileNative(w.program, native)) {
+        m.skipped = "native code generation is not available on this platform";
+        return m;
+    }
+    NativeFormula f = native.function();
+    double checksum = 0;
+    timeOperations(m, w.count, [&](size_t i) {
+        checksum += f(&w.rows[i * w.numVariables]);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchIncremental(const Options& options, mt19937_64& rng) {
+    QuadrupleGenerator generator;
+    generator.generate(formula(rng, 20000, 500));
+    QuadrupleProgram program = generator.program();
+    IncrementalEvaluator evaluator(program);
+    size_t numVariables = program.variableTable.size();
+    vector<pair<uint32_t, double>> updates(scaled(options, 20000));
+    for (auto& [variable, value] : updates) {
+        variable = (uint32_t)(rng() % numVariables);
+        value = 1.0 + (double)(rng() % 1000) / 100;
+    }
+    Measurement m;
+    m.unit = "updates";
+    timeOperations(m, updates.size(), [&](size_t i) {
+        evaluator.update(updates[i].first, updates[i].second);
+        return (size_t)1;
+    });
+    return m;
+}
+
+Measurement benchFold(const Options& options, mt19937_64& rng) {
+    vector<string> inputs(scaled(options, 100000));
+    for (string& s : inputs) s = formula(rng, 4 + rng() % 60, 8);
+    Measurement m;
+    m.unit = "expressions";
+    for (const string& s : inputs) m.bytes += s.size();
+    ExpressionArena arena;
+    timeOperations(m, inputs.size(), [&](size_t i) {
+        arena.clear();
+        ExpressionParser parser(arena);
+        ParseResult parsed = parser.parse(inputs[i]);
+        if (!parsed.ok) return (size_t)0;
+        ConstantFolder folder(arena);
+        return (size_t)!nodeToString(arena, folder.fold(parsed.root)).empty();
+    });
+    return m;
+}
+
+Measurement benchDag(const Options& options, mt19937_64& rng) {
+    // A formula that repeats a small pool of subexpressions
+    vector<string> pool;
+    for (int i = 0; i < 24; i++) pool.push_back("(" + formula(rng, 6, 8) + ")");
+    string text;
+    for (int i = 0; i < 2000; i++) text += (i ? " + " : "") + pool[rng() % pool.size()] + " * " + pool[rng() % pool.size()];
+    ExpressionArena arena(true);
+    ExpressionParser parser(arena);
+    ParseResult parsed = parser.parse(text);
+
+    size_t count = scaled(options, 100000);
+    vector<vector<double>> inputs(count, vector<double>(arena.names.size()));
+    uniform_real_distribution<double> dist(1.0, 10.0);
+    for (auto& input : inputs) {
+        for (double& value : input) value = dist(rng);
+    }
+    Measurement m;
+    m.unit = "evaluations";
+    vector<double> values;
+    timeOperations(m, count, [&](size_t i) {
+        evaluateArena(arena, inputs[i], values);
+        return (size_t)parsed.ok;
+    });
+    return m;
+}
+
+// ---------------------------------------------------------------------------
+// External programs
+
+// Structure to describe a program run on a generated input file
+struct External {
+    string binary;                  // Name inside the binaries directory
+    vector<string> arguments;       // "{input}" is replaced by the input path
+    bool inputOnStdin;
+    string unit;
+    function<size_t(ostream&, mt19937_64&, const Options&)> write;
+};
+
+// Function to run a program once; returns wall seconds, or -1 on failure
+double runOnce(const string& path, const vector<string>& arguments, const string& input, bool inputOnStdin,
+               long& peakKb) {
+    auto start = steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        int in = open(inputOnStdin ? input.c_str() : "/dev/null", O_RDONLY);
+        int out = open("/dev/null", O_WRONLY);
+        if (in < 0 || out < 0) _exit(127);
+        dup2(in, 0);
+        dup2(out, 1);
+        dup2(out, 2);
+        vector<char*> argv = {(char*)path.c_str()};
+        for (const string& a : arguments) argv.push_back((char*)a.c_str());
+        argv.push_back(nullptr);
+        execv(path.c_str(), argv.data());
+        _exit(127);
+    }
+    if (pid < 0) return -1;
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) return -1;
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    peakKb = max(peakKb, usage.ru_maxrss);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? seconds : -1;
+}
+
+Measurement benchExternal(const External& e, const Options& options, mt19937_64& rng, long& peakKb) {
+    Measurement m;
+    m.unit = e.unit;
+    string path = options.binaries + "/" + e.binary;
+    if (options.binaries.empty() || access(path.c_str(), X_OK) != 0) {
+        m.skipped = e.binary + " was not built";
+        return m;
+    }
+
+    char pattern[] = "/tmp/bench_suite_XXXXXX";
+    int fd = mkstemp(pattern);
+    if (fd < 0) {
+        m.skipped = "cannot create an input file";
+        return m;
+    }
+    close(fd);
+    string input = pattern;
+    {
+        ofstream out(input, ios::binary);
+        m.items = e.write(out, rng, options);
+    }
+    struct stat st;
+    stat(input.c_str(), &st);
+    m.bytes = (size_t)st.st_size;
+
+    vector<string> arguments = e.arguments;
+    for (string& a : arguments) {
+        if (a == "{input}") a = input;
+    }
+    int runs = options.scale < 1 ? 3 : 5;
+    for (int run = 0; run < runs; run++) {
+        double seconds = runOnce(path, arguments, input, e.inputOnStdin, peakKb);
+        if (seconds < 0) {
+            m.skipped = e.binary + " failed";
+            break;
+        }
+        m.latencies.push_back(seconds * 1e9);
+    }
+    unlink(input.c_str());
+
+    // Throughput from the median run; items and bytes are per run
+    if (!m.latencies.empty()) {
+        vector<double> sorted = m.latencies;
+        sort(sorted.begin(), sorted.end());
+        m.seconds = sorted[sorted.size() / 2] / 1e9;
+        m.operations = m.latencies.size();
+    }
+    return m;
+}
+
+// ---------------------------------------------------------------------------
+// Reporting
+
+double percentile(vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    return sorted[min(sorted.size() - 1, (size_t)(q * (sorted.size() - 1) + 0.5))];
+}
+
+string jsonString(const string& s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if ((unsigned char)c >= 0x20) out += c;
+    }
+    return out + "\"";
+}
+
+// Function to render a measurement as the fields of a JSON object
+string measurementJson(const string& name, Measurement& m, long peakKb) {
+    ostringstream json;
+    json << "{\"name\": " << jsonString(name);
+    if (!m.skipped.empty()) {
+        json << ", \"status\": \"skipped\", \"reason\": " << jsonString(m.skipped) << "}";
+        return json.str();
+    }
+    sort(m.latencies.begin(), m.latencies.end());
+    double seconds = max(m.seconds, 1e-9);
+    json << ", \"status\": \"ok\", \"unit\": " << jsonString(m.unit) << ", \"items\": " << m.items
+         << ", \"operations\": " << m.operations << ", \"bytes\": " << m.bytes << setprecision(6)
+         << ", \"seconds\": " << m.seconds << ", \"items_per_sec\": " << m.items / seconds
+         << ", \"bytes_per_sec\": " << m.bytes / seconds << ", \"latency_ns\": {\"p50\": "
+         << percentile(m.latencies, 0.5) << ", \"p90\": " << percentile(m.latencies, 0.9)
+         << ", \"p99\": " << percentile(m.latencies, 0.99) << ", \"max\": "
+         << (m.latencies.empty() ? 0 : m.latencies.back()) << "}, \"peak_rss_kb\": " << peakKb << "}";
+    return json.str();
+}
+
+// Function to print one line of the human-readable table to stderr
+void printRow(const string& name, const Measurement& m, long peakKb) {
+    cerr << left << setw(28) << name << right;
+    if (!m.skipped.empty()) {
+        cerr << "  skipped: " << m.skipped << endl;
+        return;
+    }
+    vector<double> sorted = m.latencies;
+    sort(sorted.begin(), sorted.end());
+    double seconds = max(m.seconds, 1e-9);
+    cerr << setw(12) << fixed << setprecision(2) << m.items / seconds / 1e6 << " M" << left << setw(12) << m.unit
+         << right;
+    // Components that work on grammars or trees rather than text have no byte rate
+    if (m.bytes) cerr << setw(10) << m.bytes / seconds / 1e6;
+    else cerr << setw(10) << "-";
+    cerr << setw(12) << setprecision(0) << percentile(sorted, 0.5) << setw(12) << percentile(sorted, 0.99) << setw(10)
+         << peakKb / 1024 << endl;
+}
+
+// Function to run one component in a child process and collect its JSON.
+// The child sends the measurement back over a pipe; wait4 gives its peak RSS.
+string runComponent(const string& name, function<Measurement(long&)> body) {
+    int fds[2];
+    if (pipe(fds) != 0) return "";
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        if (!freopen("/dev/null", "w", stdout)) _exit(1);  // p2.c prints a verdict per string
+        long externalKb = 0;
+        Measurement m = body(externalKb);
+        // In-process work: the child's own peak. External work: the program's.
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        long peakKb = externalKb ? externalKb : usage.ru_maxrss;
+        printRow(name, m, peakKb);
+        string json = measurementJson(name, m, peakKb);
+        if (write(fds[1], json.data(), json.size()) != (ssize_t)json.size()) _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+    string json;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) json.append(buffer, n);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (json.empty() || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        cerr << left << setw(28) << name << "  failed" << endl;
+        json = "{\"name\": " + jsonString(name) + ", \"status\": \"failed\"}";
+    }
+    return json;
+}
+
+// Usage: bench_suite [-q] [-s seed] [-b binaries] [-r revision] [-f filter] [-o output.json]
+int main(int argc, char** argv) {
+    Options options;
+    int opt;
+    while ((opt = getopt(argc, argv, "qs:b:r:f:o:")) != -1) {
+        switch (opt) {
+            case 'q': options.scale = 0.1; break;
+            case 's': options.seed = (unsigned)atoi(optarg); break;
+            case 'b': options.binaries = optarg; break;
+            case 'r': options.revision = optarg; break;
+            case 'f': options.filter = optarg; break;
+            case 'o': options.output = optarg; break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-q] [-s seed] [-b binaries] [-r revision] [-f filter] [-o output.json]"
+                     << endl;
+                return 1;
+        }
+    }
+
+    typedef Measurement (*InProcess)(const Options&, mt19937_64&);
+    vector<pair<string, InProcess>> inProcess = {
+        {"p1.isValidString", benchP1},
+        {"p2.processString", benchP2},
+        {"p3.tokenize", benchP3},
+        {"practical-8.first_follow", benchFirstFollow},
+        {"practical-8.ll1", benchLL1},
+        {"practical-8.lalr", benchLALR},
+        {"practical-10.calc_engine", benchCalc},
+        {"practical-11.quadruples", benchQuadruples},
+        {"practical-11.optimizer", benchOptimizer},
+        {"practical-11.bytecode", benchBytecode},
+        {"practical-11.native", benchNative},
+        {"practical-11.incremental", benchIncremental},
+        {"practical-12.fold", benchFold},
+        {"practical-12.dag", benchDag},
+    };
+
+    auto bytesOf = [](size_t full) {
+        return [full](ostream& out, mt19937_64& rng, const Options& o, auto writer) {
+            return writer(out, rng, max<size_t>(4096, (size_t)(full * o.scale)));
+        };
+    };
+    const size_t large = 64u << 20, medium = 16u << 20;
+    vector<pair<string, External>> externals = {
+        {"practical-6.rdp", {"practical-6", {}, true, "strings",
+            [](ostream& out, mt19937_64& rng, const Options& o) { return writeBracketLists(out, rng, scaled(o, 200000)); }}},
+        {"p4.1_batch", {"p4.1_batch", {"-c"}, true, "numbers",
+            [&](ostream& out, mt19937_64& rng, const Options& o) { return bytesOf(large)(out, rng, o, writeDigitText); }}},
+        {"p4.4_batch", {"p4.4_batch", {"-c", "{input}"}, false, "lines",
+            [&](ostream& out, mt19937_64& rng, const Options& o) { return bytesOf(large)(out, rng, o, writePasswords); }}},
+        {"p4.1.flex", {"p4.1", {}, true, "numbers",
+            [&](ostream& out, mt19937_64& rng, const Options& o) { return bytesOf(medium)(out, rng, o, writeDigitText); }}},
+        {"p4.2.flex", {"p4.2", {}, true, "lines",
+            [&](ostream& out, mt19937_64& rng, const Options& o) { return bytesOf(medium)(out, rng, o, writeProse); }}},
+        {"p4.3.flex", {"p4.3", {}, true, "lines",
+            [&](ostream& out, mt19937_64& rng, const Options& o) { return bytesOf(medium)(out, rng, o, writeProse); }}},
+        {"p4.4.flex", {"p4.4", {}, true, "lines",
+            [&](ostream& out, mt19937_64& rng, const Options& o) { return bytesOf(medium)(out, rng, o, writePasswords); }}},
+        {"p5.flex", {"p5", {"{input}"}, false, "lines",
+            [&](ostream& out, mt19937_64& rng, const Options& o) { return bytesOf(medium)(out, rng, o, writeCSource); }}},
+        {"practical-9.bison", {"practical-9", {}, true, "sentences",
+            [](ostream& out, mt19937_64& rng, const Options& o) { return writeDanglingElse(out, rng, scaled(o, 2000)); }}},
+        {"practical-10.bison", {"practical-10", {}, true, "expressions",
+            [](ostream& out, mt19937_64& rng, const Options& o) { return writeCalcLine(out, rng, scaled(o, 200000)); }}},
+    };
+
+    cerr << "Seed " << options.seed << (options.scale < 1 ? ", quick run" : "") << endl;
+    cerr << left << setw(28) << "Component" << right << setw(26) << "Throughput" << setw(10) << "MB/s"
+         << setw(12) << "p50 ns" << setw(12) << "p99 ns" << setw(10) << "RSS MB" << endl;
+
+    vector<string> results;
+    unsigned index = 0;
+    for (const auto& [name, bench] : inProcess) {
+        unsigned seed = options.seed * 1000 + index++;
+        if (name.find(options.filter) == string::npos) continue;
+        results.push_back(runComponent(name, [&, bench = bench, seed](long&) {
+            mt19937_64 rng(seed);
+            return bench(options, rng);
+        }));
+    }
+    for (const auto& [name, external] : externals) {
+        unsigned seed = options.seed * 1000 + index++;
+        if (name.find(options.filter) == string::npos) continue;
+        results.push_back(runComponent(name, [&, seed](long& peakKb) {
+            mt19937_64 rng(seed);
+            return benchExternal(external, options, rng, peakKb);
+        }));
+    }
+
+    ostringstream json;
+    json << "{\"suite\": \"compiler-practicals\", \"revision\": " << jsonString(options.revision)
+         << ", \"seed\": " << options.seed << ", \"scale\": " << options.scale << ", \"components\": [\n";
+    for (size_t i = 0; i < results.size(); i++) json << "  " << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+    json << "]}\n";
+
+    if (options.output.empty()) {
+        cout << json.str();
+    } else {
+        ofstream out(options.output);
+        out << json.str();
+        cerr << "Wrote " << options.output << endl;
+    }
+    return 0;
+}
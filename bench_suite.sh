@@ -0,0 +1,45 @@
+#!/bin/sh
+# Build and run the benchmark suite over every lexer, parser and evaluator.
+# Results go to stdout (or -o file) as JSON, one component per line, so runs
+# on two commits can be compared with diff or jq; a table goes to stderr.
+# Usage: sh bench_suite.sh [-q] [-s seed] [-f filter] [-o results.json]
+set -e
+
+cd "$(dirname "$0")"
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+CFLAGS="-O2 -march=native"
+
+# p1.c-p3.c are linked into the suite with their main renamed
+gcc $CFLAGS -Dmain=p1_main -c p1.c -o "$DIR/p1.o"
+gcc $CFLAGS -Dmain=p2_main -c p2.c -o "$DIR/p2.o"
+gcc $CFLAGS -Dmain=p3_main -c p3.c -o "$DIR/p3.o"
+
+# Programs the suite runs on generated input files
+g++ $CFLAGS Practical-6/Practical_6.cpp -o "$DIR/practical-6"
+gcc $CFLAGS p4.1_batch.c -o "$DIR/p4.1_batch"
+gcc $CFLAGS p4.4_batch.c -o "$DIR/p4.4_batch"
+
+if command -v flex > /dev/null 2>&1; then
+    for scanner in p4.1 p4.2 p4.3 p4.4 p5; do
+        flex -o "$DIR/$scanner.yy.c" "$scanner.l"
+        gcc $CFLAGS -w -I. "$DIR/$scanner.yy.c" -o "$DIR/$scanner"
+    done
+    if command -v bison > /dev/null 2>&1; then
+        # The scanners include the header names the original builds used
+        bison -d -o "$DIR/firstyacc.tab.c" Practical-9/Practical_9.y
+        flex -o "$DIR/practical-9.yy.c" Practical-9/Practical_9.l
+        gcc $CFLAGS -w -I"$DIR" "$DIR/firstyacc.tab.c" "$DIR/practical-9.yy.c" -o "$DIR/practical-9" || true
+        bison -d -o "$DIR/prac10.tab.c" Practical-10/practical-10.y
+        flex -o "$DIR/practical-10.yy.c" Practical-10/Practical-10.l
+        gcc $CFLAGS -w -I"$DIR" "$DIR/prac10.tab.c" "$DIR/practical-10.yy.c" -lm -o "$DIR/practical-10" || true
+    fi
+else
+    echo "flex not found, the flex and bison programs will be skipped" >&2
+fi
+
+g++ -std=c++17 $CFLAGS -pthread bench_suite.cpp "$DIR/p1.o" "$DIR/p2.o" "$DIR/p3.o" -o "$DIR/bench_suite"
+
+REVISION=$(git rev-parse --short HEAD 2> /dev/null || echo unknown)
+"$DIR/bench_suite" -b "$DIR" -r "$REVISION" "$@"
@@ -0,0 +1,163 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// String interning for the lexers' identifiers. Each distinct name is
+// stored once, NUL-terminated, in a bump arena of large blocks, and gets a
+// 32-bit ID in order of first appearance; the ID never changes, so tokens
+// can carry it and compare names as integers. The lookup table is open
+// addressing with linear probing, and keeps each slot's hash next to the ID
+// so that a probe compares bytes only when the hashes match, and growing
+// the table never rehashes a name.
+
+#define INTERN_NO_ID 0xFFFFFFFFu
+#define INTERN_BLOCK_SIZE (64 * 1024)
+
+typedef struct InternBlock {
+    struct InternBlock *next;
+    size_t size;
+} InternBlock;
+
+typedef struct {
+    uint32_t *slotIds;          // ID + 1, 0 for an empty slot
+    uint32_t *slotHashes;
+    uint32_t capacity;          // Slots, a power of two
+    uint32_t count;             // Distinct names
+
+    const char **names;         // By ID, pointing into the arena
+    uint32_t *lengths;
+    uint32_t *hashes;
+    uint32_t nameCapacity;
+
+    InternBlock *blocks;
+    char *cursor;               // Free space in the newest block
+    size_t remaining;
+    size_t arenaBytes;          // Allocated for blocks
+} InternTable;
+
+static inline void internInit(InternTable *table) {
+    memset(table, 0, sizeof(*table));
+}
+
+static inline void internFree(InternTable *table) {
+    while (table->blocks) {
+        InternBlock *next = table->blocks->next;
+        free(table->blocks);
+        table->blocks = next;
+    }
+    free(table->slotIds);
+    free(table->slotHashes);
+    free((void *)table->names);
+    free(table->lengths);
+    free(table->hashes);
+    internInit(table);
+}
+
+// FNV-1a over the name's bytes
+static inline uint32_t internHash(const char *text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    return hash;
+}
+
+// Function to copy a name into the arena, starting a new block when the
+// current one is full; names longer than a block get a block of their own
+static inline const char *internStore(InternTable *table, const char *text, size_t length) {
+    if (length + 1 > table->remaining) {
+        size_t size = length + 1 > INTERN_BLOCK_SIZE ? length + 1 : INTERN_BLOCK_SIZE;
+        InternBlock *block = (InternBlock *)malloc(sizeof(InternBlock) + size);
+        if (!block) return NULL;
+        block->next = table->blocks;
+        block->size = size;
+        table->blocks = block;
+        table->cursor = (char *)(block + 1);
+        table->remaining = size;
+        table->arenaBytes += sizeof(InternBlock) + size;
+    }
+    char *name = table->cursor;
+    memcpy(name, text, length);
+    name[length] = '\0';
+    table->cursor += length + 1;
+    table->remaining -= length + 1;
+    return name;
+}
+
+// Function to double the slot array, placing each ID by its kept hash
+static inline int internGrow(InternTable *table) {
+    uint32_t capacity = table->capacity ? table->capacity * 2 : 1024;
+    uint32_t *slotIds = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+    uint32_t *slotHashes = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    if (!slotIds || !slotHashes) {
+        free(slotIds);
+        free(slotHashes);
+        return 0;
+    }
+    for (uint32_t id = 0; id < table->count; id++) {
+        uint32_t slot = table->hashes[id] & (capacity - 1);
+        while (slotIds[slot]) slot = (slot + 1) & (capacity - 1);
+        slotIds[slot] = id + 1;
+        slotHashes[slot] = table->hashes[id];
+    }
+    free(table->slotIds);
+    free(table->slotHashes);
+    table->slotIds = slotIds;
+    table->slotHashes = slotHashes;
+    table->capacity = capacity;
+    return 1;
+}
+
+// Function to return the ID of a name, interning it on first sight;
+// INTERN_NO_ID if memory ran out
+static inline uint32_t internLookup(InternTable *table, const char *text, size_t length) {
+    // Keep the load under a half so probe runs stay short
+    if ((table->count + 1) * 2 > table->capacity && !internGrow(table)) return INTERN_NO_ID;
+
+    uint32_t hash = internHash(text, length);
+    uint32_t mask = table->capacity - 1;
+    uint32_t slot = hash & mask;
+    while (table->slotIds[slot]) {
+        uint32_t id = table->slotIds[slot] - 1;
+        if (table->slotHashes[slot] == hash && table->lengths[id] == length &&
+            memcmp(table->names[id], text, length) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    if (table->count == table->nameCapacity) {
+        uint32_t nameCapacity = table->nameCapacity ? table->nameCapacity * 2 : 1024;
+        const char **names = (const char **)realloc((void *)table->names, nameCapacity * sizeof(char *));
+        if (names) table->names = names;
+        uint32_t *lengths = (uint32_t *)realloc(table->lengths, nameCapacity * sizeof(uint32_t));
+        if (lengths) table->lengths = lengths;
+        uint32_t *hashes = (uint32_t *)realloc(table->hashes, nameCapacity * sizeof(uint32_t));
+        if (hashes) table->hashes = hashes;
+        if (!names || !lengths || !hashes) return INTERN_NO_ID;
+        table->nameCapacity = nameCapacity;
+    }
+    const char *name = internStore(table, text, length);
+    if (!name) return INTERN_NO_ID;
+
+    uint32_t id = table->count++;
+    table->names[id] = name;
+    table->lengths[id] = (uint32_t)length;
+    table->hashes[id] = hash;
+    table->slotIds[slot] = id + 1;
+    table->slotHashes[slot] = hash;
+    return id;
+}
+
+static inline const char *internName(const InternTable *table, uint32_t id) {
+    return id < table->count ? table->names[id] : NULL;
+}
+
+// Bytes the table holds: arena blocks, slots and the per-ID arrays
+static inline size_t internMemory(const InternTable *table) {
+    return table->arenaBytes + (size_t)table->capacity * 2 * sizeof(uint32_t) +
+           (size_t)table->nameCapacity * (sizeof(char *) + 2 * sizeof(uint32_t));
+}
+
+#endif // INTERN_H
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <malloc.h>
+#include "intern.h"
+
+// Benchmark for intern.h on generated C source: how fast identifiers are
+// interned, what equality costs as an ID compare against strcmp, and how
+// much memory the table saves over a copy of every lexeme. Tokens come from
+// p3.c's scanner. Build with:
+//   gcc -O2 -Dmain=p3_main -c p3.c -o p3.o
+//   gcc -O2 intern_bench.c p3.o -o intern_bench
+// Usage: intern_bench [megabytes] [seed]
+
+int scanToken(const char **cursor, const char **start, int *length);    // p3.c
+
+#define IDENTIFIER 1
+#define VOCABULARY 20000
+
+// Structure to hold an identifier's place in the source
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+} Span;
+
+static uint64_t rngState;
+
+static uint64_t nextRandom(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+// Function to pick a name index with a skewed distribution: a few names
+// (loop counters, common fields) are everywhere, most are rare
+static int pickName(void) {
+    double u = (double)(nextRandom() >> 11) / (double)(1ull << 53);
+    return (int)(VOCABULARY * u * u * u);
+}
+
+static double secondsSince(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Function to generate C-like source of at least 'bytes' bytes
+static char *generateSource(size_t bytes, size_t *size) {
+    const char *stems[] = {"count", "buffer", "node", "next", "value", "length", "result", "index",
+                           "total", "handler", "state", "entry", "table", "cursor", "limit", "offset"};
+    const char *ops = "+-*/<>";
+    static char names[VOCABULARY][32];
+    for (int i = 0; i < VOCABULARY; i++) {
+        if (i < 16) snprintf(names[i], sizeof(names[i]), "%s", stems[i]);
+        else snprintf(names[i], sizeof(names[i]), "%s_%s_%d", stems[i % 16], stems[(i / 16) % 16], i);
+    }
+
+    char *text = (char *)malloc(bytes + 4096);
+    size_t used = 0;
+    while (used < bytes) {
+        char line[512];
+        int n = 0;
+        switch (nextRandom() % 4) {
+            case 0:
+                n = snprintf(line, sizeof(line), "int %s = %s(%s, %d);\n", names[pickName()], names[pickName()],
+                             names[pickName()], (int)(nextRandom() % 1000));
+                break;
+            case 1:
+                n = snprintf(line, sizeof(line), "    %s = %s %c %s %c %s;\n", names[pickName()], names[pickName()],
+                             ops[nextRandom() % 6], names[pickName()], ops[nextRandom() % 6], names[pickName()]);
+                break;
+            case 2:
+                n = snprintf(line, sizeof(line), "    if (%s < %s) return %s;\n", names[pickName()],
+                             names[pickName()], names[pickName()]);
+                break;
+            default:
+                n = snprintf(line, sizeof(line), "    %s(%s, %s + %d);\n", names[pickName()], names[pickName()],
+                             names[pickName()], (int)(nextRandom() % 100));
+                break;
+        }
+        memcpy(text + used, line, n);
+        used += n;
+    }
+    text[used] = '\0';
+    *size = used;
+    return text;
+}
+
+int main(int argc, char **argv) {
+    size_t megabytes = argc > 1 ? strtoull(argv[1], NULL, 10) : 64;
+    rngState = argc > 2 ? strtoull(argv[2], NULL, 10) : 50;
+    if (!rngState) rngState = 50;
+
+    size_t size;
+    char *text = generateSource(megabytes << 20, &size);
+    struct timespec start;
+
+    // Lexing alone, keeping where each identifier is
+    size_t spanCapacity = 1 << 20, spanCount = 0, tokenTotal = 0, lexemeBytes = 0;
+    Span *spans = (Span *)malloc(spanCapacity * sizeof(Span));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const char *cursor = text, *lexeme;
+    int length, type;
+    while ((type = scanToken(&cursor, &lexeme, &length)) >= 0) {
+        tokenTotal++;
+        if (type != IDENTIFIER) continue;
+        if (spanCount == spanCapacity) {
+            spanCapacity *= 2;
+            spans = (Span *)realloc(spans, spanCapacity * sizeof(Span));
+        }
+        spans[spanCount].offset = (uint32_t)(lexeme - text);
+        spans[spanCount].length = (uint32_t)length;
+        spanCount++;
+        lexemeBytes += length;
+    }
+    double lexSeconds = secondsSince(&start);
+
+    // Interning every identifier: the first pass inserts each new name, the
+    // second finds every one
+    InternTable table;
+    internInit(&table);
+    uint32_t *ids = (uint32_t *)malloc(spanCount * sizeof(uint32_t));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < spanCount; i++) ids[i] = internLookup(&table, text + spans[i].offset, spans[i].length);
+    double firstSeconds = secondsSince(&start);
+    size_t unstable = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < spanCount; i++) {
+        unstable += internLookup(&table, text + spans[i].offset, spans[i].length) != ids[i];
+    }
+    double warmSeconds = secondsSince(&start);
+
+    // The names must read back exactly, whatever growth happened in between
+    size_t wrong = unstable;
+    for (size_t i = 0; i < spanCount; i++) {
+        const char *name = internName(&table, ids[i]);
+        wrong += !name || strlen(name) != spans[i].length || memcmp(name, text + spans[i].offset, spans[i].length) != 0;
+    }
+
+    // What a lexer without the table would do: a heap copy of every lexeme
+    char **copies = (char **)malloc(spanCount * sizeof(char *));
+    size_t copyBytes = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < spanCount; i++) {
+        copies[i] = (char *)malloc(spans[i].length + 1);
+        memcpy(copies[i], text + spans[i].offset, spans[i].length);
+        copies[i][spans[i].length] = '\0';
+    }
+    double copySeconds = secondsSince(&start);
+    for (size_t i = 0; i < spanCount; i++) copyBytes += malloc_usable_size(copies[i]) + sizeof(size_t);
+    copyBytes += spanCount * sizeof(char *);
+
+    // Equality: each identifier against the one eight before it
+    size_t equalStrings = 0, equalIds = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 8; i < spanCount; i++) equalStrings += strcmp(copies[i], copies[i - 8]) == 0;
+    double strcmpSeconds = secondsSince(&start);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 8; i < spanCount; i++) equalIds += ids[i] == ids[i - 8];
+    double idSeconds = secondsSince(&start);
+
+    size_t internBytes = internMemory(&table) + spanCount * sizeof(uint32_t);
+    double lookups = (double)spanCount;
+    printf("%zu bytes, %zu tokens, %zu identifiers (%zu bytes), %u distinct\n", size, tokenTotal, spanCount,
+           lexemeBytes, table.count);
+    printf("Lexing:              %8.1f ms\n", lexSeconds * 1e3);
+    printf("Interning, first:    %8.1f ms  %7.1f M lookups/s\n", firstSeconds * 1e3, lookups / firstSeconds / 1e6);
+    printf("Interning, repeated: %8.1f ms  %7.1f M lookups/s\n", warmSeconds * 1e3, lookups / warmSeconds / 1e6);
+    printf("Copy per lexeme:     %8.1f ms  %7.1f M copies/s\n", copySeconds * 1e3, lookups / copySeconds / 1e6);
+    printf("Equality, strcmp:    %8.2f ns per compare (%zu equal)\n", strcmpSeconds * 1e9 / (spanCount - 8),
+           equalStrings);
+    printf("Equality, IDs:       %8.2f ns per compare (%zu equal)\n", idSeconds * 1e9 / (spanCount - 8), equalIds);
+    printf("Memory: copies %.1f MB, interned %.1f MB (table %.2f MB + 4-byte ID per token); %.1f%% saved\n",
+           copyBytes / 1048576.0, internBytes / 1048576.0, internMemory(&table) / 1048576.0,
+           100.0 * (1.0 - (double)internBytes / (double)copyBytes));
+    printf("IDs stable and names intact: %s\n", wrong || equalIds != equalStrings ? "NO" : "yes");
+
+    for (size_t i = 0; i < spanCount; i++) free(copies[i]);
+    free(copies);
+    free(ids);
+    free(spans);
+    internFree(&table);
+    free(text);
+    return wrong != 0;
+}
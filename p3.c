@@ -2,6 +2,7 @@
 #include <ctype.h>
 #include <string.h>
 #include <stdbool.h>
+#include "intern.h"
 
 #define MAX_TOKENS 100
 #define MAX_LENGTH 100
@@ -15,10 +16,12 @@ typedef enum { KEYWORD, IDENTIFIER, CONSTANT, OPERATOR, PUNCTUATION, INVALID } T
 typedef struct {
     char value[MAX_LENGTH];
     TokenType type;
+    uint32_t id;                // Interned name of an identifier, else INTERN_NO_ID
 } Token;
 
 Token tokens[MAX_TOKENS];
 int tokenCount = 0;
+InternTable identifiers;        // Zeroed, which is an empty table
 
 bool isKeyword(char *str) {
     for (int i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
@@ -43,63 +46,62 @@ bool isValidIdentifier(char *str) {
     return true;
 }
 
-void tokenize(char *str) {
+// Function to scan the token at *cursor, skipping whitespace before it.
+// Returns its type, with *start and *length spanning its text, and moves
+// *cursor past it; returns -1 at the end of the string. Callers that keep
+// no copy of each token (a streaming consumer) use this instead of tokenize.
+int scanToken(const char **cursor, const char **start, int *length) {
+    const char *str = *cursor;
     char buffer[MAX_LENGTH];
-    int index = 0;
-    
-    while (*str) {
-        if (isspace(*str)) {
-            str++;
-            continue;
-        }
-        
-        if (isalpha(*str) || *str == '_') {
-            index = 0;
-            while (isalnum(*str) || *str == '_') {
-                buffer[index++] = *str++;
-            }
-            buffer[index] = '\0';
-            
-            TokenType type = isKeyword(buffer) ? KEYWORD : IDENTIFIER;
-            strcpy(tokens[tokenCount].value, buffer);
-            tokens[tokenCount].type = type;
-            tokenCount++;
-        } 
-        else if (isdigit(*str)) {
-            index = 0;
-            while (isdigit(*str)) {
-                buffer[index++] = *str++;
-            }
-            buffer[index] = '\0';
-            
-            tokens[tokenCount].type = CONSTANT;
-            strcpy(tokens[tokenCount].value, buffer);
-            tokenCount++;
-        } 
-        else if (isOperator(*str)) {
-            buffer[0] = *str;
-            buffer[1] = '\0';
-            tokens[tokenCount].type = OPERATOR;
-            strcpy(tokens[tokenCount].value, buffer);
-            tokenCount++;
-            str++;
-        } 
-        else if (isPunctuation(*str)) {
-            buffer[0] = *str;
-            buffer[1] = '\0';
-            tokens[tokenCount].type = PUNCTUATION;
-            strcpy(tokens[tokenCount].value, buffer);
-            tokenCount++;
-            str++;
-        } 
-        else {
-            buffer[0] = *str;
-            buffer[1] = '\0';
-            tokens[tokenCount].type = INVALID;
-            strcpy(tokens[tokenCount].value, buffer);
-            tokenCount++;
-            str++;
-        }
+    TokenType type;
+
+    while (isspace(*str)) str++;
+    if (!*str) {
+        *cursor = str;
+        return -1;
+    }
+    *start = str;
+
+    if (isalpha(*str) || *str == '_') {
+        while (isalnum(*str) || *str == '_') str++;
+        int index = str - *start < MAX_LENGTH ? (int)(str - *start) : MAX_LENGTH - 1;
+        memcpy(buffer, *start, index);
+        buffer[index] = '\0';
+        type = isKeyword(buffer) ? KEYWORD : IDENTIFIER;
+    }
+    else if (isdigit(*str)) {
+        while (isdigit(*str)) str++;
+        type = CONSTANT;
+    }
+    else if (isOperator(*str)) {
+        str++;
+        type = OPERATOR;
+    }
+    else if (isPunctuation(*str)) {
+        str++;
+        type = PUNCTUATION;
+    }
+    else {
+        str++;
+        type = INVALID;
+    }
+
+    *length = (int)(str - *start);
+    *cursor = str;
+    return type;
+}
+
+void tokenize(char *str) {
+    const char *cursor = str, *start;
+    int length, type;
+
+    while ((type = scanToken(&cursor, &start, &length)) >= 0) {
+        if (length >= MAX_LENGTH) length = MAX_LENGTH - 1;
+        memcpy(tokens[tokenCount].value, start, length);
+        tokens[tokenCount].value[length] = '\0';
+        tokens[tokenCount].type = (TokenType)type;
+        tokens[tokenCount].id = type == IDENTIFIER ? internLookup(&identifiers, start, length) : INTERN_NO_ID;
+        tokenCount++;
     }
 }
 
@@ -107,7 +109,11 @@ void printTokens() {
     printf("\nTOKENS:\n");
     for (int i = 0; i < tokenCount; i++) {
         const char *typeStr[] = {"Keyword", "Identifier", "Constant", "Operator", "Punctuation", "Invalid"};
-        printf("%s: %s\n", typeStr[tokens[i].type], tokens[i].value);
+        if (tokens[i].id != INTERN_NO_ID) {
+            printf("%s: %s (id %u)\n", typeStr[tokens[i].type], tokens[i].value, tokens[i].id);
+        } else {
+            printf("%s: %s\n", typeStr[tokens[i].type], tokens[i].value);
+        }
     }
 }
 
@@ -117,6 +123,7 @@ int main() {
     printf("Input Code:\n%s\n", input);
     tokenize(input);
     printTokens();
+    internFree(&identifiers);
 
     return 0;
 }
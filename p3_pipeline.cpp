@@ -0,0 +1,449 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "Practical-8/grammar.h"
+#include "Practical-8/ll1.h"
+#include "Practical-8/bench_timer.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// Pipelined lexing and parsing: p3.c's scanner runs on one thread and pushes
+// compact tokens into a single-producer/single-consumer ring, while an LL(1)
+// parser over token classes consumes them on another, so on a large file
+// the two overlap instead of the parser waiting for the whole token array.
+// Build with:
+//   gcc -O2 -Dmain=p3_main -c p3.c -o p3.o
+//   g++ -std=c++17 -O2 -pthread p3_pipeline.cpp p3.o -o p3_pipeline
+// Usage: p3_pipeline [megabytes] [seed]
+
+extern "C" {
+int scanToken(const char** cursor, const char** start, int* length);    // p3.c
+void tokenize(char* str);
+struct Token {                  // p3.c's Token, for checking tokenize's output
+    char value[100];
+    int type;
+    uint32_t id;
+};
+extern Token tokens[];
+extern int tokenCount;
+}
+
+enum { KEYWORD, IDENTIFIER, CONSTANT, OPERATOR, PUNCTUATION, INVALID };
+
+// Structure to carry one token through the ring: 8 bytes, where p3.c's Token
+// copies 100 bytes of text
+struct PackedToken {
+    uint32_t offset;
+    uint16_t length;
+    uint8_t type;
+    char symbol;                // Terminal the parser sees
+};
+
+// Function to scan the next token of text into a PackedToken; false at the end
+inline bool nextToken(const char*& cursor, const char* text, PackedToken& token) {
+    const char* start;
+    int length;
+    int type = scanToken(&cursor, &start, &length);
+    if (type < 0) return false;
+    token.offset = (uint32_t)(start - text);
+    token.length = (uint16_t)min(length, 65535);
+    token.type = (uint8_t)type;
+    switch (type) {
+        case KEYWORD: token.symbol = 'k'; break;
+        case IDENTIFIER: token.symbol = 'i'; break;
+        case CONSTANT: token.symbol = 'n'; break;
+        case OPERATOR:
+        case PUNCTUATION: token.symbol = *start; break;
+        default: token.symbol = '?'; break;
+    }
+    return true;
+}
+
+// Function to wait a moment for the other side: spin briefly when it can be
+// running on another core, otherwise give it the core
+inline void waitForOtherSide(int spins) {
+    static const int spinLimit = thread::hardware_concurrency() > 1 ? 64 : 0;
+    if (spins < spinLimit) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        this_thread::yield();
+    }
+}
+
+// A bounded single-producer/single-consumer ring. Each side owns one index
+// and keeps a cached copy of the other's on its own cache line, so an index
+// crosses cores only when the cached copy says the ring is full or empty.
+// The producer publishes its index once per 'batch' tokens (and before it
+// waits), the consumer releases slots once per run it drains. A full ring
+// stops the producer until the consumer catches up (backpressure).
+template <typename T>
+class SpscRing {
+    // Shared indices, written by one side each
+    alignas(64) atomic<size_t> published{0};
+    alignas(64) atomic<size_t> released{0};
+    alignas(64) atomic<bool> closed{false};
+
+    // Producer side
+    alignas(64) size_t writeIndex = 0;
+    size_t lastPublished = 0;
+    size_t releasedSeen = 0;
+
+    // Consumer side
+    alignas(64) size_t readIndex = 0;
+    size_t publishedSeen = 0;
+
+    alignas(64) vector<T> slots;
+    size_t mask;
+    size_t batch;
+
+public:
+    // Structure to count how often each side crossed over or waited
+    struct Counters {
+        uint64_t fullWaits = 0;     // Producer found the ring full
+        uint64_t emptyWaits = 0;    // Consumer found it empty
+        uint64_t producerReloads = 0;
+        uint64_t consumerReloads = 0;
+        uint64_t publishes = 0;
+    };
+    alignas(64) Counters producerCounters;
+    alignas(64) Counters consumerCounters;
+
+    SpscRing(size_t capacity, size_t publishBatch) : batch(max<size_t>(publishBatch, 1)) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+        batch = min(batch, size);
+    }
+
+    void publish() {
+        if (writeIndex == lastPublished) return;
+        published.store(writeIndex, memory_order_release);
+        lastPublished = writeIndex;
+        producerCounters.publishes++;
+    }
+
+    void push(const T& value) {
+        if (writeIndex - releasedSeen == slots.size()) {
+            publish();
+            releasedSeen = released.load(memory_order_acquire);
+            producerCounters.producerReloads++;
+            for (int spins = 0; writeIndex - releasedSeen == slots.size(); spins++) {
+                producerCounters.fullWaits++;
+                waitForOtherSide(spins);
+                releasedSeen = released.load(memory_order_acquire);
+            }
+        }
+        slots[writeIndex & mask] = value;
+        writeIndex++;
+        if (writeIndex - lastPublished >= batch) publish();
+    }
+
+    void close() {
+        publish();
+        closed.store(true, memory_order_release);
+    }
+
+    // Function to hand every published token to f, waiting while the ring
+    // is empty; returns false once the producer has closed it and it is drained
+    template <typename F>
+    bool consume(F f) {
+        if (readIndex == publishedSeen) {
+            publishedSeen = published.load(memory_order_acquire);
+            consumerCounters.consumerReloads++;
+            for (int spins = 0; readIndex == publishedSeen; spins++) {
+                if (closed.load(memory_order_acquire)) {
+                    publishedSeen = published.load(memory_order_acquire);
+                    if (readIndex == publishedSeen) return false;
+                    break;
+                }
+                consumerCounters.emptyWaits++;
+                waitForOtherSide(spins);
+                publishedSeen = published.load(memory_order_acquire);
+            }
+        }
+        for (; readIndex != publishedSeen; readIndex++) f(slots[readIndex & mask]);
+        released.store(readIndex, memory_order_release);
+        return true;
+    }
+};
+
+// A push-driven LL(1) parser over token classes for declarations like the
+// ones p3.c tokenizes: k i = E ; with E a chain of operands (constants,
+// identifiers, parenthesised expressions) joined by operators. An error
+// skips to the next ';' and starts a new declaration (panic mode).
+class TokenParser {
+    vector<int> cells;              // 256 x 256: (non-terminal, symbol) to production, or -1
+    vector<string> productions;     // Reversed, ready to push
+    vector<char> stack;
+    bool recovering = false;
+
+    void reset() { stack.assign({'$', 'P'}); }
+
+public:
+    size_t tokens = 0, declarations = 0, errors = 0;
+
+    TokenParser() : cells(256 * 256, -1) {
+        vector<Production> grammar = {
+            {'P', {"DP", "ε"}},
+            {'D', {"kiI;"}},
+            {'I', {"=E", "ε"}},
+            {'E', {"TX"}},
+            {'X', {"+TX", "-TX", "*TX", "/TX", "<TX", ">TX", "=TX", "!TX", "ε"}},
+            {'T', {"n", "i", "(E)"}},
+        };
+        for (const auto& [nonTerminal, row] : buildParsingTable(grammar)) {
+            for (const auto& [lookahead, entry] : row) {
+                if (entry.production.empty()) continue;
+                string reversed = entry.production == "ε" ? "" : string(entry.production.rbegin(), entry.production.rend());
+                cells[(unsigned char)nonTerminal * 256 + (unsigned char)lookahead] = (int)productions.size();
+                productions.push_back(reversed);
+            }
+        }
+        reset();
+    }
+
+    void feed(char symbol) {
+        tokens++;
+        if (recovering) {
+            if (symbol == ';') {
+                recovering = false;
+                reset();
+            }
+            return;
+        }
+        while (true) {
+            char top = stack.back();
+            if (isNonTerminal(top)) {
+                int production = cells[(unsigned char)top * 256 + (unsigned char)symbol];
+                if (production < 0) break;
+                stack.pop_back();
+                stack.insert(stack.end(), productions[production].begin(), productions[production].end());
+                continue;
+            }
+            if (top != symbol) break;
+            stack.pop_back();
+            declarations += symbol == ';';
+            return;
+        }
+        errors++;
+        if (symbol == ';') {
+            reset();
+        } else {
+            recovering = true;
+        }
+    }
+
+    // Function to feed the end of input; true when nothing was wrong
+    bool finish() {
+        tokens--;
+        if (recovering) {
+            reset();
+            recovering = false;
+        }
+        feed('$');
+        return errors == 0;
+    }
+};
+
+// Function to build declarations like bench_suite's cStatement, with the
+// odd broken one (a stray token, as in p3.c's "7H")
+string generateSource(size_t bytes, uint64_t seed) {
+    mt19937_64 rng(seed);
+    const char* types[] = {"int", "char", "long", "void", "struct"};
+    const char* names[] = {"count", "buffer", "i", "j", "total", "node", "next", "value", "length", "result"};
+    const char* ops = "+-*/<>=";
+    string text;
+    text.reserve(bytes + 128);
+    while (text.size() < bytes) {
+        size_t lineStart = text.size();
+        text += string(types[rng() % 5]) + " " + names[rng() % 10] + " = ";
+        while (text.size() - lineStart < 60 + rng() % 30) {
+            unsigned r = rng() % 4;
+            if (r == 0) text += to_string(rng() % 1000);
+            else if (r == 1) text += string("(") + names[rng() % 10] + ")";
+            else text += names[rng() % 10];
+            text += ' ';
+            text += ops[rng() % 7];
+            text += ' ';
+        }
+        text += rng() % 50 ? "0;\n" : "0, 7H;\n";
+    }
+    return text;
+}
+
+// Structure to hold one run's results, which every mode must agree on
+struct RunResult {
+    double ms = 0;
+    size_t tokens = 0, declarations = 0, errors = 0;
+    uint64_t fullWaits = 0, emptyWaits = 0, crossings = 0;  // Ring counters of a pipelined run
+
+    bool operator==(const RunResult& other) const {
+        return tokens == other.tokens && declarations == other.declarations && errors == other.errors;
+    }
+};
+
+RunResult fromParser(const TokenParser& parser, double ms) {
+    RunResult result;
+    result.ms = ms;
+    result.tokens = parser.tokens;
+    result.declarations = parser.declarations;
+    result.errors = parser.errors;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 64;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 49;
+    // PackedToken::offset is 32 bits, so the text must stay under 4 GB
+    if (megabytes == 0 || megabytes > 4095) {
+        cerr << "Usage: " << argv[0] << " [megabytes] [seed], with megabytes from 1 to 4095" << endl;
+        return 1;
+    }
+    string text = generateSource(megabytes << 20, seed);
+    const char* base = text.c_str();
+
+    // scanToken must split lines exactly as tokenize does: the same tokens,
+    // with the same types and text (tokenize keeps at most 99 characters)
+    size_t lines = 0, firstMismatch = 0;
+    vector<PackedToken> lineTokens;
+    for (size_t start = 0; start < text.size() && lines < 10000 && !firstMismatch; lines++) {
+        size_t end = text.find('\n', start);
+        string line = text.substr(start, end - start);
+        const char* cursor = line.c_str();
+        PackedToken token;
+        lineTokens.clear();
+        while (nextToken(cursor, line.c_str(), token)) lineTokens.push_back(token);
+        tokenCount = 0;
+        tokenize(&line[0]);
+        bool same = (size_t)tokenCount == lineTokens.size();
+        for (size_t k = 0; same && k < lineTokens.size(); k++) {
+            const PackedToken& packed = lineTokens[k];
+            size_t length = min<size_t>(packed.length, sizeof(tokens[k].value) - 1);
+            same = tokens[k].type == packed.type && strlen(tokens[k].value) == length &&
+                   text.compare(start + packed.offset, length, tokens[k].value) == 0;
+        }
+        if (!same) firstMismatch = lines + 1;
+        start = end + 1;
+    }
+    // The lexer alone, into an array of every token
+    vector<PackedToken> tokens;
+    RunResult lexOnly = fastestOfThree([&]() {
+        auto start = steady_clock::now();
+        tokens.clear();
+        const char* cursor = base;
+        PackedToken token;
+        while (nextToken(cursor, base, token)) tokens.push_back(token);
+        RunResult result;
+        result.ms = duration<double, milli>(steady_clock::now() - start).count();
+        result.tokens = tokens.size();
+        return result;
+    });
+
+    // The parser alone, over that array
+    RunResult parseOnly = fastestOfThree([&]() {
+        auto start = steady_clock::now();
+        TokenParser parser;
+        for (const PackedToken& token : tokens) parser.feed(token.symbol);
+        parser.finish();
+        return fromParser(parser, duration<double, milli>(steady_clock::now() - start).count());
+    });
+
+    // Sequential: every token first, then the parse, as p3.c works today
+    RunResult sequential = fastestOfThree([&]() {
+        auto start = steady_clock::now();
+        vector<PackedToken> all;
+        const char* cursor = base;
+        PackedToken token;
+        while (nextToken(cursor, base, token)) all.push_back(token);
+        TokenParser parser;
+        for (const PackedToken& token : all) parser.feed(token.symbol);
+        parser.finish();
+        return fromParser(parser, duration<double, milli>(steady_clock::now() - start).count());
+    });
+
+    // Fused on one thread: the parser takes each token as it is scanned
+    RunResult fused = fastestOfThree([&]() {
+        auto start = steady_clock::now();
+        TokenParser parser;
+        const char* cursor = base;
+        PackedToken token;
+        while (nextToken(cursor, base, token)) parser.feed(token.symbol);
+        parser.finish();
+        return fromParser(parser, duration<double, milli>(steady_clock::now() - start).count());
+    });
+
+    cout << text.size() << " bytes, " << tokens.size() << " tokens; scanToken and tokenize agree on " << lines
+         << " lines: ";
+    if (firstMismatch) {
+        cout << "NO, first difference on line " << firstMismatch << endl;
+    } else {
+        cout << "yes" << endl;
+    }
+    cout << thread::hardware_concurrency() << " hardware threads; " << sequential.declarations << " declarations, " << sequential.errors << " errors" << endl;
+    double mb = text.size() / 1048576.0;
+    auto row = [&](const string& name, const RunResult& result, const string& note) {
+        cout << left << setw(26) << name << right << fixed << setprecision(1) << setw(10) << result.ms << setw(10)
+             << mb / result.ms * 1000 << setw(10) << setprecision(2) << sequential.ms / result.ms << "x"
+             << defaultfloat << "  " << (result.tokens == sequential.tokens ? "" : "MISMATCH ") << note << endl;
+    };
+    cout << "\n" << left << setw(26) << "Mode" << right << setw(10) << "ms" << setw(10) << "MB/s" << setw(11)
+         << "vs seq" << "  Notes" << endl;
+    cout << string(92, '-') << endl;
+    row("lex only", lexOnly, "");
+    row("parse only", parseOnly, "");
+    row("sequential", sequential, "");
+    row("fused, one thread", fused, fused == sequential ? "" : "MISMATCH");
+
+    // Pipelined, over ring sizes and publish batches; the queue's cost is
+    // what the pipeline takes beyond its slower stage
+    double slowerStage = max(lexOnly.ms, parseOnly.ms);
+    cout << "\nPipeline (lexer thread -> ring -> parser thread); slower stage alone " << fixed << setprecision(1)
+         << slowerStage << " ms" << defaultfloat << endl;
+    cout << left << setw(26) << "Capacity / batch" << right << setw(10) << "ms" << setw(10) << "MB/s" << setw(11)
+         << "vs seq" << "  Full waits, empty waits, index reloads per 1k tokens, queue ns/token" << endl;
+    cout << string(92, '-') << endl;
+    for (auto [capacity, batch] : vector<pair<size_t, size_t>>{{64, 1}, {1024, 1}, {1024, 64}, {16384, 256}, {65536, 1024}}) {
+        RunResult piped = fastestOfThree([&]() {
+            SpscRing<PackedToken> ring(capacity, batch);
+            TokenParser parser;
+            auto start = steady_clock::now();
+            thread lexer([&]() {
+                const char* cursor = base;
+                PackedToken token;
+                while (nextToken(cursor, base, token)) ring.push(token);
+                ring.close();
+            });
+            while (ring.consume([&](const PackedToken& token) { parser.feed(token.symbol); })) {
+            }
+            parser.finish();
+            lexer.join();
+            RunResult result = fromParser(parser, duration<double, milli>(steady_clock::now() - start).count());
+            const auto& producer = ring.producerCounters;
+            const auto& consumer = ring.consumerCounters;
+            result.fullWaits = producer.fullWaits;
+            result.emptyWaits = consumer.emptyWaits;
+            result.crossings = producer.producerReloads + consumer.consumerReloads + producer.publishes;
+            return result;
+        });
+        double perThousand = 1000.0 / max<size_t>(piped.tokens, 1);
+        char note[160];
+        snprintf(note, sizeof(note), "%9llu %11llu %8.2f %8.2f%s", (unsigned long long)piped.fullWaits,
+                 (unsigned long long)piped.emptyWaits, piped.crossings * perThousand,
+                 (piped.ms - slowerStage) * 1e6 / max<size_t>(piped.tokens, 1), piped == sequential ? "" : "  MISMATCH");
+        row(to_string(capacity) + " / " + to_string(batch), piped, note);
+    }
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Streaming version of p4.1.l: extracts every digit run from a file of any
+// size. Build with: gcc -O2 p4.1_batch.c -o p4.1_batch
+
+#define CHUNK_SIZE (1 << 20)
+#define BLOCK_SIZE 64
+#define OUTPUT_BUFFER_SIZE (1 << 16)
+
+typedef enum { OUTPUT_TEXT, OUTPUT_BINARY, OUTPUT_COUNT } OutputMode;
+
+// Structure to hold the state of the extractor between chunks
+typedef struct {
+    OutputMode mode;
+    bool inRun;          // A digit run continues into the next block
+    uint64_t value;      // Parsed value of the current run (binary mode)
+    bool overflow;       // The current run does not fit in uint64_t
+    unsigned char buffer[OUTPUT_BUFFER_SIZE];
+    size_t used;
+    size_t numbers;
+    size_t overflows;
+} Extractor;
+
+// Function to flush buffered output to stdout
+void flushOutput(Extractor *ex) {
+    if (ex->used > 0) {
+        fwrite(ex->buffer, 1, ex->used, stdout);
+        ex->used = 0;
+    }
+}
+
+// Function to append bytes to the output buffer
+void writeBytes(Extractor *ex, const void *data, size_t length) {
+    if (ex->used + length > OUTPUT_BUFFER_SIZE) {
+        flushOutput(ex);
+        if (length > OUTPUT_BUFFER_SIZE) {
+            fwrite(data, 1, length, stdout);
+            return;
+        }
+    }
+    memcpy(ex->buffer + ex->used, data, length);
+    ex->used += length;
+}
+
+// Function to convert 8 ASCII digits to their value with SWAR arithmetic
+static inline uint32_t parseEightDigits(const unsigned char *digits) {
+    uint64_t chunk;
+    memcpy(&chunk, digits, sizeof(chunk));
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);  // Pairs of digits
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return (uint32_t)chunk;
+}
+
+// Function to fold more digits of the current run into its value
+void accumulateDigits(Extractor *ex, const unsigned char *digits, size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t scaled;
+        if (__builtin_mul_overflow(ex->value, 100000000ULL, &scaled) ||
+            __builtin_add_overflow(scaled, parseEightDigits(digits + i), &ex->value)) {
+            ex->overflow = true;
+        }
+    }
+    for (; i < length; i++) {
+        uint64_t scaled;
+        if (__builtin_mul_overflow(ex->value, 10ULL, &scaled) ||
+            __builtin_add_overflow(scaled, (uint64_t)(digits[i] - '0'), &ex->value)) {
+            ex->overflow = true;
+        }
+    }
+}
+
+// Function to handle the digits of a run found in the current block
+void extendRun(Extractor *ex, const unsigned char *digits, size_t length) {
+    if (ex->mode == OUTPUT_TEXT) {
+        writeBytes(ex, digits, length);
+    } else if (ex->mode == OUTPUT_BINARY) {
+        accumulateDigits(ex, digits, length);
+    }
+}
+
+// Function to emit the run that has just ended
+void finishRun(Extractor *ex) {
+    ex->numbers++;
+    if (ex->mode == OUTPUT_TEXT) {
+        writeBytes(ex, "\n", 1);
+    } else if (ex->mode == OUTPUT_BINARY) {
+        // Values beyond uint64_t saturate; the count is reported at the end
+        if (ex->overflow) {
+            ex->value = UINT64_MAX;
+            ex->overflows++;
+        }
+        writeBytes(ex, &ex->value, sizeof(ex->value));
+    }
+    ex->inRun = false;
+    ex->value = 0;
+    ex->overflow = false;
+}
+
+// Function to build a bitmask of the digit bytes in a 64-byte block
+static inline uint64_t digitMask(const unsigned char *block) {
+#ifdef __SSE2__
+    const __m128i zeroChar = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    uint64_t mask = 0;
+    for (int i = 0; i < BLOCK_SIZE; i += 16) {
+        __m128i offset = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)(block + i)), zeroChar);
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(offset, nine), offset);
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(isDigit) << i;
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        mask |= (uint64_t)((unsigned)(block[i] - '0') <= 9) << i;
+    }
+    return mask;
+#endif
+}
+
+// Function to extract the digit runs of one block of at most 64 bytes
+void extractBlock(Extractor *ex, const unsigned char *block, int length) {
+    uint64_t mask = digitMask(block);
+    if (length < BLOCK_SIZE) mask &= (1ULL << length) - 1;
+
+    // Finish a run carried over from the previous block
+    if (ex->inRun) {
+        int k = (~mask == 0) ? BLOCK_SIZE : __builtin_ctzll(~mask);
+        if (k >= length) {
+            extendRun(ex, block, (size_t)length);
+            return;
+        }
+        extendRun(ex, block, (size_t)k);
+        finishRun(ex);
+        mask &= ~((1ULL << k) - 1);
+    }
+
+    while (mask) {
+        int start = __builtin_ctzll(mask);
+        uint64_t rest = ~(mask >> start);
+        int runLength = (rest == 0) ? BLOCK_SIZE : __builtin_ctzll(rest);
+        int end = start + runLength;
+
+        if (end >= length) {
+            // The run reaches the end of the block and may continue
+            ex->inRun = true;
+            extendRun(ex, block + start, (size_t)(length - start));
+            return;
+        }
+        extendRun(ex, block + start, (size_t)runLength);
+        finishRun(ex);
+        mask &= ~((1ULL << end) - 1);
+    }
+}
+
+// Function to extract digit runs from a buffer, continuing any open run
+void extractBuffer(Extractor *ex, const unsigned char *data, size_t size) {
+    size_t i = 0;
+    for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+        extractBlock(ex, data + i, BLOCK_SIZE);
+    }
+    if (i < size) {
+        unsigned char tail[BLOCK_SIZE] = {0};
+        memcpy(tail, data + i, size - i);
+        extractBlock(ex, tail, (int)(size - i));
+    }
+}
+
+// Function to stream a file through the extractor in fixed-size chunks
+bool extractFile(Extractor *ex, int fd, size_t *bytesRead) {
+    unsigned char *chunk = malloc(CHUNK_SIZE);
+    if (!chunk) return false;
+
+    *bytesRead = 0;
+    ssize_t n;
+    while ((n = read(fd, chunk, CHUNK_SIZE)) > 0) {
+        extractBuffer(ex, chunk, (size_t)n);
+        *bytesRead += (size_t)n;
+    }
+    if (ex->inRun) finishRun(ex);
+    flushOutput(ex);
+
+    free(chunk);
+    return n == 0;
+}
+
+// Function to write seeded synthetic input: words, spaces and numbers of varying length
+void generateInput(size_t size, unsigned seed) {
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz ,.;\n";
+    unsigned char *line = malloc(CHUNK_SIZE);
+    uint64_t state = seed * 2654435761ULL + 1;
+
+    size_t written = 0;
+    while (written < size) {
+        size_t n = 0;
+        while (n < CHUNK_SIZE - 32) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            unsigned r = (unsigned)(state >> 33);
+            if (r % 3 == 0) {
+                int digits = 1 + (int)((r >> 4) % 20);
+                for (int d = 0; d < digits; d++) {
+                    line[n++] = (unsigned char)('0' + (r >> (d % 8)) % 10);
+                    r = r * 1103515245u + 12345u;
+                }
+            } else {
+                int chars = 1 + (int)((r >> 4) % 12);
+                for (int c = 0; c < chars; c++) {
+                    line[n++] = (unsigned char)letters[(r >> 8) % (sizeof(letters) - 1)];
+                    r = r * 1103515245u + 12345u;
+                }
+            }
+        }
+        if (n > size - written) n = size - written;
+        fwrite(line, 1, n, stdout);
+        written += n;
+    }
+    free(line);
+}
+
+void printUsage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [-b | -c] [file]\n"
+            "       %s -g bytes [-s seed]\n"
+            "  -b   write each number as a little-endian uint64_t instead of text\n"
+            "  -c   only print the summary\n"
+            "  -g   write synthetic benchmark input of the given size\n",
+            program, program);
+}
+
+int main(int argc, char **argv) {
+    static Extractor ex;
+    ex.mode = OUTPUT_TEXT;
+    size_t generateSize = 0;
+    unsigned seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "bcg:s:")) != -1) {
+        switch (opt) {
+            case 'b': ex.mode = OUTPUT_BINARY; break;
+            case 'c': ex.mode = OUTPUT_COUNT; break;
+            case 'g': generateSize = strtoull(optarg, NULL, 10); break;
+            case 's': seed = (unsigned)atoi(optarg); break;
+            default: printUsage(argv[0]); return 1;
+        }
+    }
+
+    if (generateSize > 0) {
+        generateInput(generateSize, seed);
+        return 0;
+    }
+
+    int fd = 0;
+    if (optind < argc) {
+        fd = open(argv[optind], O_RDONLY);
+        if (fd < 0) {
+            perror("Error opening file");
+            return 1;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    struct timespec start, finish;
+    size_t bytesRead;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool ok = extractFile(&ex, fd, &bytesRead);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    if (!ok) perror("Error reading input");
+
+    double seconds = (double)(finish.tv_sec - start.tv_sec) + (double)(finish.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "Bytes: %zu, numbers: %zu, overflows: %zu (%.3f s, %.2f GB/s)\n",
+            bytesRead, ex.numbers, ex.overflows, seconds,
+            seconds > 0 ? (double)bytesRead / seconds / 1e9 : 0.0);
+
+    if (fd != 0) close(fd);
+    return ok ? 0 : 1;
+}
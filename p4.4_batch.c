@@ -0,0 +1,320 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+// Batch version of p4.4.l: validates one candidate password per line of an
+// mmap'd file. Build with: gcc -O2 -mssse3 p4.4_batch.c -o p4.4_batch
+
+#define CLASS_UPPER  1
+#define CLASS_LOWER  2
+#define CLASS_DIGIT  4
+#define CLASS_SYMBOL 8
+#define NUM_CLASSES  4
+
+#define MAX_SIMD_LENGTH 16
+#define MAX_LENGTH 255
+#define OUTPUT_BUFFER_SIZE (1 << 16)
+
+typedef enum { OUTPUT_VERDICT, OUTPUT_BITMAP, OUTPUT_COUNT } OutputMode;
+
+// Structure to represent a password policy
+typedef struct {
+    int minLength;
+    int maxLength;
+    unsigned requiredClasses;
+    const char *symbols;
+} Policy;
+
+// Lookup tables compiled from a policy. A byte c belongs to class k when
+// lowTable[k][c & 0xF] has bit (c >> 4) set; highTable turns the high nibble
+// into that bit (non-ASCII bytes map to 0 and so belong to no class).
+typedef struct {
+    uint8_t lowTable[NUM_CLASSES][16];
+    uint8_t highTable[16];
+    uint8_t classOf[256];
+    int minLength;
+    int maxLength;
+    uint8_t required;
+} PolicyTables;
+
+// Structure to collect the output of a run
+typedef struct {
+    OutputMode mode;
+    unsigned char buffer[OUTPUT_BUFFER_SIZE];
+    size_t used;
+    unsigned char bits;
+    int bitCount;
+    size_t lines;
+    size_t valid;
+} Output;
+
+// Function to add a byte to a class in the lookup tables
+void addToClass(PolicyTables *tables, int classIndex, unsigned char c) {
+    if (c >= 0x80) return;
+    tables->lowTable[classIndex][c & 0x0F] |= (uint8_t)(1u << (c >> 4));
+    tables->classOf[c] |= (uint8_t)(1u << classIndex);
+}
+
+// Function to compile a policy into lookup tables
+bool compilePolicy(const Policy *policy, PolicyTables *tables) {
+    if (policy->minLength < 1 || policy->maxLength > MAX_LENGTH ||
+        policy->minLength > policy->maxLength) {
+        return false;
+    }
+
+    memset(tables, 0, sizeof(*tables));
+    for (int h = 0; h < 8; h++) {
+        tables->highTable[h] = (uint8_t)(1u << h);
+    }
+
+    for (unsigned char c = 'A'; c <= 'Z'; c++) addToClass(tables, 0, c);
+    for (unsigned char c = 'a'; c <= 'z'; c++) addToClass(tables, 1, c);
+    for (unsigned char c = '0'; c <= '9'; c++) addToClass(tables, 2, c);
+    for (const char *s = policy->symbols; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        // Letters and digits keep their own class
+        if (tables->classOf[c] == 0) addToClass(tables, 3, c);
+    }
+
+    tables->minLength = policy->minLength;
+    tables->maxLength = policy->maxLength;
+    tables->required = (uint8_t)policy->requiredClasses;
+    return true;
+}
+
+// Function to check a line one byte at a time
+bool checkScalar(const PolicyTables *tables, const unsigned char *line, int length) {
+    uint8_t present = 0;
+    for (int i = 0; i < length; i++) {
+        uint8_t cls = tables->classOf[line[i]];
+        if (cls == 0) return false;  // Character outside the allowed set
+        present |= cls;
+    }
+    return (present & tables->required) == tables->required;
+}
+
+#ifdef __SSSE3__
+static const uint8_t lengthMaskBytes[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// Function to check a line of at most 16 bytes with one 128-bit classification
+bool checkSimd(const PolicyTables *tables, const unsigned char *line, int length) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_loadu_si128((const __m128i *)line);
+    __m128i lengthMask = _mm_loadu_si128((const __m128i *)(lengthMaskBytes + 16 - length));
+
+    __m128i low = _mm_and_si128(bytes, nibble);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+    __m128i highBits = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)tables->highTable), high);
+
+    // Turn each class membership into its class bit and merge them per byte
+    __m128i cls = zero;
+    for (int k = 0; k < NUM_CLASSES; k++) {
+        __m128i rows = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)tables->lowTable[k]), low);
+        __m128i outside = _mm_cmpeq_epi8(_mm_and_si128(rows, highBits), zero);
+        cls = _mm_or_si128(cls, _mm_andnot_si128(outside, _mm_set1_epi8((char)(1 << k))));
+    }
+    cls = _mm_and_si128(cls, lengthMask);
+
+    // Every byte inside the line must belong to some class
+    unsigned unclassified = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(cls, zero));
+    if (unclassified & ((1u << length) - 1)) return false;
+
+    // OR-reduce the class bits across the line to test all required classes at once
+    __m128i present = _mm_or_si128(cls, _mm_srli_si128(cls, 8));
+    present = _mm_or_si128(present, _mm_srli_si128(present, 4));
+    present = _mm_or_si128(present, _mm_srli_si128(present, 2));
+    present = _mm_or_si128(present, _mm_srli_si128(present, 1));
+    uint8_t classes = (uint8_t)_mm_cvtsi128_si32(present);
+    return (classes & tables->required) == tables->required;
+}
+#endif
+
+// Function to validate a single line against the compiled policy
+bool validateLine(const PolicyTables *tables, const unsigned char *line, int length,
+                  const unsigned char *end) {
+    if (length < tables->minLength || length > tables->maxLength) return false;
+
+#ifdef __SSSE3__
+    if (length <= MAX_SIMD_LENGTH) {
+        // Near the end of the mapping copy the line so the 16-byte load stays in bounds
+        if (end - line >= 16) return checkSimd(tables, line, length);
+        unsigned char padded[16] = {0};
+        memcpy(padded, line, (size_t)length);
+        return checkSimd(tables, padded, length);
+    }
+#else
+    (void)end;
+#endif
+    return checkScalar(tables, line, length);
+}
+
+// Function to flush buffered output to stdout
+void flushOutput(Output *out) {
+    if (out->used > 0) {
+        fwrite(out->buffer, 1, out->used, stdout);
+        out->used = 0;
+    }
+}
+
+// Function to record the verdict for one line
+void emitVerdict(Output *out, bool isValid) {
+    out->lines++;
+    if (isValid) out->valid++;
+
+    if (out->mode == OUTPUT_VERDICT) {
+        if (out->used + 2 > OUTPUT_BUFFER_SIZE) flushOutput(out);
+        out->buffer[out->used++] = isValid ? '1' : '0';
+        out->buffer[out->used++] = '\n';
+    } else if (out->mode == OUTPUT_BITMAP) {
+        // Line i is bit (i % 8) of byte (i / 8), least significant bit first
+        out->bits |= (unsigned char)(isValid << out->bitCount);
+        if (++out->bitCount == 8) {
+            if (out->used == OUTPUT_BUFFER_SIZE) flushOutput(out);
+            out->buffer[out->used++] = out->bits;
+            out->bits = 0;
+            out->bitCount = 0;
+        }
+    }
+}
+
+// Function to validate every line of a buffer
+void validateBuffer(const PolicyTables *tables, const unsigned char *data, size_t size, Output *out) {
+    const unsigned char *p = data;
+    const unsigned char *end = data + size;
+
+    while (p < end) {
+        const unsigned char *newline = memchr(p, '\n', (size_t)(end - p));
+        const unsigned char *lineEnd = newline ? newline : end;
+        size_t length = (size_t)(lineEnd - p);
+
+        // Accept CRLF dumps: the carriage return is not part of the password
+        if (length > 0 && p[length - 1] == '\r') length--;
+
+        bool isValid = length <= MAX_LENGTH && validateLine(tables, p, (int)length, end);
+        emitVerdict(out, isValid);
+
+        p = newline ? newline + 1 : end;
+    }
+
+    if (out->mode == OUTPUT_BITMAP && out->bitCount > 0) {
+        if (out->used == OUTPUT_BUFFER_SIZE) flushOutput(out);
+        out->buffer[out->used++] = out->bits;
+        out->bits = 0;
+        out->bitCount = 0;
+    }
+    flushOutput(out);
+}
+
+// Function to parse the required classes from letters u, l, d and s
+bool parseClasses(const char *str, unsigned *classes) {
+    *classes = 0;
+    for (; *str; str++) {
+        switch (*str) {
+            case 'u': *classes |= CLASS_UPPER; break;
+            case 'l': *classes |= CLASS_LOWER; break;
+            case 'd': *classes |= CLASS_DIGIT; break;
+            case 's': *classes |= CLASS_SYMBOL; break;
+            default: return false;
+        }
+    }
+    return true;
+}
+
+void printUsage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [-m min] [-M max] [-r classes] [-s symbols] [-b | -c] file\n"
+            "  -m, -M   length bounds (default 9 and 15)\n"
+            "  -r       required classes from u, l, d, s (default ulds)\n"
+            "  -s       allowed symbols (default \"*;#$@\")\n"
+            "  -b       write a bitmap, one bit per line, instead of a verdict per line\n"
+            "  -c       only print the summary\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    Policy policy = {9, 15, CLASS_UPPER | CLASS_LOWER | CLASS_DIGIT | CLASS_SYMBOL, "*;#$@"};
+    static Output out;
+    out.mode = OUTPUT_VERDICT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:M:r:s:bc")) != -1) {
+        switch (opt) {
+            case 'm': policy.minLength = atoi(optarg); break;
+            case 'M': policy.maxLength = atoi(optarg); break;
+            case 'r':
+                if (!parseClasses(optarg, &policy.requiredClasses)) {
+                    fprintf(stderr, "Invalid class list: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 's': policy.symbols = optarg; break;
+            case 'b': out.mode = OUTPUT_BITMAP; break;
+            case 'c': out.mode = OUTPUT_COUNT; break;
+            default: printUsage(argv[0]); return 1;
+        }
+    }
+    if (optind != argc - 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    PolicyTables tables;
+    if (!compilePolicy(&policy, &tables)) {
+        fprintf(stderr, "Invalid length bounds: %d..%d (limit %d)\n",
+                policy.minLength, policy.maxLength, MAX_LENGTH);
+        return 1;
+    }
+
+    int fd = open(argv[optind], O_RDONLY);
+    if (fd < 0) {
+        perror("Error opening file");
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror("Error reading file size");
+        close(fd);
+        return 1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const unsigned char *data = NULL;
+    if (size > 0) {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            perror("Error mapping file");
+            close(fd);
+            return 1;
+        }
+        madvise((void *)data, size, MADV_SEQUENTIAL);
+    }
+
+    struct timespec start, finish;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    validateBuffer(&tables, data, size, &out);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    double seconds = (double)(finish.tv_sec - start.tv_sec) + (double)(finish.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "Lines: %zu, valid: %zu, invalid: %zu (%.3f s, %.1f Mlines/s)\n",
+            out.lines, out.valid, out.lines - out.valid, seconds,
+            seconds > 0 ? (double)out.lines / seconds / 1e6 : 0.0);
+
+    if (data) munmap((void *)data, size);
+    close(fd);
+    return 0;
+}